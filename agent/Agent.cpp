@@ -0,0 +1,184 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "backend/AgentProtocol.hpp"
+#include "backend/FaultGuard.hpp"
+#include "backend/SharedMemory.hpp"
+
+#include "Agent.h"
+
+namespace {
+// How long to keep polling after the last request before parking on the doorbell. Long enough to cover the gaps
+// between a client's batches, short enough not to burn a core while nobody is looking.
+constexpr auto SPIN_TIME = std::chrono::microseconds{200};
+
+std::mutex g_mtx{};
+std::unique_ptr<SharedMemory> g_region{};
+std::thread g_thread{};
+std::atomic<bool> g_stop{};
+
+uint32_t current_process_id() {
+#ifdef _WIN32
+    return (uint32_t)GetCurrentProcessId();
+#else
+    return (uint32_t)getpid();
+#endif
+}
+
+void serve(const agent::Slot& slot, agent::Slot& out, std::byte* arena) {
+    auto data = arena + slot.arena_offset;
+    auto ok = false;
+
+    // The client owns the slot contents, don't trust them to stay inside the arena.
+    if (slot.arena_offset <= agent::ARENA_SIZE && slot.size <= agent::ARENA_SIZE - slot.arena_offset) {
+        switch (slot.op) {
+        case agent::Op::READ:
+            ok = fault_guard::copy(data, (const void*)slot.address, slot.size);
+            break;
+        case agent::Op::WRITE:
+            ok = fault_guard::copy((void*)slot.address, data, slot.size);
+            break;
+        }
+    }
+
+    out.status = ok ? agent::Status::OK : agent::Status::FAULT;
+}
+
+void run(std::byte* region) {
+    auto header = (agent::Header*)region;
+    auto slots = agent::slots(region);
+    auto arena = agent::arena(region);
+    auto completed = header->completed.load();
+
+    while (!g_stop) {
+        auto submitted = header->submitted.load(std::memory_order_acquire);
+
+        if (submitted != completed) {
+            // Copy the slot out first, it lives in memory the client can scribble on.
+            for (; completed != submitted; ++completed) {
+                auto&& slot = slots[completed % agent::SLOTS];
+                auto request = slot;
+
+                serve(request, slot, arena);
+                // Publishes the status and read data.
+                header->completed.store(completed + 1, std::memory_order_release);
+            }
+
+            continue;
+        }
+
+        // Idle. Poll for a little while, then sleep until the client rings.
+        auto spin_end = std::chrono::steady_clock::now() + SPIN_TIME;
+
+        while (header->submitted.load(std::memory_order_acquire) == completed && !g_stop &&
+               std::chrono::steady_clock::now() < spin_end) {
+            std::this_thread::yield();
+        }
+
+        if (header->submitted.load(std::memory_order_acquire) != completed || g_stop) {
+            continue;
+        }
+
+        auto doorbell = header->doorbell.load();
+        header->sleeping.store(1);
+
+        // Pairs with the fence on the client side: either we see the new requests here or the client sees sleeping.
+        if (header->submitted.load() == completed && !g_stop) {
+            SharedMemory::wait(header->doorbell, doorbell, std::chrono::milliseconds{100});
+        }
+
+        header->sleeping.store(0);
+    }
+}
+} // namespace
+
+REGENNY_AGENT_API int regenny_agent_start() {
+    std::scoped_lock _{g_mtx};
+
+    if (g_region != nullptr) {
+        return 0;
+    }
+
+    auto pid = current_process_id();
+    auto region = std::make_unique<SharedMemory>(agent::shm_name(pid), SharedMemory::Mode::CREATE, agent::region_size());
+
+    if (!region->ok()) {
+        return -1;
+    }
+
+    auto header = new (region->data()) agent::Header{};
+
+    header->magic = agent::MAGIC;
+    header->version = agent::VERSION;
+    header->pid = pid;
+    header->slots = agent::SLOTS;
+    header->arena_size = agent::ARENA_SIZE;
+
+    g_stop = false;
+    g_region = std::move(region);
+    g_thread = std::thread{run, g_region->data()};
+
+    // Clients check this last, everything above is in place by now.
+    header->state.store(agent::State::RUNNING);
+
+    return 0;
+}
+
+REGENNY_AGENT_API void regenny_agent_stop() {
+    std::scoped_lock _{g_mtx};
+
+    if (g_region == nullptr) {
+        return;
+    }
+
+    auto header = (agent::Header*)g_region->data();
+
+    header->state.store(agent::State::STOPPED);
+    g_stop = true;
+    header->doorbell.fetch_add(1);
+    SharedMemory::wake(header->doorbell);
+
+    if (g_thread.joinable()) {
+        g_thread.join();
+    }
+
+    // A client still mapping the region sees STOPPED and falls back to its regular backend.
+    g_region.reset();
+}
+
+#ifdef _WIN32
+BOOL APIENTRY DllMain(HMODULE module, DWORD reason, LPVOID reserved) {
+    // Threads can't be started or joined under the loader lock, hand it off.
+    if (reason == DLL_PROCESS_ATTACH) {
+        DisableThreadLibraryCalls(module);
+        CloseHandle(CreateThread(
+            nullptr, 0, [](LPVOID) -> DWORD { return (DWORD)regenny_agent_start(); }, nullptr, 0, nullptr));
+    } else if (reason == DLL_PROCESS_DETACH && g_thread.joinable()) {
+        // Either the process is exiting (the thread is already gone) or someone called FreeLibrary without
+        // regenny_agent_stop() first. Neither can join under the loader lock.
+        g_stop = true;
+        g_thread.detach();
+    }
+
+    return TRUE;
+}
+#else
+namespace {
+// Runs when the library is loaded (LD_PRELOAD or dlopen) and stops the thread again before the region is unmapped on
+// exit or dlclose.
+struct AutoStart {
+    AutoStart() { regenny_agent_start(); }
+    ~AutoStart() { regenny_agent_stop(); }
+} g_auto_start{};
+} // namespace
+#endif
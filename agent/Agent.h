@@ -0,0 +1,16 @@
+#pragma once
+
+// Reference agent for SharedMemoryProcess. Load it into the target (LD_PRELOAD, dlopen, LoadLibrary, or link it in) and
+// it serves ReGenny's reads and writes from inside the process over shared memory. It starts itself when loaded; the
+// functions below are for hosts that want to control its lifetime. On Windows, call regenny_agent_stop() before
+// FreeLibrary.
+
+#ifdef _WIN32
+#define REGENNY_AGENT_API extern "C" __declspec(dllexport)
+#else
+#define REGENNY_AGENT_API extern "C" __attribute__((visibility("default")))
+#endif
+
+// Returns 0 on success (or if it's already running).
+REGENNY_AGENT_API int regenny_agent_start();
+REGENNY_AGENT_API void regenny_agent_stop();
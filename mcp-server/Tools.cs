@@ -16,15 +16,107 @@ public static class StatusTools
 
     [McpServerTool(Name = "regenny_list_processes")]
     [Description("List available processes to attach to. Returns array of {pid, name}.")]
-    public static async Task<string> ListProcesses()
-        => await Http.Get("/api/processes");
+    public static async Task<string> ListProcesses(
+        [Description("host:port of a regenny-remote server to list processes on (omit for this machine)")] string? remote = null,
+        [Description("Token the regenny-remote server was started with")] string? token = null)
+        => await Http.Get("/api/processes", new() { ["remote"] = remote, ["token"] = token });
 
     [McpServerTool(Name = "regenny_attach")]
-    [Description("Attach to a target process by PID or name. Deferred to main thread.")]
+    [Description("Attach to a target process by PID or name. Runs in the background; poll regenny_status ('attach' field) until it's finished.")]
     public static async Task<string> Attach(
         [Description("Process ID (integer)")] int? pid = null,
-        [Description("Process name (e.g. 'game.exe')")] string? name = null)
-        => await Http.Post("/api/attach", new { pid, name });
+        [Description("Process name (e.g. 'game.exe')")] string? name = null,
+        [Description("host:port of a regenny-remote server the process runs on (omit for this machine)")] string remote = "",
+        [Description("Token the regenny-remote server was started with")] string token = "")
+        => await Http.Post("/api/attach", new { pid, name, remote, token });
+
+    [McpServerTool(Name = "regenny_attach_cancel")]
+    [Description("Cancel an attach that's still in progress")]
+    public static async Task<string> AttachCancel()
+        => await Http.Post("/api/attach/cancel", new { });
+
+    [McpServerTool(Name = "regenny_trace_record")]
+    [Description("Start recording every memory read of the attached process, plus its memory map, to a trace file")]
+    public static async Task<string> TraceRecord(
+        [Description("Path of the trace file to write")] string path)
+        => await Http.Post("/api/trace/record", new { path });
+
+    [McpServerTool(Name = "regenny_trace_stop")]
+    [Description("Stop recording a trace and keep using the process directly")]
+    public static async Task<string> TraceStop()
+        => await Http.Post("/api/trace/stop", new { });
+
+    [McpServerTool(Name = "regenny_trace_open")]
+    [Description("Replay a recorded trace in place of a live process")]
+    public static async Task<string> TraceOpen(
+        [Description("Path of the trace file")] string path,
+        [Description("Sleep for each read's recorded latency")] bool replay_latency = false)
+        => await Http.Post("/api/trace/open", new { path, replay_latency });
+
+    [McpServerTool(Name = "regenny_dump_open")]
+    [Description("Open a dump file (ELF core, Windows minidump, PE image or ReGenny snapshot) in place of a live process")]
+    public static async Task<string> DumpOpen(
+        [Description("Path of the dump file")] string path)
+        => await Http.Post("/api/dump/open", new { path });
+
+    [McpServerTool(Name = "regenny_snapshot_capture")]
+    [Description("Capture the attached process's memory (every readable allocation) to a compressed snapshot file in the background. Poll regenny_snapshot_status; open the result with regenny_dump_open.")]
+    public static async Task<string> SnapshotCapture(
+        [Description("Path of the snapshot file to write")] string path,
+        [Description("Compress chunks with LZ4")] bool compress = true)
+        => await Http.Post("/api/snapshot/capture", new { path, compress });
+
+    [McpServerTool(Name = "regenny_snapshot_status")]
+    [Description("Progress of the current or last snapshot capture")]
+    public static async Task<string> SnapshotStatus()
+        => await Http.Get("/api/snapshot/status");
+
+    [McpServerTool(Name = "regenny_timeline_start")]
+    [Description("Start capturing the attached process's writable memory into a deduplicated timeline at a fixed interval")]
+    public static async Task<string> TimelineStart()
+        => await Http.Post("/api/timeline/start", new { });
+
+    [McpServerTool(Name = "regenny_timeline_stop")]
+    [Description("Stop the timeline, drop its points and go back to reading the process directly")]
+    public static async Task<string> TimelineStop()
+        => await Http.Post("/api/timeline/stop", new { });
+
+    [McpServerTool(Name = "regenny_timeline")]
+    [Description("List timeline points (capture time, pages, newly stored pages) and deduplication stats")]
+    public static async Task<string> Timeline()
+        => await Http.Get("/api/timeline");
+
+    [McpServerTool(Name = "regenny_timeline_capture")]
+    [Description("Capture a timeline point now instead of waiting for the next interval")]
+    public static async Task<string> TimelineCapture()
+        => await Http.Post("/api/timeline/capture", new { });
+
+    [McpServerTool(Name = "regenny_timeline_point")]
+    [Description("Read memory as of a timeline point; every other read tool then sees that point")]
+    public static async Task<string> TimelinePoint(
+        [Description("Point id from regenny_timeline, or -1 for the live process")] long id)
+        => await Http.Post("/api/timeline/point", new { id });
+
+    [McpServerTool(Name = "regenny_diff")]
+    [Description("Compare two views of memory and list the byte ranges that changed. The result is highlighted in the node tree. Sources: \"live\", \"timeline:<point id>\" or the path of a snapshot/dump file.")]
+    public static async Task<string> Diff(
+        [Description("Source to compare from, e.g. timeline:0 or a .rgsnap path")] string before,
+        [Description("Source to compare to")] string after = "live",
+        [Description("Join changed ranges closer than this many bytes")] int merge_gap = 0,
+        [Description("Maximum number of ranges to return")] int limit = 1000)
+        => await Http.Post("/api/diff", new { before, after, merge_gap, limit });
+
+    [McpServerTool(Name = "regenny_diff_ranges")]
+    [Description("Page through the changed ranges of the last diff")]
+    public static async Task<string> DiffRanges(
+        [Description("Index of the first range")] int offset = 0,
+        [Description("Maximum number of ranges to return")] int limit = 1000)
+        => await Http.Get("/api/diff", new() { ["offset"] = offset.ToString(), ["limit"] = limit.ToString() });
+
+    [McpServerTool(Name = "regenny_diff_clear")]
+    [Description("Forget the last diff and remove its highlighting")]
+    public static async Task<string> DiffClear()
+        => await Http.Post("/api/diff/clear", new { });
 
     [McpServerTool(Name = "regenny_detach")]
     [Description("Detach from the current process")]
@@ -210,14 +302,35 @@ public static class ProjectTools
 public static class RttiTools
 {
     [McpServerTool(Name = "regenny_rtti_typename")]
-    [Description("Get RTTI type name at a pointer address (Windows only). The pointer should point to an object with a vtable.")]
+    [Description("Get RTTI type name at a pointer address (MSVC or Itanium/GCC/Clang RTTI). The pointer should point to an object with a vtable.")]
     public static async Task<string> RttiTypename(
         [Description("Object pointer address (hex or decimal)")] string address)
         => await Http.Get("/api/rtti/typename", new() { ["address"] = address });
 
     [McpServerTool(Name = "regenny_rtti_vtable_typename")]
-    [Description("Get RTTI type name from a vtable pointer address (Windows only)")]
+    [Description("Get RTTI type name from a vtable pointer address (MSVC or Itanium/GCC/Clang RTTI)")]
     public static async Task<string> RttiVtableTypename(
         [Description("Vtable pointer address (hex or decimal)")] string address)
         => await Http.Get("/api/rtti/vtable_typename", new() { ["address"] = address });
+
+    [McpServerTool(Name = "regenny_rtti_bases")]
+    [Description("Get the RTTI class of the object at a pointer address and every class it derives from, the class itself first")]
+    public static async Task<string> RttiBases(
+        [Description("Object pointer address (hex or decimal)")] string address)
+        => await Http.Get("/api/rtti/bases", new() { ["address"] = address });
+
+    [McpServerTool(Name = "regenny_rtti_catalog")]
+    [Description("Which modules have an RTTI catalog (built in the background after attaching) and the progress of the catalog job")]
+    public static async Task<string> RttiCatalog()
+        => await Http.Get("/api/rtti/catalog");
+
+    [McpServerTool(Name = "regenny_rtti_classes")]
+    [Description("List every polymorphic class of a cataloged module with its vtable addresses and base classes")]
+    public static async Task<string> RttiClasses(
+        [Description("Module filename, e.g. game.dll")] string module,
+        [Description("Only classes whose name contains this")] string filter = "",
+        [Description("Skip this many matching classes")] int offset = 0,
+        [Description("Return at most this many classes")] int limit = 1000)
+        => await Http.Get("/api/rtti/classes", new() {
+            ["module"] = module, ["filter"] = filter, ["offset"] = offset.ToString(), ["limit"] = limit.ToString() });
 }
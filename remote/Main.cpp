@@ -0,0 +1,53 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "backend/RemoteProtocol.hpp"
+#include "backend/RemoteServer.hpp"
+
+// regenny-remote: serves the processes on this machine to ReGenny instances elsewhere (Action > Attach, Remote field).
+int main(int argc, char** argv) {
+    // Loopback unless told otherwise, listening on other interfaces has to be asked for.
+    std::string address{"127.0.0.1"};
+    uint16_t port{remote::DEFAULT_PORT};
+    std::string token{};
+
+    if (auto env = std::getenv("REGENNY_REMOTE_TOKEN"); env != nullptr) {
+        token = env;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg{argv[i]};
+
+        if ((arg == "--bind" || arg == "-b") && i + 1 < argc) {
+            address = argv[++i];
+        } else if ((arg == "--port" || arg == "-p") && i + 1 < argc) {
+            port = (uint16_t)std::strtoul(argv[++i], nullptr, 10);
+        } else if ((arg == "--token" || arg == "-t") && i + 1 < argc) {
+            token = argv[++i];
+        } else {
+            std::printf("usage: %s --token secret [--bind address] [--port port]\n", argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    // Anyone holding the token can read and write every process we can, so there's no running without one.
+    if (token.empty()) {
+        spdlog::error("A token is required (--token or REGENNY_REMOTE_TOKEN)");
+        return 1;
+    }
+
+    RemoteServer server{address, port, token};
+
+    if (!server.ok()) {
+        spdlog::error("Couldn't listen on {}:{}", address, port);
+        return 1;
+    }
+
+    spdlog::info("Listening on {}:{}", address, server.port());
+    server.run();
+
+    return 0;
+}
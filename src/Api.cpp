@@ -3,6 +3,7 @@
 #include <fstream>
 #include <mutex>
 #include <shared_mutex>
+#include <unordered_map>
 
 #include <fmt/format.h>
 #include <httplib.h>
@@ -13,10 +14,11 @@
 #include "Api.hpp"
 #include "ReGenny.hpp"
 #include "arch/Arch.hpp"
-
-#ifdef _WIN32
-#include "arch/Windows.hpp"
-#endif
+#include "backend/MappedProcess.hpp"
+#include "backend/RecordingProcess.hpp"
+#include "backend/RemoteProcess.hpp"
+#include "backend/ReplayProcess.hpp"
+#include "backend/TimelineProcess.hpp"
 
 using json = nlohmann::json;
 
@@ -72,6 +74,22 @@ static std::optional<uintptr_t> parse_addr_param(const std::string& s) {
     return std::nullopt;
 }
 
+// Process lists for this machine (empty remote) or a regenny-remote server. nullptr if the address is malformed.
+static std::unique_ptr<Helpers> make_helpers(const std::string& remote, const std::string& token) {
+    if (remote.empty()) {
+        return arch::make_helpers();
+    }
+
+    std::string host{};
+    uint16_t port{};
+
+    if (!remote::parse_address(remote, host, port)) {
+        return nullptr;
+    }
+
+    return std::make_unique<RemoteHelpers>(host, port, token);
+}
+
 // Recursively serialize a sdkgenny::Struct to JSON (fields, offsets, types, parents).
 static json serialize_struct(sdkgenny::Struct* s) {
     json j;
@@ -177,6 +195,34 @@ std::optional<Api::DeferredAttach> Api::consume_deferred_attach() {
     return result;
 }
 
+std::optional<Api::DeferredTrace> Api::consume_deferred_trace() {
+    std::scoped_lock lk{m_deferred_lock};
+    auto result = std::move(m_deferred_trace);
+    m_deferred_trace.reset();
+    return result;
+}
+
+std::optional<Api::DeferredTimeline> Api::consume_deferred_timeline() {
+    std::scoped_lock lk{m_deferred_lock};
+    auto result = std::move(m_deferred_timeline);
+    m_deferred_timeline.reset();
+    return result;
+}
+
+std::optional<Api::DeferredDump> Api::consume_deferred_dump() {
+    std::scoped_lock lk{m_deferred_lock};
+    auto result = std::move(m_deferred_dump);
+    m_deferred_dump.reset();
+    return result;
+}
+
+std::optional<Api::DeferredCapture> Api::consume_deferred_capture() {
+    std::scoped_lock lk{m_deferred_lock};
+    auto result = std::move(m_deferred_capture);
+    m_deferred_capture.reset();
+    return result;
+}
+
 std::optional<Api::DeferredOpen> Api::consume_deferred_open() {
     std::scoped_lock lk{m_deferred_lock};
     auto result = std::move(m_deferred_open);
@@ -220,6 +266,12 @@ void Api::register_routes() {
         }
     });
 
+    // Handlers run on httplib's worker threads which only ever serve the API, so tagging the thread is enough.
+    m_server->set_pre_routing_handler([](const httplib::Request&, httplib::Response&) {
+        IoScope::thread_category(IoCategory::API);
+        return httplib::Server::HandlerResponse::Unhandled;
+    });
+
     // ── Status ───────────────────────────────────────────────────────────
     m_server->Get("/api/status", [rg](const httplib::Request&, httplib::Response& res) {
         std::shared_lock state_lk{rg->state_mtx()};
@@ -238,15 +290,55 @@ void Api::register_routes() {
         }
         j["current_address"] = fmt::format("0x{:X}", rg->address());
         j["sdk_loaded"] = rg->sdk() != nullptr;
+        if (auto& progress = rg->attach_progress()) {
+            j["attach"] = json{{"phase", AttachProgress::phase_name(progress->phase)},
+                {"finished", progress->finished()}, {"modules", progress->modules.load()},
+                {"regions", progress->regions.load()}, {"bytes_cached", progress->bytes_cached.load()}};
+        } else {
+            j["attach"] = nullptr;
+        }
+        if (dynamic_cast<RecordingProcess*>(proc.get()) != nullptr) {
+            j["trace"] = "recording";
+        } else if (auto replay = dynamic_cast<ReplayProcess*>(proc.get())) {
+            auto stats = replay->stats();
+            j["trace"] = json{{"replaying", true}, {"exact", stats.exact}, {"image", stats.image},
+                {"misses", stats.misses}};
+        } else {
+            j["trace"] = nullptr;
+        }
+        if (auto dump = dynamic_cast<MappedProcess*>(proc.get())) {
+            j["dump"] = json{{"path", dump->path().string()}, {"description", dump->description()}};
+        } else {
+            j["dump"] = nullptr;
+        }
+        j["timeline"] = dynamic_cast<TimelineProcess*>(proc.get()) != nullptr;
+        if (proc) {
+            auto freeze = proc->freeze_summary();
+            j["consistent_reads"] = json{{"freezes", freeze.count}, {"suspended", freeze.last.suspended},
+                {"last_pause_ns", freeze.last.pause.count()}, {"max_pause_ns", freeze.max_pause.count()},
+                {"total_pause_ns", freeze.total_pause.count()}, {"ranges", freeze.last.ranges},
+                {"bytes", freeze.last.bytes}, {"failed", freeze.last.failed}};
+        } else {
+            j["consistent_reads"] = nullptr;
+        }
+        if (auto remote = dynamic_cast<RemoteProcess*>(proc.get())) {
+            j["remote"] = remote->address();
+        } else {
+            j["remote"] = nullptr;
+        }
         json_response(res, j);
     });
 
     // ── Process Management ───────────────────────────────────────────────
-    m_server->Get("/api/processes", [rg](const httplib::Request&, httplib::Response& res) {
+    m_server->Get("/api/processes", [rg](const httplib::Request& req, httplib::Response& res) {
         std::shared_lock state_lk{rg->state_mtx()};
         // We need helpers to list processes, but that's private.
-        // Use arch::make_helpers() directly.
-        auto helpers = arch::make_helpers();
+        // Make our own, for this machine or the ?remote=host:port&token=... server.
+        auto helpers = make_helpers(req.get_param_value("remote"), req.get_param_value("token"));
+        if (helpers == nullptr) {
+            json_error(res, "Invalid remote address");
+            return;
+        }
         auto procs = helpers->processes();
         auto arr = json::array();
         for (auto& [pid, name] : procs) {
@@ -261,10 +353,18 @@ void Api::register_routes() {
             DeferredAttach da;
             if (body.contains("pid")) da.pid = body["pid"].get<uint32_t>();
             if (body.contains("name")) da.name = body["name"].get<std::string>();
+            if (body.contains("remote")) da.remote = body["remote"].get<std::string>();
+            if (body.contains("token")) da.token = body["token"].get<std::string>();
+
+            // Names are resolved on whichever machine we're attaching on.
+            auto helpers = make_helpers(da.remote, da.token);
+            if (helpers == nullptr) {
+                json_error(res, "Invalid remote address");
+                return;
+            }
 
             if (da.pid == 0 && !da.name.empty()) {
                 // Resolve name to PID
-                auto helpers = arch::make_helpers();
                 auto procs = helpers->processes();
                 for (auto& [pid, name] : procs) {
                     if (name == da.name) {
@@ -281,7 +381,6 @@ void Api::register_routes() {
 
             // Fill in name if we only had PID
             if (da.name.empty()) {
-                auto helpers = arch::make_helpers();
                 auto procs = helpers->processes();
                 if (procs.count(da.pid)) da.name = procs[da.pid];
             }
@@ -290,12 +389,311 @@ void Api::register_routes() {
                 std::scoped_lock lk{m_deferred_lock};
                 m_deferred_attach = da;
             }
-            json_response(res, json{{"status", "ok"}, {"pid", da.pid}, {"name", da.name}});
+            json_response(res, json{{"status", "ok"}, {"pid", da.pid}, {"name", da.name}, {"remote", da.remote}});
+        } catch (const std::exception& e) {
+            json_error(res, e.what());
+        }
+    });
+
+    // ── Traces ───────────────────────────────────────────────────────────
+    m_server->Post("/api/trace/record", [this](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto body = json::parse(req.body);
+            auto path = body.value("path", std::string{});
+
+            if (path.empty()) {
+                json_error(res, "Missing 'path'");
+                return;
+            }
+
+            {
+                std::scoped_lock lk{m_deferred_lock};
+                m_deferred_trace = DeferredTrace{DeferredTrace::Op::RECORD, path};
+            }
+            json_response(res, json{{"status", "ok"}, {"path", path}});
+        } catch (const std::exception& e) {
+            json_error(res, e.what());
+        }
+    });
+
+    m_server->Post("/api/trace/stop", [this](const httplib::Request&, httplib::Response& res) {
+        {
+            std::scoped_lock lk{m_deferred_lock};
+            m_deferred_trace = DeferredTrace{DeferredTrace::Op::STOP};
+        }
+        json_response(res, json{{"status", "ok"}});
+    });
+
+    m_server->Post("/api/trace/open", [this](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto body = json::parse(req.body);
+            auto path = body.value("path", std::string{});
+
+            if (path.empty()) {
+                json_error(res, "Missing 'path'");
+                return;
+            }
+
+            {
+                std::scoped_lock lk{m_deferred_lock};
+                m_deferred_trace = DeferredTrace{DeferredTrace::Op::OPEN, path, body.value("replay_latency", false)};
+            }
+            json_response(res, json{{"status", "ok"}, {"path", path}});
+        } catch (const std::exception& e) {
+            json_error(res, e.what());
+        }
+    });
+
+    // ── Timeline ─────────────────────────────────────────────────────────
+    m_server->Post("/api/timeline/start", [this](const httplib::Request&, httplib::Response& res) {
+        {
+            std::scoped_lock lk{m_deferred_lock};
+            m_deferred_timeline = DeferredTimeline{DeferredTimeline::Op::START};
+        }
+        json_response(res, json{{"status", "ok"}});
+    });
+
+    m_server->Post("/api/timeline/stop", [this](const httplib::Request&, httplib::Response& res) {
+        {
+            std::scoped_lock lk{m_deferred_lock};
+            m_deferred_timeline = DeferredTimeline{DeferredTimeline::Op::STOP};
+        }
+        json_response(res, json{{"status", "ok"}});
+    });
+
+    m_server->Get("/api/timeline", [rg](const httplib::Request&, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto timeline = dynamic_cast<TimelineProcess*>(rg->process().get());
+
+        if (timeline == nullptr) {
+            json_error(res, "No timeline running");
+            return;
+        }
+
+        auto stats = timeline->timeline().stats();
+        auto points = json::array();
+
+        for (auto&& p : timeline->timeline().points()) {
+            auto time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(p.time.time_since_epoch());
+
+            points.push_back({{"id", p.id}, {"time_ms", time_ms.count()}, {"pages", p.pages}, {"new_pages", p.new_pages},
+                {"duration_ms", std::chrono::duration<double, std::milli>{p.duration}.count()}});
+        }
+
+        auto point = timeline->point();
+
+        json_response(res, json{{"point", point == TimelineProcess::LIVE ? json(-1) : json(point)},
+            {"unique_pages", stats.unique_pages}, {"logical_pages", stats.logical_pages},
+            {"bytes", stats.unique_pages * Timeline::PAGE_SIZE}, {"points", points}});
+    });
+
+    m_server->Post("/api/timeline/capture", [rg](const httplib::Request&, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto timeline = dynamic_cast<TimelineProcess*>(rg->process().get());
+
+        if (timeline == nullptr) {
+            json_error(res, "No timeline running");
+            return;
+        }
+
+        timeline->request_capture();
+        json_response(res, json{{"status", "ok"}});
+    });
+
+    // Body: {"id": N}, a point id from /api/timeline. -1 goes back to reading the live process.
+    m_server->Post("/api/timeline/point", [rg](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto body = json::parse(req.body);
+            auto id = body.value("id", int64_t{-1});
+
+            std::shared_lock state_lk{rg->state_mtx()};
+            auto timeline = dynamic_cast<TimelineProcess*>(rg->process().get());
+
+            if (timeline == nullptr) {
+                json_error(res, "No timeline running");
+                return;
+            }
+
+            if (id >= 0 && !timeline->timeline().contains((uint64_t)id)) {
+                json_error(res, "No such point");
+                return;
+            }
+
+            timeline->point(id < 0 ? TimelineProcess::LIVE : (uint64_t)id);
+            json_response(res, json{{"status", "ok"}, {"point", id < 0 ? -1 : id}});
+        } catch (const std::exception& e) {
+            json_error(res, e.what());
+        }
+    });
+
+    // ── Diffs ────────────────────────────────────────────────────────────
+    // Sources are "live", "timeline:<point id>" or the path of a snapshot/dump file.
+    auto diff_json = [](const diff::Result& result, size_t offset, size_t limit) {
+        auto ranges = json::array();
+
+        for (auto i = offset; i < result.ranges.size() && i - offset < limit; ++i) {
+            auto&& r = result.ranges[i];
+            ranges.push_back({{"start", fmt::format("0x{:X}", r.start)}, {"size", r.end - r.start}});
+        }
+
+        auto&& stats = result.stats;
+
+        return json{{"count", result.ranges.size()}, {"offset", offset}, {"ranges", ranges},
+            {"stats", {{"pages", stats.pages}, {"pages_skipped", stats.pages_skipped},
+                          {"pages_unreadable", stats.pages_unreadable}, {"pages_changed", stats.pages_changed},
+                          {"bytes_compared", stats.bytes_compared}, {"bytes_changed", stats.bytes_changed},
+                          {"duration_ms", std::chrono::duration<double, std::milli>{stats.duration}.count()},
+                          {"kernel", stats.kernel}}}};
+    };
+
+    // Body: {"before": "timeline:0", "after": "live", "ranges": [{"start": "0x...", "size": N}], "merge_gap": 0,
+    // "limit": 1000}. Without ranges every readable allocation is compared.
+    m_server->Post("/api/diff", [rg, diff_json](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto body = json::parse(req.body);
+            auto before = body.value("before", std::string{});
+            auto after = body.value("after", std::string{"live"});
+            std::vector<diff::Range> ranges{};
+
+            if (before.empty()) {
+                json_error(res, "Missing 'before'");
+                return;
+            }
+
+            for (auto&& r : body.value("ranges", json::array())) {
+                auto start = parse_addr_param(r.value("start", std::string{}));
+                auto size = r.value("size", size_t{});
+
+                if (!start || size == 0) {
+                    json_error(res, "Each range needs a 'start' address and a non-zero 'size'");
+                    return;
+                }
+
+                ranges.emplace_back(*start, *start + size);
+            }
+
+            std::shared_lock state_lk{rg->state_mtx()};
+            std::string error{};
+            auto result = rg->run_diff(before, after, std::move(ranges), body.value("merge_gap", size_t{}), error);
+
+            if (result == nullptr) {
+                json_error(res, error);
+                return;
+            }
+
+            json_response(res, diff_json(*result, 0, body.value("limit", size_t{1000})));
+        } catch (const std::exception& e) {
+            json_error(res, e.what());
+        }
+    });
+
+    m_server->Get("/api/diff", [rg, diff_json](const httplib::Request& req, httplib::Response& res) {
+        auto result = rg->diff_result();
+
+        if (result == nullptr) {
+            json_error(res, "No diff");
+            return;
+        }
+
+        auto offset = req.has_param("offset") ? std::stoull(req.get_param_value("offset"), nullptr, 0) : 0;
+        auto limit = req.has_param("limit") ? std::stoull(req.get_param_value("limit"), nullptr, 0) : 1000;
+
+        json_response(res, diff_json(*result, (size_t)offset, (size_t)limit));
+    });
+
+    m_server->Post("/api/diff/clear", [rg](const httplib::Request&, httplib::Response& res) {
+        rg->diff_result(nullptr);
+        json_response(res, json{{"status", "ok"}});
+    });
+
+    // ── Dumps ────────────────────────────────────────────────────────────
+    m_server->Post("/api/dump/open", [this](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto body = json::parse(req.body);
+            auto path = body.value("path", std::string{});
+
+            if (path.empty()) {
+                json_error(res, "Missing 'path'");
+                return;
+            }
+
+            {
+                std::scoped_lock lk{m_deferred_lock};
+                m_deferred_dump = DeferredDump{path};
+            }
+            json_response(res, json{{"status", "ok"}, {"path", path}});
         } catch (const std::exception& e) {
             json_error(res, e.what());
         }
     });
 
+    // ── Snapshots ────────────────────────────────────────────────────────
+    // Body: {"path": "...", "ranges": [{"start": "0x...", "size": N}], "compress": true}. Without ranges every
+    // readable allocation is captured. Open the result with /api/dump/open.
+    m_server->Post("/api/snapshot/capture", [this](const httplib::Request& req, httplib::Response& res) {
+        try {
+            auto body = json::parse(req.body);
+            DeferredCapture dc{};
+
+            dc.path = body.value("path", std::string{});
+            dc.compress = body.value("compress", true);
+
+            if (dc.path.empty()) {
+                json_error(res, "Missing 'path'");
+                return;
+            }
+
+            for (auto&& r : body.value("ranges", json::array())) {
+                auto start = parse_addr_param(r.value("start", std::string{}));
+                auto size = r.value("size", size_t{});
+
+                if (!start || size == 0) {
+                    json_error(res, "Each range needs a 'start' address and a non-zero 'size'");
+                    return;
+                }
+
+                dc.ranges.emplace_back(*start, *start + size);
+            }
+
+            {
+                std::scoped_lock lk{m_deferred_lock};
+                m_deferred_capture = std::move(dc);
+            }
+            json_response(res, json{{"status", "ok"}});
+        } catch (const std::exception& e) {
+            json_error(res, e.what());
+        }
+    });
+
+    m_server->Get("/api/snapshot/status", [rg](const httplib::Request&, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& progress = rg->capture_progress();
+
+        if (progress == nullptr) {
+            json_response(res, json{{"capture", nullptr}});
+            return;
+        }
+
+        auto elapsed = std::chrono::duration<double>{std::chrono::steady_clock::now() - progress->start_time};
+
+        json_response(res, json{{"capture", {{"finished", progress->finished.load()}, {"ok", progress->ok.load()},
+            {"chunks", progress->chunks.load()}, {"chunks_done", progress->chunks_done.load()},
+            {"bytes_read", progress->bytes_read.load()}, {"bytes_written", progress->bytes_written.load()},
+            {"elapsed", elapsed.count()}}}});
+    });
+
+    m_server->Post("/api/attach/cancel", [rg](const httplib::Request&, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& progress = rg->attach_progress();
+        if (!progress || progress->finished()) {
+            json_error(res, "No attach in progress");
+            return;
+        }
+
+        progress->cancel();
+        json_response(res, json{{"status", "ok"}});
+    });
+
     m_server->Post("/api/detach", [this](const httplib::Request&, httplib::Response& res) {
         m_detach_requested.store(true);
         json_response(res, json{{"status", "ok"}});
@@ -381,37 +779,49 @@ void Api::register_routes() {
         int count = 1;
         if (!count_str.empty()) count = std::clamp(std::stoi(count_str), 1, 50);
 
+        static const std::unordered_map<std::string, size_t> type_sizes{
+            {"u8", 1}, {"i8", 1}, {"u16", 2}, {"i16", 2}, {"u32", 4}, {"i32", 4}, {"u64", 8}, {"i64", 8},
+            {"f32", 4}, {"f64", 8}, {"ptr", sizeof(uintptr_t)},
+        };
+
+        auto type_size = type_sizes.find(type_str);
+        if (type_size == type_sizes.end()) {
+            json_error(res, "Unknown type. Supported: u8,i8,u16,i16,u32,i32,u64,i64,f32,f64,ptr");
+            return;
+        }
+
+        // Every element is its own request so one unreadable element doesn't null out the rest, but they all go to
+        // the target in one batch.
+        std::vector<uint64_t> raw(count);
+        std::vector<Process::ReadRequest> requests(count);
+
+        for (int i = 0; i < count; i++) {
+            requests[i] = {*addr + i * type_size->second, &raw[i], type_size->second};
+        }
+
+        proc->read_batch(requests);
+
         auto values = json::array();
 
         for (int i = 0; i < count; i++) {
-            auto cur = *addr;
-
-            if (type_str == "u8") {
-                auto v = proc->read<uint8_t>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 1;
-            } else if (type_str == "i8") {
-                auto v = proc->read<int8_t>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 1;
-            } else if (type_str == "u16") {
-                auto v = proc->read<uint16_t>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 2;
-            } else if (type_str == "i16") {
-                auto v = proc->read<int16_t>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 2;
-            } else if (type_str == "u32") {
-                auto v = proc->read<uint32_t>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 4;
-            } else if (type_str == "i32") {
-                auto v = proc->read<int32_t>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 4;
-            } else if (type_str == "u64") {
-                auto v = proc->read<uint64_t>(cur); values.push_back(v ? json(fmt::format("0x{:X}", *v)) : json(nullptr)); *addr += 8;
-            } else if (type_str == "i64") {
-                auto v = proc->read<int64_t>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 8;
-            } else if (type_str == "f32") {
-                auto v = proc->read<float>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 4;
-            } else if (type_str == "f64") {
-                auto v = proc->read<double>(cur); values.push_back(v ? json(*v) : json(nullptr)); *addr += 8;
-            } else if (type_str == "ptr") {
-                auto v = proc->read<uintptr_t>(cur); values.push_back(v ? json(fmt::format("0x{:X}", *v)) : json(nullptr)); *addr += sizeof(uintptr_t);
-            } else {
-                json_error(res, "Unknown type. Supported: u8,i8,u16,i16,u32,i32,u64,i64,f32,f64,ptr");
-                return;
+            if (!requests[i].ok) {
+                values.push_back(nullptr);
+                continue;
             }
+
+            auto v = &raw[i];
+
+            if (type_str == "u8") values.push_back(*(uint8_t*)v);
+            else if (type_str == "i8") values.push_back(*(int8_t*)v);
+            else if (type_str == "u16") values.push_back(*(uint16_t*)v);
+            else if (type_str == "i16") values.push_back(*(int16_t*)v);
+            else if (type_str == "u32") values.push_back(*(uint32_t*)v);
+            else if (type_str == "i32") values.push_back(*(int32_t*)v);
+            else if (type_str == "u64") values.push_back(fmt::format("0x{:X}", *(uint64_t*)v));
+            else if (type_str == "i64") values.push_back(*(int64_t*)v);
+            else if (type_str == "f32") values.push_back(*(float*)v);
+            else if (type_str == "f64") values.push_back(*(double*)v);
+            else if (type_str == "ptr") values.push_back(fmt::format("0x{:X}", *(uintptr_t*)v));
         }
 
         json j;
@@ -527,6 +937,154 @@ void Api::register_routes() {
         json_response(res, arr);
     });
 
+    m_server->Get("/api/memory/map_events", [rg](const httplib::Request& req, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& proc = rg->process();
+        if (!proc || proc->process_id() == 0) {
+            json_error(res, "Not attached to a process");
+            return;
+        }
+
+        size_t count = 100;
+        auto count_str = req.get_param_value("count");
+        if (!count_str.empty()) count = std::clamp(std::stoi(count_str), 1, 1024);
+
+        auto& events = rg->map_events();
+        auto arr = json::array();
+        for (auto it = events.size() > count ? events.end() - count : events.begin(); it != events.end(); ++it) {
+            json e{
+                {"kind", Process::MapEvent::kind_name(it->kind)},
+                {"start", fmt::format("0x{:X}", it->start)},
+                {"end", fmt::format("0x{:X}", it->end)},
+            };
+            if (!it->module.empty()) {
+                e["module"] = it->module;
+            } else {
+                e["read"] = it->read;
+                e["write"] = it->write;
+                e["execute"] = it->execute;
+            }
+            arr.push_back(std::move(e));
+        }
+
+        json j;
+        j["events"] = arr;
+        if (auto& refresher = rg->map_refresher()) {
+            auto stats = refresher->stats();
+            j["refresher"] = json{{"refreshes", stats.refreshes}, {"updates", stats.updates},
+                {"regions", stats.regions}, {"last_duration_us", stats.last_duration.count()}};
+        } else {
+            j["refresher"] = nullptr;
+        }
+        json_response(res, j);
+    });
+
+    m_server->Get("/api/cache/stats", [rg](const httplib::Request&, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& proc = rg->process();
+        if (!proc) {
+            json_error(res, "No process");
+            return;
+        }
+
+        auto ro = proc->read_only_cache().stats();
+        auto epoch = proc->epoch_cache().stats();
+        auto unreadable = proc->unreadable_cache().stats();
+        auto typenames = proc->typename_cache().stats();
+
+        json j;
+        j["read_only"] = json{{"hits", ro.hits}, {"misses", ro.misses}, {"evictions", ro.evictions},
+            {"bytes", ro.bytes}, {"budget", proc->read_only_cache().budget()}};
+        j["epoch"] = json{{"hits", epoch.hits}, {"misses", epoch.misses}, {"invalidations", epoch.invalidations},
+            {"epoch", epoch.epoch}, {"page_size", proc->epoch_cache().page_size()}};
+        j["unreadable"] = json{{"rejections", unreadable.rejections}, {"insertions", unreadable.insertions},
+            {"pages", unreadable.pages}, {"ttl_ms", proc->unreadable_cache().ttl().count()}};
+        auto lookups = typenames.hits + typenames.negative_hits + typenames.misses;
+        j["typename"] = json{{"hits", typenames.hits}, {"negative_hits", typenames.negative_hits},
+            {"misses", typenames.misses}, {"rejections", typenames.rejections},
+            {"invalidations", typenames.invalidations}, {"entries", typenames.entries},
+            {"hit_rate", lookups != 0 ? (double)(typenames.hits + typenames.negative_hits) / lookups : 0.0}};
+        json_response(res, j);
+    });
+
+    m_server->Get("/api/io/stats", [rg](const httplib::Request&, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& proc = rg->process();
+        if (!proc) {
+            json_error(res, "No process");
+            return;
+        }
+
+        auto snapshot = proc->io_stats().snapshot();
+        auto categories = json::object();
+
+        for (size_t i = 0; i < snapshot.size(); ++i) {
+            auto& c = snapshot[i];
+            categories[std::string{io_category_name((IoCategory)i)}] = json{
+                {"reads", c.reads}, {"read_bytes", c.read_bytes}, {"read_failures", c.read_failures},
+                {"writes", c.writes}, {"write_bytes", c.write_bytes}, {"write_failures", c.write_failures},
+                {"backend_reads", c.backend_reads}, {"total_ns", c.total_ns},
+                {"p50_ns", c.percentile(0.5).count()}, {"p99_ns", c.percentile(0.99).count()},
+                {"histogram", c.histogram},
+            };
+        }
+
+        json j;
+        j["enabled"] = proc->io_stats().enabled();
+        j["categories"] = categories;
+        json_response(res, j);
+    });
+
+    m_server->Post("/api/io/stats", [rg](const httplib::Request& req, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& proc = rg->process();
+        if (!proc) {
+            json_error(res, "No process");
+            return;
+        }
+
+        auto body = req.body.empty() ? json::object() : json::parse(req.body);
+        if (body.contains("enabled")) proc->io_stats().enabled(body["enabled"].get<bool>());
+        if (body.value("reset", false)) proc->io_stats().reset();
+        json_response(res, json{{"status", "ok"}, {"enabled", proc->io_stats().enabled()}});
+    });
+
+    m_server->Get("/api/memory/region", [rg](const httplib::Request& req, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& proc = rg->process();
+        if (!proc || proc->process_id() == 0) {
+            json_error(res, "Not attached to a process");
+            return;
+        }
+
+        auto addr_str = req.get_param_value("address");
+        auto addr = parse_addr_param(addr_str);
+        if (!addr) { json_error(res, "Invalid address"); return; }
+
+        auto region = proc->get_region_within(*addr);
+        if (!region) {
+            json_response(res, json{{"address", addr_str}, {"region", nullptr}});
+            return;
+        }
+
+        json j;
+        j["address"] = addr_str;
+        j["start"] = fmt::format("0x{:X}", region->start);
+        j["end"] = fmt::format("0x{:X}", region->end);
+        j["read"] = region->read;
+        j["write"] = region->write;
+        j["execute"] = region->execute;
+        j["cached"] = region->cached != RegionIndex::npos;
+        if (region->module != RegionIndex::npos) {
+            auto& mod = proc->modules()[region->module];
+            j["module"] = mod.name;
+            j["module_offset"] = fmt::format("0x{:X}", *addr - mod.start);
+        } else {
+            j["module"] = nullptr;
+        }
+        json_response(res, j);
+    });
+
     // ── Genny File Operations ────────────────────────────────────────────
     m_server->Get("/api/genny/content", [rg](const httplib::Request&, httplib::Response& res) {
         std::shared_lock state_lk{rg->state_mtx()};
@@ -753,6 +1311,7 @@ void Api::register_routes() {
                 auto& lua_lock = rg->lua_lock();
                 std::scoped_lock lk{lua_lock};
                 auto& lua = rg->lua();
+                IoScope io_scope{IoCategory::LUA};
 
                 auto prev_logger = spdlog::default_logger();
                 spdlog::set_default_logger(eval_logger);
@@ -814,6 +1373,7 @@ void Api::register_routes() {
                 auto& lua_lock = rg->lua_lock();
                 std::scoped_lock lk{lua_lock};
                 auto& lua = rg->lua();
+                IoScope io_scope{IoCategory::LUA};
 
                 auto prev_logger = spdlog::default_logger();
                 spdlog::set_default_logger(eval_logger);
@@ -908,20 +1468,80 @@ void Api::register_routes() {
     });
 
     // ── RTTI ─────────────────────────────────────────────────────────────
-#ifdef _WIN32
+    m_server->Get("/api/rtti/catalog", [rg](const httplib::Request&, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& proc = rg->process();
+        if (!proc) { json_error(res, "Not attached"); return; }
+
+        auto modules = json::array();
+
+        for (auto&& e : proc->rtti_catalog().entries()) {
+            modules.push_back({{"module", e.catalog->module}, {"start", fmt::format("0x{:X}", e.start)},
+                {"hash", fmt::format("{:016x}", e.catalog->hash)}, {"classes", e.catalog->classes.size()},
+                {"vtables", e.catalog->vtable_count()}, {"complete", e.catalog->complete}});
+        }
+
+        auto stats = proc->rtti_catalog().stats();
+        json j{{"modules", std::move(modules)}, {"hits", stats.hits}, {"misses", stats.misses}, {"job", nullptr}};
+
+        if (auto& progress = rg->catalog_progress()) {
+            j["job"] = {{"finished", progress->finished.load()}, {"modules", progress->modules.load()},
+                {"modules_done", progress->modules_done.load()}, {"modules_loaded", progress->modules_loaded.load()},
+                {"classes", progress->classes.load()}, {"partial", progress->partial.load()}};
+        }
+
+        json_response(res, j);
+    });
+
+    // Every polymorphic class of one cataloged module: ?module=game.dll[&filter=substring][&offset=0][&limit=1000].
+    m_server->Get("/api/rtti/classes", [rg](const httplib::Request& req, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& proc = rg->process();
+        if (!proc) { json_error(res, "Not attached"); return; }
+
+        auto module = req.get_param_value("module");
+        auto entry = proc->rtti_catalog().find(module);
+        if (!entry) { json_error(res, fmt::format("No RTTI catalog for module '{}' (yet)", module)); return; }
+
+        auto filter = req.get_param_value("filter");
+        auto offset = req.has_param("offset") ? std::stoull(req.get_param_value("offset"), nullptr, 0) : 0;
+        auto limit = req.has_param("limit") ? std::stoull(req.get_param_value("limit"), nullptr, 0) : 1000;
+        auto classes = json::array();
+        size_t matches{};
+
+        for (auto&& c : entry->catalog->classes) {
+            if (!filter.empty() && c.name.find(filter) == std::string::npos) {
+                continue;
+            }
+
+            if (matches++ < offset || classes.size() >= limit) {
+                continue;
+            }
+
+            auto vtables = json::array();
+
+            for (auto&& v : c.vtables) {
+                vtables.push_back({{"address", fmt::format("0x{:X}", entry->start + v.rva)}, {"offset", v.offset}});
+            }
+
+            classes.push_back({{"name", c.name}, {"decorated", c.decorated}, {"bases", c.bases},
+                {"attributes", c.attributes}, {"vtables", std::move(vtables)}});
+        }
+
+        json_response(res, json{{"module", entry->catalog->module}, {"start", fmt::format("0x{:X}", entry->start)},
+            {"total", matches}, {"classes", std::move(classes)}});
+    });
+
     m_server->Get("/api/rtti/typename", [rg](const httplib::Request& req, httplib::Response& res) {
         std::shared_lock state_lk{rg->state_mtx()};
         auto& proc = rg->process();
-        if (!proc || proc->process_id() == 0) { json_error(res, "Not attached"); return; }
+        if (!proc) { json_error(res, "Not attached"); return; }
 
         auto addr_str = req.get_param_value("address");
         auto addr = parse_addr_param(addr_str);
         if (!addr) { json_error(res, "Invalid address"); return; }
 
-        auto* wp = dynamic_cast<arch::WindowsProcess*>(proc.get());
-        if (!wp) { json_error(res, "RTTI only available on Windows processes"); return; }
-
-        auto name = wp->get_typename(*addr);
+        auto name = proc->get_typename(*addr);
         if (name) {
             json_response(res, json{{"address", addr_str}, {"typename", *name}});
         } else {
@@ -932,23 +1552,32 @@ void Api::register_routes() {
     m_server->Get("/api/rtti/vtable_typename", [rg](const httplib::Request& req, httplib::Response& res) {
         std::shared_lock state_lk{rg->state_mtx()};
         auto& proc = rg->process();
-        if (!proc || proc->process_id() == 0) { json_error(res, "Not attached"); return; }
+        if (!proc) { json_error(res, "Not attached"); return; }
 
         auto addr_str = req.get_param_value("address");
         auto addr = parse_addr_param(addr_str);
         if (!addr) { json_error(res, "Invalid address"); return; }
 
-        auto* wp = dynamic_cast<arch::WindowsProcess*>(proc.get());
-        if (!wp) { json_error(res, "RTTI only available on Windows processes"); return; }
-
-        auto name = wp->get_typename_from_vtable(*addr);
+        auto name = proc->get_typename_from_vtable(*addr);
         if (name) {
             json_response(res, json{{"address", addr_str}, {"typename", *name}});
         } else {
             json_response(res, json{{"address", addr_str}, {"typename", nullptr}});
         }
     });
-#endif
+
+    // The class of the object at ?address= and everything it derives from, the class itself first.
+    m_server->Get("/api/rtti/bases", [rg](const httplib::Request& req, httplib::Response& res) {
+        std::shared_lock state_lk{rg->state_mtx()};
+        auto& proc = rg->process();
+        if (!proc) { json_error(res, "Not attached"); return; }
+
+        auto addr_str = req.get_param_value("address");
+        auto addr = parse_addr_param(addr_str);
+        if (!addr) { json_error(res, "Invalid address"); return; }
+
+        json_response(res, json{{"address", addr_str}, {"bases", proc->get_base_typenames(*addr)}});
+    });
 
     // ── Help ─────────────────────────────────────────────────────────────
     m_server->Get("/api/help", [](const httplib::Request&, httplib::Response& res) {
@@ -34,10 +34,43 @@ public:
     struct DeferredAttach {
         uint32_t pid{};
         std::string name{};
+        // host:port of a regenny-remote server, empty for this machine.
+        std::string remote{};
+        // Token the remote server was started with.
+        std::string token{};
     };
     // Returns nullopt if no attach is pending.
     std::optional<DeferredAttach> consume_deferred_attach();
 
+    struct DeferredTrace {
+        enum class Op { RECORD, STOP, OPEN };
+
+        Op op{};
+        std::string path{};
+        bool replay_latency{};
+    };
+    std::optional<DeferredTrace> consume_deferred_trace();
+
+    struct DeferredTimeline {
+        enum class Op { START, STOP };
+
+        Op op{};
+    };
+    std::optional<DeferredTimeline> consume_deferred_timeline();
+
+    struct DeferredDump {
+        std::string path{};
+    };
+    std::optional<DeferredDump> consume_deferred_dump();
+
+    struct DeferredCapture {
+        std::string path{};
+        // Empty captures every readable allocation.
+        std::vector<std::pair<uintptr_t, uintptr_t>> ranges{};
+        bool compress{true};
+    };
+    std::optional<DeferredCapture> consume_deferred_capture();
+
     struct DeferredOpen {
         std::string filepath{};
     };
@@ -64,6 +97,10 @@ private:
 
     std::mutex m_deferred_lock;
     std::optional<DeferredAttach> m_deferred_attach;
+    std::optional<DeferredTrace> m_deferred_trace;
+    std::optional<DeferredTimeline> m_deferred_timeline;
+    std::optional<DeferredDump> m_deferred_dump;
+    std::optional<DeferredCapture> m_deferred_capture;
     std::optional<DeferredOpen> m_deferred_open;
     std::optional<DeferredTypeSelect> m_deferred_type_select;
 };
@@ -0,0 +1,68 @@
+#include <spdlog/spdlog.h>
+
+#include "arch/Arch.hpp"
+
+#include "AttachJob.hpp"
+
+std::string_view AttachProgress::phase_name(Phase phase) {
+    switch (phase) {
+    case Phase::STARTING:
+        return "Starting";
+    case Phase::MODULES:
+        return "Enumerating modules";
+    case Phase::REGIONS:
+        return "Walking memory regions";
+    case Phase::INDEXING:
+        return "Indexing";
+    case Phase::DONE:
+        return "Done";
+    case Phase::CANCELLED:
+        return "Cancelled";
+    case Phase::FAILED:
+        return "Failed";
+    }
+
+    return "Unknown";
+}
+
+AttachJob::AttachJob(uint32_t process_id, OpenFn open) : m_process_id{process_id} {
+    m_thread = std::thread{[this, open = std::move(open)] {
+        auto&& progress = *m_progress;
+        auto process = open ? open(m_process_id, progress) : arch::open_process(m_process_id, &progress);
+
+        if (progress.cancelled()) {
+            progress.phase = AttachProgress::Phase::CANCELLED;
+            return;
+        }
+
+        if (process == nullptr || !process->ok()) {
+            progress.phase = AttachProgress::Phase::FAILED;
+            return;
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - progress.start_time);
+
+        spdlog::info("Attached in {}ms ({} modules, {} regions)", elapsed.count(), progress.modules.load(),
+            progress.regions.load());
+
+        m_process = std::move(process);
+        progress.phase = AttachProgress::Phase::DONE;
+    }};
+}
+
+AttachJob::~AttachJob() {
+    cancel();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::unique_ptr<Process> AttachJob::take() {
+    if (m_progress->phase != AttachProgress::Phase::DONE) {
+        return nullptr;
+    }
+
+    return std::move(m_process);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+#include "Process.hpp"
+
+// Shared between an attach job, the backend it's constructing and whoever is watching (UI, API). Everything is atomic
+// so it can be polled from any thread.
+struct AttachProgress {
+    enum class Phase : uint8_t {
+        STARTING,
+        MODULES,
+        REGIONS,
+        INDEXING,
+        DONE,
+        CANCELLED,
+        FAILED,
+    };
+
+    std::atomic<Phase> phase{Phase::STARTING};
+    std::atomic<size_t> modules{};
+    std::atomic<size_t> regions{};
+    // Read-only memory found so far. It's cached lazily as it's read so this is what will be served from the page
+    // cache, not what's been copied already.
+    std::atomic<size_t> bytes_cached{};
+    std::atomic<bool> cancel_requested{};
+    std::chrono::steady_clock::time_point start_time{std::chrono::steady_clock::now()};
+
+    void cancel() { cancel_requested = true; }
+    bool cancelled() const { return cancel_requested.load(std::memory_order_relaxed); }
+
+    bool finished() const {
+        auto p = phase.load();
+        return p == Phase::DONE || p == Phase::CANCELLED || p == Phase::FAILED;
+    }
+
+    static std::string_view phase_name(Phase phase);
+};
+
+// Opens a process on a background thread. The finished Process is handed over with take() once the job is finished so
+// the owner can publish it in one step.
+class AttachJob {
+public:
+    using OpenFn = std::function<std::unique_ptr<Process>(uint32_t process_id, AttachProgress& progress)>;
+
+    // open defaults to arch::open_process (a process on this machine).
+    explicit AttachJob(uint32_t process_id, OpenFn open = {});
+    // Cancels the job if it's still running and waits for it.
+    ~AttachJob();
+
+    AttachJob(const AttachJob&) = delete;
+    AttachJob& operator=(const AttachJob&) = delete;
+
+    auto&& progress() const { return m_progress; }
+    auto process_id() const { return m_process_id; }
+
+    void cancel() { m_progress->cancel(); }
+    bool finished() const { return m_progress->finished(); }
+
+    // nullptr unless the job finished successfully.
+    std::unique_ptr<Process> take();
+
+private:
+    uint32_t m_process_id{};
+    std::shared_ptr<AttachProgress> m_progress{std::make_shared<AttachProgress>()};
+    std::unique_ptr<Process> m_process{};
+    std::thread m_thread{};
+};
@@ -11,6 +11,17 @@ void to_json(nlohmann::json& j, const Config& c) {
     j["refresh_rate"] = c.refresh_rate;
     j["always_on_top"] = c.always_on_top;
     j["api_enabled"] = c.api_enabled;
+    j["ro_cache_budget_mb"] = c.ro_cache_budget_mb;
+    j["epoch_cache_page_size"] = c.epoch_cache_page_size;
+    j["unreadable_ttl_ms"] = c.unreadable_ttl_ms;
+    j["map_refresh_ms"] = c.map_refresh_ms;
+    j["io_stats_enabled"] = c.io_stats_enabled;
+    j["timeline_interval_ms"] = c.timeline_interval_ms;
+    j["timeline_max_points"] = c.timeline_max_points;
+    j["consistent_reads"] = c.consistent_reads;
+    j["rtti_catalog"] = c.rtti_catalog;
+    j["remote_address"] = c.remote_address;
+    j["remote_token"] = c.remote_token;
 }
 
 void from_json(const nlohmann::json& j, Config& c) {
@@ -33,4 +44,15 @@ void from_json(const nlohmann::json& j, Config& c) {
     c.refresh_rate = j.value("refresh_rate", 500);
     c.always_on_top = j.value("always_on_top", false);
     c.api_enabled = j.value("api_enabled", true);
+    c.ro_cache_budget_mb = j.value("ro_cache_budget_mb", 256);
+    c.epoch_cache_page_size = j.value("epoch_cache_page_size", 0x1000);
+    c.unreadable_ttl_ms = j.value("unreadable_ttl_ms", 250);
+    c.map_refresh_ms = j.value("map_refresh_ms", 1000);
+    c.io_stats_enabled = j.value("io_stats_enabled", false);
+    c.timeline_interval_ms = j.value("timeline_interval_ms", 2000);
+    c.timeline_max_points = j.value("timeline_max_points", 256);
+    c.consistent_reads = j.value("consistent_reads", false);
+    c.rtti_catalog = j.value("rtti_catalog", true);
+    c.remote_address = j.value("remote_address", "");
+    c.remote_token = j.value("remote_token", "");
 }
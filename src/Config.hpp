@@ -16,6 +16,21 @@ struct Config {
     int refresh_rate{500};
     bool always_on_top{false};
     bool api_enabled{false};
+    int ro_cache_budget_mb{256};
+    int epoch_cache_page_size{0x1000};
+    int unreadable_ttl_ms{250};
+    int map_refresh_ms{1000};
+    bool io_stats_enabled{false};
+    int timeline_interval_ms{2000};
+    int timeline_max_points{256};
+    // Stop the target briefly every refresh so the node tree is read in one consistent batch.
+    bool consistent_reads{false};
+    // Catalog the RTTI of every module in the background after attaching.
+    bool rtti_catalog{true};
+    // regenny-remote server to attach through ("host:port"), empty for processes on this machine.
+    std::string remote_address{};
+    // Shared secret the server was started with (regenny-remote --token).
+    std::string remote_token{};
 };
 
 void to_json(nlohmann::json& j, const Config& c);
@@ -6,5 +6,7 @@
 
 class Helpers {
 public:
+    virtual ~Helpers() = default;
+
     virtual std::map<uint32_t, std::string> processes() = 0;
 };
\ No newline at end of file
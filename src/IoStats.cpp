@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <bit>
+
+#include "IoStats.hpp"
+
+thread_local IoCategory IoScope::s_current{IoCategory::OTHER};
+
+std::string_view io_category_name(IoCategory category) {
+    switch (category) {
+    case IoCategory::OTHER:
+        return "other";
+    case IoCategory::NODE_REFRESH:
+        return "node refresh";
+    case IoCategory::RTTI:
+        return "rtti";
+    case IoCategory::ADDRESS_RESOLVE:
+        return "address resolve";
+    case IoCategory::API:
+        return "api";
+    case IoCategory::LUA:
+        return "lua";
+    default:
+        return "unknown";
+    }
+}
+
+std::chrono::nanoseconds IoStats::Counters::percentile(double p) const {
+    uint64_t total{};
+
+    for (auto n : histogram) {
+        total += n;
+    }
+
+    if (total == 0) {
+        return {};
+    }
+
+    auto target = (uint64_t)(p * total);
+    uint64_t seen{};
+
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        seen += histogram[i];
+
+        if (seen > target || seen == total) {
+            return std::chrono::nanoseconds{1ull << (i + 1)};
+        }
+    }
+
+    return std::chrono::nanoseconds{1ull << histogram.size()};
+}
+
+void IoStats::record_latency(AtomicCounters& c, std::chrono::nanoseconds elapsed) {
+    auto ns = (uint64_t)std::max<int64_t>(elapsed.count(), 0);
+    auto bucket = std::min<size_t>(ns == 0 ? 0 : std::bit_width(ns) - 1, HISTOGRAM_BUCKETS - 1);
+
+    c.total_ns.fetch_add(ns, std::memory_order_relaxed);
+    c.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void IoStats::record_read(const Timer& timer, size_t bytes, size_t failures, size_t calls) {
+    if (!timer.enabled()) {
+        return;
+    }
+
+    auto&& c = m_counters[(size_t)IoScope::current()];
+
+    c.reads.fetch_add(calls, std::memory_order_relaxed);
+    c.read_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    c.read_failures.fetch_add(failures, std::memory_order_relaxed);
+    record_latency(c, timer.elapsed());
+}
+
+void IoStats::record_write(const Timer& timer, size_t bytes, bool ok) {
+    if (!timer.enabled()) {
+        return;
+    }
+
+    auto&& c = m_counters[(size_t)IoScope::current()];
+
+    c.writes.fetch_add(1, std::memory_order_relaxed);
+    c.write_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    c.write_failures.fetch_add(ok ? 0 : 1, std::memory_order_relaxed);
+    record_latency(c, timer.elapsed());
+}
+
+IoStats::Snapshot IoStats::snapshot() const {
+    Snapshot out{};
+
+    for (size_t i = 0; i < m_counters.size(); ++i) {
+        auto&& c = m_counters[i];
+        auto&& o = out[i];
+
+        o.reads = c.reads.load(std::memory_order_relaxed);
+        o.read_bytes = c.read_bytes.load(std::memory_order_relaxed);
+        o.read_failures = c.read_failures.load(std::memory_order_relaxed);
+        o.writes = c.writes.load(std::memory_order_relaxed);
+        o.write_bytes = c.write_bytes.load(std::memory_order_relaxed);
+        o.write_failures = c.write_failures.load(std::memory_order_relaxed);
+        o.backend_reads = c.backend_reads.load(std::memory_order_relaxed);
+        o.total_ns = c.total_ns.load(std::memory_order_relaxed);
+
+        for (size_t j = 0; j < c.histogram.size(); ++j) {
+            o.histogram[j] = c.histogram[j].load(std::memory_order_relaxed);
+        }
+    }
+
+    return out;
+}
+
+void IoStats::reset() {
+    for (auto&& c : m_counters) {
+        c.reads = 0;
+        c.read_bytes = 0;
+        c.read_failures = 0;
+        c.writes = 0;
+        c.write_bytes = 0;
+        c.write_failures = 0;
+        c.backend_reads = 0;
+        c.total_ns = 0;
+
+        for (auto&& n : c.histogram) {
+            n = 0;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// What a read/write was for. Set for the current thread with an IoScope; the innermost scope wins.
+enum class IoCategory : uint8_t {
+    OTHER,
+    NODE_REFRESH,
+    RTTI,
+    ADDRESS_RESOLVE,
+    API,
+    LUA,
+    COUNT,
+};
+
+std::string_view io_category_name(IoCategory category);
+
+class IoScope {
+public:
+    explicit IoScope(IoCategory category) : m_prev{s_current} { s_current = category; }
+    ~IoScope() { s_current = m_prev; }
+
+    IoScope(const IoScope&) = delete;
+    IoScope& operator=(const IoScope&) = delete;
+
+    static IoCategory current() { return s_current; }
+    // For threads that only ever do one kind of work.
+    static void thread_category(IoCategory category) { s_current = category; }
+
+private:
+    IoCategory m_prev{};
+    static thread_local IoCategory s_current;
+};
+
+// Per-category counters for a Process's reads and writes. When disabled the only cost is one relaxed load per call.
+class IoStats {
+public:
+    // Bucket i counts calls that took [2^i, 2^(i+1)) nanoseconds (bucket 0 also takes 0ns).
+    static constexpr size_t HISTOGRAM_BUCKETS = 36;
+
+    struct Counters {
+        // Every request of a read_batch counts as a read, the batch as a whole is one latency sample.
+        uint64_t reads{};
+        uint64_t read_bytes{};
+        uint64_t read_failures{};
+        uint64_t writes{};
+        uint64_t write_bytes{};
+        uint64_t write_failures{};
+        // Calls that made it past the caches to the backend.
+        uint64_t backend_reads{};
+        uint64_t total_ns{};
+        std::array<uint64_t, HISTOGRAM_BUCKETS> histogram{};
+
+        // Upper bound of the bucket the p-th percentile (0..1) falls in.
+        std::chrono::nanoseconds percentile(double p) const;
+    };
+
+    using Snapshot = std::array<Counters, (size_t)IoCategory::COUNT>;
+
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void enabled(bool enabled) { m_enabled = enabled; }
+
+    // Times a call and records it under the current category if enabled.
+    class Timer {
+    public:
+        explicit Timer(const IoStats& stats)
+            : m_enabled{stats.enabled()}, m_start{m_enabled ? std::chrono::steady_clock::now()
+                                                            : std::chrono::steady_clock::time_point{}} {}
+
+        bool enabled() const { return m_enabled; }
+        std::chrono::nanoseconds elapsed() const { return std::chrono::steady_clock::now() - m_start; }
+
+    private:
+        bool m_enabled{};
+        std::chrono::steady_clock::time_point m_start{};
+    };
+
+    void record_read(const Timer& timer, size_t bytes, size_t failures, size_t calls = 1);
+    void record_write(const Timer& timer, size_t bytes, bool ok);
+    void record_backend_read(size_t calls = 1) {
+        if (enabled()) {
+            m_counters[(size_t)IoScope::current()].backend_reads.fetch_add(calls, std::memory_order_relaxed);
+        }
+    }
+
+    Snapshot snapshot() const;
+    void reset();
+
+private:
+    struct AtomicCounters {
+        std::atomic<uint64_t> reads{};
+        std::atomic<uint64_t> read_bytes{};
+        std::atomic<uint64_t> read_failures{};
+        std::atomic<uint64_t> writes{};
+        std::atomic<uint64_t> write_bytes{};
+        std::atomic<uint64_t> write_failures{};
+        std::atomic<uint64_t> backend_reads{};
+        std::atomic<uint64_t> total_ns{};
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> histogram{};
+    };
+
+    std::atomic<bool> m_enabled{};
+    std::array<AtomicCounters, (size_t)IoCategory::COUNT> m_counters{};
+
+    void record_latency(AtomicCounters& c, std::chrono::nanoseconds elapsed);
+};
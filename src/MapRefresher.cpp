@@ -0,0 +1,96 @@
+#include "MapRefresher.hpp"
+
+MapRefresher::MapRefresher(Process& process, std::chrono::milliseconds interval)
+    : m_process{process}, m_interval{interval}, m_modules{process.modules()}, m_allocations{process.allocations()} {
+    m_thread = std::thread{[this] {
+        std::unique_lock lk{m_mtx};
+
+        while (!m_stop) {
+            m_cv.wait_for(lk, m_interval, [this] { return m_stop; });
+
+            if (m_stop) {
+                break;
+            }
+
+            lk.unlock();
+            refresh();
+            lk.lock();
+        }
+    }};
+}
+
+MapRefresher::~MapRefresher() {
+    {
+        std::scoped_lock _{m_mtx};
+        m_stop = true;
+    }
+
+    m_cv.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void MapRefresher::interval(std::chrono::milliseconds interval) {
+    {
+        std::scoped_lock _{m_mtx};
+        m_interval = interval;
+    }
+
+    m_cv.notify_all();
+}
+
+std::optional<MapRefresher::Update> MapRefresher::poll() {
+    std::scoped_lock _{m_mtx};
+    auto update = std::move(m_pending);
+    m_pending.reset();
+    return update;
+}
+
+MapRefresher::Stats MapRefresher::stats() const {
+    std::scoped_lock _{m_mtx};
+    return m_stats;
+}
+
+void MapRefresher::refresh() {
+    auto start = std::chrono::steady_clock::now();
+    auto snapshot = m_process.snapshot_map();
+
+    if (!snapshot) {
+        return;
+    }
+
+    auto events = Process::diff_map(m_modules, m_allocations, *snapshot);
+
+    if (!events.empty()) {
+        // Keep our own copy to diff the next refresh against, the snapshot itself is handed over.
+        m_modules = snapshot->modules;
+        m_allocations = snapshot->allocations;
+        snapshot->region_index = Process::build_region_index(snapshot->modules, snapshot->allocations);
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    std::scoped_lock _{m_mtx};
+
+    ++m_stats.refreshes;
+    m_stats.regions = m_allocations.size();
+    m_stats.last_duration = duration;
+
+    if (events.empty()) {
+        return;
+    }
+
+    ++m_stats.updates;
+
+    // Nobody picked up the last one yet, fold this one into it. The newest snapshot wins.
+    if (m_pending) {
+        m_pending->snapshot = std::move(*snapshot);
+        m_pending->events.insert(m_pending->events.end(), std::make_move_iterator(events.begin()),
+            std::make_move_iterator(events.end()));
+        return;
+    }
+
+    m_pending = Update{std::move(*snapshot), std::move(events)};
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Process.hpp"
+
+// Re-enumerates a process's memory map on a background thread and diffs it against the last one. Changes are queued
+// for the owner to publish with Process::apply_map from whichever thread owns the process.
+class MapRefresher {
+public:
+    struct Update {
+        Process::MapSnapshot snapshot{};
+        std::vector<Process::MapEvent> events{};
+    };
+
+    struct Stats {
+        size_t refreshes{};
+        size_t updates{};
+        size_t regions{};
+        std::chrono::microseconds last_duration{};
+    };
+
+    MapRefresher(Process& process, std::chrono::milliseconds interval);
+    ~MapRefresher();
+
+    MapRefresher(const MapRefresher&) = delete;
+    MapRefresher& operator=(const MapRefresher&) = delete;
+
+    void interval(std::chrono::milliseconds interval);
+
+    // Everything that changed since the last poll, merged into one update. nullopt if nothing did.
+    std::optional<Update> poll();
+
+    Stats stats() const;
+
+private:
+    Process& m_process;
+
+    mutable std::mutex m_mtx{};
+    std::condition_variable m_cv{};
+    std::chrono::milliseconds m_interval{};
+    bool m_stop{};
+
+    // What the process will look like once the pending update (if any) is applied. Only touched by the thread.
+    std::vector<Process::Module> m_modules{};
+    std::vector<Process::Allocation> m_allocations{};
+
+    std::optional<Update> m_pending{};
+    Stats m_stats{};
+    std::thread m_thread{};
+
+    void refresh();
+};
@@ -1,9 +1,11 @@
+#include <algorithm>
 #include <array>
 
 #include <fmt/format.h>
 #include <imgui.h>
 #include <imgui_internal.h>
 
+#include "backend/TimelineProcess.hpp"
 #include "node/Pointer.hpp"
 
 #include "MemoryUi.hpp"
@@ -25,6 +27,8 @@ MemoryUi::MemoryUi(
 }
 
 void MemoryUi::display(uintptr_t address) {
+    timeline_ui();
+    freeze_ui();
     m_header.clear();
 
     auto needs_space = false;
@@ -69,8 +73,117 @@ void MemoryUi::display(uintptr_t address) {
     ImGui::TextColored({0.6f, 0.6f, 0.6f, 1.0f}, "%s", m_header.c_str());
 
     if (m_root != nullptr) {
+        IoScope _{IoCategory::NODE_REFRESH};
+
+        auto frozen = freeze();
+
         ImGui::BeginChild("MemoryUiRoot", ImGui::GetContentRegionAvail());
         m_root->display(address, 0, (std::byte*)&address);
         ImGui::EndChild();
+
+        if (frozen) {
+            m_process.thaw();
+        }
+
+        node::Base::refresh_now.reset();
+    }
+}
+
+bool MemoryUi::freeze() {
+    if (!m_cfg.consistent_reads) {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+
+    if (now < m_next_freeze) {
+        node::Base::refresh_now = false;
+        return false;
+    }
+
+    m_next_freeze = now + std::chrono::milliseconds{m_cfg.refresh_rate};
+
+    // Where every expanded pointer read from last time. A pointer that changed since then reads its new target live,
+    // one frame of tearing for that node only, and is part of the next freeze.
+    std::vector<std::pair<uintptr_t, size_t>> ranges{};
+
+    m_root->collect_reads(ranges);
+    m_process.freeze(std::move(ranges));
+    node::Base::refresh_now = true;
+
+    return true;
+}
+
+void MemoryUi::freeze_ui() {
+    if (!m_cfg.consistent_reads) {
+        return;
+    }
+
+    auto summary = m_process.freeze_summary();
+
+    if (summary.count == 0) {
+        ImGui::TextUnformatted("Consistent reads: waiting for the first refresh...");
+        return;
+    }
+
+    auto&& last = summary.last;
+    auto us = [](std::chrono::nanoseconds ns) { return ns.count() / 1000.0f; };
+
+    ImGui::TextColored(last.suspended ? ImVec4{0.6f, 0.6f, 0.6f, 1.0f} : ImVec4{1.0f, 0.6f, 0.2f, 1.0f},
+        "Consistent reads: %s %.0fus (max %.0fus), %zu ranges, %zu bytes", last.suspended ? "paused" : "not paused,",
+        us(last.pause), us(summary.max_pause), last.ranges, last.bytes);
+
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Everything the visible nodes read is copied in one batch while the target is stopped.\n"
+                          "%s\nFailed ranges: %zu Freezes: %zu",
+            last.suspended ? "The pause is how long the target was stopped for."
+                           : "This backend can't stop the target, the batch still narrows the window for torn reads.",
+            last.failed, summary.count);
+    }
+}
+
+void MemoryUi::timeline_ui() {
+    auto timeline = dynamic_cast<TimelineProcess*>(&m_process);
+
+    if (timeline == nullptr) {
+        return;
+    }
+
+    auto points = timeline->timeline().points();
+
+    if (points.empty()) {
+        ImGui::TextUnformatted("Timeline: waiting for the first capture...");
+        return;
+    }
+
+    // The slider runs over positions, one past the last point is the live process. The selection itself is a point id
+    // so it stays on the same capture as older points are dropped.
+    auto live = (int)points.size();
+    auto selected = live;
+
+    if (auto point = timeline->point(); point != TimelineProcess::LIVE) {
+        auto it = std::lower_bound(
+            points.begin(), points.end(), point, [](auto&& p, uint64_t id) { return p.id < id; });
+
+        selected = (int)(it - points.begin());
+
+        // The selected point was dropped, pin it to the oldest one left instead.
+        if (it == points.end() || it->id != point) {
+            selected = 0;
+            timeline->point(points.front().id);
+        }
+    }
+
+    auto label = std::string{"Live"};
+
+    if (selected != live) {
+        auto age = std::chrono::duration<float>{std::chrono::system_clock::now() - points[selected].time};
+        label = fmt::format("#{} ({:.1f}s ago)", points[selected].id, age.count());
+    }
+
+    ImGui::SetNextItemWidth(-1.0f);
+
+    if (ImGui::SliderInt("##Timeline", &selected, 0, live, label.c_str())) {
+        timeline->point(selected == live ? TimelineProcess::LIVE : points[selected].id);
     }
 }
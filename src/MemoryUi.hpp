@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <unordered_map>
@@ -33,4 +34,15 @@ private:
     node::Property m_props;
 
     std::string m_header{};
+
+    // When the next consistent read is due.
+    std::chrono::steady_clock::time_point m_next_freeze{};
+
+    // In consistent read mode: freezes everything the visible tree read last time once per refresh and tells the nodes
+    // whether this is the frame to re-read it. Returns true if the process needs thawing after the tree is displayed.
+    bool freeze();
+    void freeze_ui();
+
+    // Scrubber over the captured points when the process is a TimelineProcess.
+    void timeline_ui();
 };
\ No newline at end of file
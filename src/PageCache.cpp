@@ -0,0 +1,431 @@
+#include <cstring>
+
+#include "PageCache.hpp"
+
+bool ReadOnlyPageCache::read(uintptr_t address, void* buffer, size_t size, const FillFn& fill) {
+    auto first_page = address & ~(PAGE_SIZE - 1);
+    auto last_page = (address + size - 1) & ~(PAGE_SIZE - 1);
+
+    if (size == 0 || last_page < first_page) {
+        return false;
+    }
+
+    std::vector<uintptr_t> missing{};
+
+    {
+        std::scoped_lock _{m_mtx};
+
+        for (auto page_address = first_page;; page_address += PAGE_SIZE) {
+            if (auto search = m_pages.find(page_address); search != m_pages.end()) {
+                m_lru.splice(m_lru.begin(), m_lru, search->second.lru);
+                ++m_stats.hits;
+            } else if (!fill) {
+                // Peeking (try_read).
+                return false;
+            } else {
+                missing.emplace_back(page_address);
+                ++m_stats.misses;
+            }
+
+            if (page_address == last_page) {
+                break;
+            }
+        }
+    }
+
+    // Filled without the lock so a slow backend read doesn't hold up every other reader. Every page is filled before
+    // copying anything so an unreadable page leaves the buffer untouched.
+    std::vector<std::unique_ptr<Page>> filled(missing.size());
+
+    for (size_t i = 0; i < missing.size(); ++i) {
+        filled[i] = std::make_unique<Page>();
+
+        if (!fill(missing[i], filled[i]->data())) {
+            return false;
+        }
+    }
+
+    std::scoped_lock _{m_mtx};
+    auto out = (std::byte*)buffer;
+    auto next_filled = missing.begin();
+
+    for (auto page_address = first_page;; page_address += PAGE_SIZE) {
+        const Page* page{};
+
+        if (next_filled != missing.end() && *next_filled == page_address) {
+            page = filled[next_filled++ - missing.begin()].get();
+        } else if (auto search = m_pages.find(page_address); search != m_pages.end()) {
+            page = search->second.page.get();
+        } else {
+            // Evicted by someone else's inserts while we were filling, the caller reads it directly instead.
+            return false;
+        }
+
+        auto begin = std::max(address, page_address);
+        auto end = std::min(address + size, page_address + PAGE_SIZE);
+
+        memcpy(out + (begin - address), page->data() + (begin - page_address), end - begin);
+
+        if (page_address == last_page) {
+            break;
+        }
+    }
+
+    // Inserted after copying so they can't evict pages this read still needed. If another reader filled the same page
+    // meanwhile its copy stays, the memory is read-only so both are the same.
+    for (size_t i = 0; i < missing.size(); ++i) {
+        if (!m_pages.contains(missing[i])) {
+            insert_page(missing[i], std::move(filled[i]));
+        }
+    }
+
+    return true;
+}
+
+void ReadOnlyPageCache::insert(uintptr_t page_address, const std::byte* data) {
+    std::scoped_lock _{m_mtx};
+
+    if (auto search = m_pages.find(page_address); search != m_pages.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, search->second.lru);
+        return;
+    }
+
+    auto page = std::make_unique<Page>();
+    memcpy(page->data(), data, PAGE_SIZE);
+    insert_page(page_address, std::move(page));
+}
+
+const ReadOnlyPageCache::Page* ReadOnlyPageCache::insert_page(uintptr_t page_address, std::unique_ptr<Page> page) {
+    evict_to(m_budget > PAGE_SIZE ? m_budget - PAGE_SIZE : 0);
+
+    m_lru.push_front(page_address);
+
+    auto&& entry = m_pages[page_address];
+    entry.page = std::move(page);
+    entry.lru = m_lru.begin();
+    m_stats.bytes += PAGE_SIZE;
+
+    return entry.page.get();
+}
+
+void ReadOnlyPageCache::evict_to(size_t budget) {
+    while (m_stats.bytes > budget && !m_lru.empty()) {
+        m_pages.erase(m_lru.back());
+        m_lru.pop_back();
+        m_stats.bytes -= PAGE_SIZE;
+        ++m_stats.evictions;
+    }
+}
+
+void ReadOnlyPageCache::budget(size_t budget) {
+    std::scoped_lock _{m_mtx};
+    m_budget = budget;
+    evict_to(m_budget);
+}
+
+void ReadOnlyPageCache::invalidate(uintptr_t start, uintptr_t end) {
+    std::scoped_lock _{m_mtx};
+
+    // Walk whichever side is smaller.
+    if ((end - start) / PAGE_SIZE < m_pages.size()) {
+        for (auto page_address = start & ~(PAGE_SIZE - 1); page_address < end; page_address += PAGE_SIZE) {
+            if (auto search = m_pages.find(page_address); search != m_pages.end()) {
+                m_lru.erase(search->second.lru);
+                m_pages.erase(search);
+                m_stats.bytes -= PAGE_SIZE;
+            }
+        }
+    } else {
+        for (auto it = m_pages.begin(); it != m_pages.end();) {
+            if (it->first + PAGE_SIZE > start && it->first < end) {
+                m_lru.erase(it->second.lru);
+                it = m_pages.erase(it);
+                m_stats.bytes -= PAGE_SIZE;
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void ReadOnlyPageCache::clear() {
+    std::scoped_lock _{m_mtx};
+    m_pages.clear();
+    m_lru.clear();
+    m_stats.bytes = 0;
+}
+
+ReadOnlyPageCache::Stats ReadOnlyPageCache::stats() const {
+    std::scoped_lock _{m_mtx};
+    return m_stats;
+}
+
+bool EpochPageCache::read(uintptr_t address, void* buffer, size_t size, const FillFn& fill) {
+    std::vector<uintptr_t> missing{};
+    size_t page_size{};
+    uint64_t epoch{};
+    uint64_t generation{};
+    uintptr_t first_page{};
+    uintptr_t last_page{};
+
+    {
+        std::scoped_lock _{m_mtx};
+
+        page_size = m_page_size;
+        epoch = m_epoch;
+        generation = m_generation;
+        first_page = address & ~(page_size - 1);
+        last_page = (address + size - 1) & ~(page_size - 1);
+
+        if (size == 0 || last_page < first_page) {
+            return false;
+        }
+
+        for (auto page_address = first_page;; page_address += page_size) {
+            if (auto search = m_pages.find(page_address); search != m_pages.end() && search->second.epoch == epoch) {
+                ++m_stats.hits;
+            } else if (!fill) {
+                // Peeking (try_read).
+                return false;
+            } else {
+                missing.emplace_back(page_address);
+                ++m_stats.misses;
+            }
+
+            if (page_address == last_page) {
+                break;
+            }
+        }
+    }
+
+    // Filled without the lock so a slow backend read doesn't hold up every other reader.
+    std::vector<std::vector<std::byte>> filled(missing.size());
+
+    for (size_t i = 0; i < missing.size(); ++i) {
+        filled[i].resize(page_size);
+
+        if (!fill(missing[i], filled[i].data(), page_size)) {
+            return false;
+        }
+    }
+
+    std::scoped_lock _{m_mtx};
+
+    // The page size changed under us, whatever we counted as cached is gone.
+    if (page_size != m_page_size) {
+        return false;
+    }
+
+    auto out = (std::byte*)buffer;
+    auto next_filled = missing.begin();
+
+    for (auto page_address = first_page;; page_address += page_size) {
+        const std::byte* page{};
+
+        if (next_filled != missing.end() && *next_filled == page_address) {
+            page = filled[next_filled++ - missing.begin()].data();
+        } else if (auto search = m_pages.find(page_address); search != m_pages.end() && search->second.epoch == epoch) {
+            page = search->second.page.data();
+        } else {
+            // Invalidated or dropped while we were filling, the caller reads it directly instead.
+            return false;
+        }
+
+        auto begin = std::max(address, page_address);
+        auto end = std::min(address + size, page_address + page_size);
+
+        memcpy(out + (begin - address), page + (begin - page_address), end - begin);
+
+        if (page_address == last_page) {
+            break;
+        }
+    }
+
+    // Something was invalidated while we were filling, our pages may predate a write. The caller still gets them (its
+    // read raced the write anyway), later readers fill again.
+    if (generation != m_generation) {
+        return true;
+    }
+
+    if (m_pages.size() + missing.size() > MAX_PAGES) {
+        m_pages.clear();
+    }
+
+    // Tagged with the epoch the read started in, so an epoch advanced meanwhile still refetches them. A page another
+    // reader already filled for this epoch is kept.
+    for (size_t i = 0; i < missing.size(); ++i) {
+        auto&& entry = m_pages[missing[i]];
+
+        if (entry.epoch != m_epoch || entry.page.empty()) {
+            entry.page = std::move(filled[i]);
+            entry.epoch = epoch;
+        }
+    }
+
+    return true;
+}
+
+EpochPageCache::Stamp EpochPageCache::stamp() const {
+    std::scoped_lock _{m_mtx};
+    return {m_epoch, m_generation};
+}
+
+void EpochPageCache::insert(uintptr_t page_address, const std::byte* page, size_t page_size, Stamp stamp) {
+    std::scoped_lock _{m_mtx};
+
+    if (page_size != m_page_size || stamp.epoch != m_epoch || stamp.generation != m_generation) {
+        return;
+    }
+
+    if (m_pages.size() >= MAX_PAGES && !m_pages.contains(page_address)) {
+        m_pages.clear();
+    }
+
+    auto&& entry = m_pages[page_address];
+
+    entry.page.assign(page, page + page_size);
+    entry.epoch = m_epoch;
+}
+
+void EpochPageCache::advance_epoch() {
+    std::scoped_lock _{m_mtx};
+    ++m_epoch;
+}
+
+void EpochPageCache::invalidate(uintptr_t start, uintptr_t end) {
+    std::scoped_lock _{m_mtx};
+
+    ++m_generation;
+
+    // Walk whichever side is smaller, a reservation that went away can span far more pages than we hold.
+    if ((end - start) / m_page_size < m_pages.size()) {
+        for (auto page_address = start & ~(m_page_size - 1); page_address < end; page_address += m_page_size) {
+            if (auto search = m_pages.find(page_address); search != m_pages.end() && search->second.epoch == m_epoch) {
+                search->second.epoch = 0;
+                ++m_stats.invalidations;
+            }
+        }
+    } else {
+        for (auto&& [page_address, entry] : m_pages) {
+            if (page_address + m_page_size > start && page_address < end && entry.epoch == m_epoch) {
+                entry.epoch = 0;
+                ++m_stats.invalidations;
+            }
+        }
+    }
+}
+
+void EpochPageCache::page_size(size_t page_size) {
+    std::scoped_lock _{m_mtx};
+
+    if (page_size == 0 || (page_size & (page_size - 1)) != 0) {
+        return;
+    }
+
+    m_page_size = page_size;
+    m_pages.clear();
+}
+
+EpochPageCache::Stats EpochPageCache::stats() const {
+    std::scoped_lock _{m_mtx};
+    auto stats = m_stats;
+    stats.epoch = m_epoch;
+    return stats;
+}
+
+void EpochPageCache::reset_stats() {
+    std::scoped_lock _{m_mtx};
+    m_stats = {};
+}
+
+bool UnreadablePageCache::contains(uintptr_t address, size_t size) {
+    if (m_count.load(std::memory_order_relaxed) == 0 || size == 0) {
+        return false;
+    }
+
+    std::scoped_lock _{m_mtx};
+
+    auto now = Clock::now();
+    auto last_page = (address + size - 1) & ~(PAGE_SIZE - 1);
+
+    for (auto page_address = address & ~(PAGE_SIZE - 1);; page_address += PAGE_SIZE) {
+        if (auto search = m_pages.find(page_address); search != m_pages.end()) {
+            if (search->second > now) {
+                ++m_stats.rejections;
+                return true;
+            }
+
+            m_pages.erase(search);
+            m_count = m_pages.size();
+        }
+
+        if (page_address >= last_page) {
+            break;
+        }
+    }
+
+    return false;
+}
+
+void UnreadablePageCache::insert(uintptr_t address, size_t size) {
+    auto page_address = address & ~(PAGE_SIZE - 1);
+
+    if (size == 0 || ((address + size - 1) & ~(PAGE_SIZE - 1)) != page_address) {
+        return;
+    }
+
+    std::scoped_lock _{m_mtx};
+
+    if (m_ttl.count() <= 0) {
+        return;
+    }
+
+    auto now = Clock::now();
+
+    if (m_pages.size() >= MAX_PAGES) {
+        std::erase_if(m_pages, [now](auto&& kv) { return kv.second <= now; });
+
+        // Everything is still fresh, start over rather than tracking age order.
+        if (m_pages.size() >= MAX_PAGES) {
+            m_pages.clear();
+        }
+    }
+
+    m_pages[page_address] = now + m_ttl;
+    m_count = m_pages.size();
+    ++m_stats.insertions;
+}
+
+void UnreadablePageCache::invalidate(uintptr_t start, uintptr_t end) {
+    if (m_count.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    std::scoped_lock _{m_mtx};
+
+    std::erase_if(m_pages, [start, end](auto&& kv) { return kv.first + PAGE_SIZE > start && kv.first < end; });
+    m_count = m_pages.size();
+}
+
+void UnreadablePageCache::clear() {
+    std::scoped_lock _{m_mtx};
+    m_pages.clear();
+    m_count = 0;
+}
+
+void UnreadablePageCache::ttl(std::chrono::milliseconds ttl) {
+    std::scoped_lock _{m_mtx};
+    m_ttl = ttl;
+
+    if (m_ttl.count() <= 0) {
+        m_pages.clear();
+        m_count = 0;
+    }
+}
+
+UnreadablePageCache::Stats UnreadablePageCache::stats() const {
+    std::scoped_lock _{m_mtx};
+    auto stats = m_stats;
+    stats.pages = m_pages.size();
+    return stats;
+}
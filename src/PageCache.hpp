@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Page-granular cache for memory that can't change (read-only allocations). Pages are filled the first time they're
+// read and evicted least-recently-used first once the cache grows past its budget.
+class ReadOnlyPageCache {
+public:
+    static constexpr size_t PAGE_SIZE = 0x1000;
+
+    using Page = std::array<std::byte, PAGE_SIZE>;
+    // Reads PAGE_SIZE bytes of the target at a page aligned address.
+    using FillFn = std::function<bool(uintptr_t page_address, std::byte* page)>;
+
+    struct Stats {
+        size_t hits{};
+        size_t misses{};
+        size_t evictions{};
+        size_t bytes{};
+    };
+
+    explicit ReadOnlyPageCache(size_t budget = 256 * 1024 * 1024) : m_budget{budget} {}
+
+    // Returns false if any page covering [address, address + size) couldn't be filled.
+    bool read(uintptr_t address, void* buffer, size_t size, const FillFn& fill);
+    // Only succeeds if every page is already cached.
+    bool try_read(uintptr_t address, void* buffer, size_t size) { return read(address, buffer, size, {}); }
+    // For pages read elsewhere (batched reads).
+    void insert(uintptr_t page_address, const std::byte* page);
+
+    // Reads larger than this bypass the cache so one big read can't flush everything else out.
+    bool should_cache(size_t size) const { return size <= m_budget / 4; }
+
+    void budget(size_t budget);
+    size_t budget() const { return m_budget; }
+
+    // Drops any cached pages overlapping [start, end).
+    void invalidate(uintptr_t start, uintptr_t end);
+    void clear();
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::unique_ptr<Page> page{};
+        std::list<uintptr_t>::iterator lru{};
+    };
+
+    mutable std::mutex m_mtx{};
+    size_t m_budget{};
+    std::unordered_map<uintptr_t, Entry> m_pages{};
+    // Most recently used at the front.
+    std::list<uintptr_t> m_lru{};
+    Stats m_stats{};
+
+    const Page* insert_page(uintptr_t page_address, std::unique_ptr<Page> page);
+    void evict_to(size_t budget);
+};
+
+// Short-lived page cache for writable memory. Every reader within the same epoch (one refresh tick) shares a single
+// read of each page; advancing the epoch makes everything cached so far stale.
+class EpochPageCache {
+public:
+    using FillFn = std::function<bool(uintptr_t page_address, std::byte* page, size_t page_size)>;
+
+    struct Stats {
+        size_t hits{};
+        size_t misses{};
+        size_t invalidations{};
+        uint64_t epoch{};
+    };
+
+    explicit EpochPageCache(size_t page_size = 0x1000) : m_page_size{page_size} {}
+
+    bool read(uintptr_t address, void* buffer, size_t size, const FillFn& fill);
+    // Only succeeds if every page was already read this epoch.
+    bool try_read(uintptr_t address, void* buffer, size_t size) { return read(address, buffer, size, {}); }
+    // Where the cache was when a read started, see insert().
+    struct Stamp {
+        uint64_t epoch{};
+        uint64_t generation{};
+    };
+
+    // Take this before reading pages elsewhere (batched reads) and hand it to insert() with them.
+    Stamp stamp() const;
+    // For pages read elsewhere. Ignored if page_size doesn't match the current page size, or if the epoch advanced or
+    // something was invalidated since stamp was taken: the page may predate a write and would pass for current.
+    void insert(uintptr_t page_address, const std::byte* page, size_t page_size, Stamp stamp);
+
+    // Reads spanning more than a handful of pages aren't worth copying twice.
+    bool should_cache(size_t size) const { return m_enabled && size <= m_page_size * 4; }
+
+    void advance_epoch();
+    void invalidate(uintptr_t start, uintptr_t end);
+
+    // Must be a power of two. Changing it drops everything cached.
+    void page_size(size_t page_size);
+    size_t page_size() const { return m_page_size; }
+
+    void enabled(bool enabled) { m_enabled = enabled; }
+    bool enabled() const { return m_enabled; }
+
+    Stats stats() const;
+    void reset_stats();
+
+private:
+    struct Entry {
+        uint64_t epoch{};
+        std::vector<std::byte> page{};
+    };
+
+    // Stale pages are kept around until refilled. Past this many we start over.
+    static constexpr size_t MAX_PAGES = 4096;
+
+    mutable std::mutex m_mtx{};
+    size_t m_page_size{};
+    bool m_enabled{true};
+    uint64_t m_epoch{1};
+    // Bumped by every invalidate(). A fill that saw it change may hold bytes from before a write and isn't stored.
+    uint64_t m_generation{};
+    std::unordered_map<uintptr_t, Entry> m_pages{};
+    Stats m_stats{};
+};
+
+// Pages reads recently failed on. Garbage pointers, RTTI probes and sweeps tend to hit the same unmapped pages over and
+// over; remembering them for a short while lets those reads fail without a syscall.
+class UnreadablePageCache {
+public:
+    static constexpr size_t PAGE_SIZE = 0x1000;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        size_t rejections{};
+        size_t insertions{};
+        size_t pages{};
+    };
+
+    explicit UnreadablePageCache(std::chrono::milliseconds ttl = std::chrono::milliseconds{250}) : m_ttl{ttl} {}
+
+    // True if any page of [address, address + size) failed to read within the TTL.
+    bool contains(uintptr_t address, size_t size);
+    // Only failures confined to one page are recorded, a larger failed read doesn't tell us which page was at fault.
+    void insert(uintptr_t address, size_t size);
+
+    void invalidate(uintptr_t start, uintptr_t end);
+    void clear();
+
+    // 0 disables the cache.
+    void ttl(std::chrono::milliseconds ttl);
+    std::chrono::milliseconds ttl() const { return m_ttl; }
+
+    Stats stats() const;
+
+private:
+    static constexpr size_t MAX_PAGES = 8192;
+
+    mutable std::mutex m_mtx{};
+    std::chrono::milliseconds m_ttl{};
+    // Page address -> expiry.
+    std::unordered_map<uintptr_t, Clock::time_point> m_pages{};
+    // Lets contains() skip the lock in the common case of nothing being unreadable.
+    std::atomic<size_t> m_count{};
+    Stats m_stats{};
+};
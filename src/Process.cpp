@@ -1,27 +1,571 @@
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <utility>
+
 #include "Process.hpp"
 
+Process::CachePath Process::cache_path(uintptr_t address, size_t size) const {
+    if (m_mapped) {
+        return CachePath::NONE;
+    }
+
+    // The read has to stay inside one allocation so pages of a read-only allocation are never mixed up with pages of
+    // a neighbouring writable one.
+    auto i = m_region_index->allocation_within(address);
+
+    if (i == RegionIndex::npos || size > m_allocations[i].end - address) {
+        return CachePath::NONE;
+    }
+
+    if (!m_allocations[i].write) {
+        // If we're reading from read-only memory we can use the cached version since it hasn't changed.
+        return m_read_only_cache.should_cache(size) ? CachePath::READ_ONLY : CachePath::NONE;
+    }
+
+    // Writable memory is only good until the end of the current refresh epoch.
+    return m_epoch_cache.should_cache(size) ? CachePath::EPOCH : CachePath::NONE;
+}
+
+bool Process::read_uncached(uintptr_t address, void* buffer, size_t size) {
+    m_io_stats.record_backend_read();
+
+    if (handle_read(address, buffer, size)) {
+        return true;
+    }
+
+    m_unreadable_cache.insert(address, size);
+    return false;
+}
+
 bool Process::read(uintptr_t address, void* buffer, size_t size) {
-    // If we're reading from read-only memory we can just use the cached version since it hasn't changed.
-    for (auto&& ro_allocation : m_read_only_allocations) {
-        if (ro_allocation.start <= address && address + size <= ro_allocation.end &&
-            ro_allocation.mem.size() == ro_allocation.size) {
-            auto offset = address - ro_allocation.start;
+    IoStats::Timer timer{m_io_stats};
+    auto result = read_cached(address, buffer, size);
 
-            // two incase the size causes overflow
-            if (offset >= ro_allocation.mem.size() || offset + size >= ro_allocation.mem.size()) {
-                return false;
-            }
+    m_io_stats.record_read(timer, size, result ? 0 : 1);
+
+    return result;
+}
 
-            memcpy(buffer, ro_allocation.mem.data() + offset, size);
+bool Process::read_direct(uintptr_t address, void* buffer, size_t size) {
+    IoStats::Timer timer{m_io_stats};
+    auto result = read_uncached(address, buffer, size);
+
+    m_io_stats.record_read(timer, size, result ? 0 : 1);
+
+    return result;
+}
+
+bool Process::read_cached(uintptr_t address, void* buffer, size_t size) {
+    if (read_frozen(address, buffer, size)) {
+        return true;
+    }
+
+    if (m_unreadable_cache.contains(address, size)) {
+        return false;
+    }
+
+    switch (cache_path(address, size)) {
+    case CachePath::READ_ONLY: {
+        auto fill = [this](uintptr_t page_address, std::byte* page) {
+            return read_uncached(page_address, page, ReadOnlyPageCache::PAGE_SIZE);
+        };
+
+        if (m_read_only_cache.read(address, buffer, size, fill)) {
             return true;
         }
+    } break;
+
+    case CachePath::EPOCH: {
+        auto fill = [this](uintptr_t page_address, std::byte* page, size_t page_size) {
+            return read_uncached(page_address, page, page_size);
+        };
+
+        if (m_epoch_cache.read(address, buffer, size, fill)) {
+            return true;
+        }
+    } break;
+
+    default:
+        break;
+    }
+
+    return read_uncached(address, buffer, size);
+}
+
+size_t Process::read_batch(std::span<ReadRequest> requests) {
+    IoStats::Timer timer{m_io_stats};
+    // Requests that can be served from the page caches turn into page reads so that everything read here is shared
+    // with later read() calls, the rest are passed straight through to the backend.
+    std::set<uintptr_t> ro_pages{};
+    std::set<uintptr_t> epoch_pages{};
+    std::vector<size_t> direct{};
+    std::vector<size_t> pending{};
+    auto epoch_page_size = m_epoch_cache.page_size();
+
+    auto add_pages = [](std::set<uintptr_t>& pages, uintptr_t address, size_t size, size_t page_size) {
+        for (auto page = address & ~(page_size - 1); page < address + size; page += page_size) {
+            pages.emplace(page);
+        }
+    };
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto&& r = requests[i];
+
+        r.ok = false;
+
+        if (r.size == 0 || read_frozen(r.address, r.buffer, r.size)) {
+            r.ok = true;
+            continue;
+        }
+
+        if (m_unreadable_cache.contains(r.address, r.size)) {
+            continue;
+        }
+
+        switch (cache_path(r.address, r.size)) {
+        case CachePath::READ_ONLY:
+            if (!(r.ok = m_read_only_cache.try_read(r.address, r.buffer, r.size))) {
+                add_pages(ro_pages, r.address, r.size, ReadOnlyPageCache::PAGE_SIZE);
+                pending.emplace_back(i);
+            }
+            break;
+
+        case CachePath::EPOCH:
+            if (!(r.ok = m_epoch_cache.try_read(r.address, r.buffer, r.size))) {
+                add_pages(epoch_pages, r.address, r.size, epoch_page_size);
+                pending.emplace_back(i);
+            }
+            break;
+
+        default:
+            direct.emplace_back(i);
+            break;
+        }
     }
 
-    return handle_read(address, buffer, size);
+    if (!direct.empty() || !pending.empty()) {
+        std::vector<std::byte> page_mem(
+            ro_pages.size() * ReadOnlyPageCache::PAGE_SIZE + epoch_pages.size() * epoch_page_size);
+        std::vector<ReadRequest> backend_requests{};
+        auto page_mem_it = page_mem.data();
+
+        backend_requests.reserve(ro_pages.size() + epoch_pages.size() + direct.size());
+
+        for (auto page : ro_pages) {
+            backend_requests.emplace_back(page, page_mem_it, ReadOnlyPageCache::PAGE_SIZE);
+            page_mem_it += ReadOnlyPageCache::PAGE_SIZE;
+        }
+
+        for (auto page : epoch_pages) {
+            backend_requests.emplace_back(page, page_mem_it, epoch_page_size);
+            page_mem_it += epoch_page_size;
+        }
+
+        for (auto i : direct) {
+            backend_requests.emplace_back(requests[i].address, requests[i].buffer, requests[i].size);
+        }
+
+        // Taken before the backend read so pages that raced an epoch advance or a write aren't cached as current.
+        auto epoch_stamp = m_epoch_cache.stamp();
+
+        m_io_stats.record_backend_read(backend_requests.size());
+        handle_read_batch(backend_requests);
+
+        for (auto&& r : backend_requests) {
+            if (!r.ok) {
+                m_unreadable_cache.insert(r.address, r.size);
+            }
+        }
+
+        auto it = backend_requests.begin();
+
+        for (size_t n = 0; n < ro_pages.size(); ++n, ++it) {
+            if (it->ok) {
+                m_read_only_cache.insert(it->address, (const std::byte*)it->buffer);
+            }
+        }
+
+        for (size_t n = 0; n < epoch_pages.size(); ++n, ++it) {
+            if (it->ok) {
+                m_epoch_cache.insert(it->address, (const std::byte*)it->buffer, epoch_page_size, epoch_stamp);
+            }
+        }
+
+        for (auto i : direct) {
+            requests[i].ok = (it++)->ok;
+        }
+
+        // Pending requests are cache hits now. Whatever didn't make it into the caches (unreadable pages, a tiny cache
+        // budget) goes through a normal read.
+        for (auto i : pending) {
+            auto&& r = requests[i];
+            r.ok = read_cached(r.address, r.buffer, r.size);
+        }
+    }
+
+    auto ok = (size_t)std::count_if(requests.begin(), requests.end(), [](auto&& r) { return r.ok; });
+
+    if (timer.enabled()) {
+        size_t bytes{};
+
+        for (auto&& r : requests) {
+            bytes += r.size;
+        }
+
+        m_io_stats.record_read(timer, bytes, requests.size() - ok, requests.size());
+    }
+
+    return ok;
+}
+
+void Process::handle_read_batch(std::span<ReadRequest> requests) {
+    for (auto&& r : requests) {
+        r.ok = handle_read(r.address, r.buffer, r.size);
+    }
+}
+
+bool Process::read_frozen(uintptr_t address, void* buffer, size_t size) {
+    if (!m_has_frozen.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    std::shared_ptr<const Frozen> frozen{};
+
+    {
+        std::scoped_lock _{m_frozen_mtx};
+        frozen = m_frozen;
+    }
+
+    if (frozen == nullptr) {
+        return false;
+    }
+
+    auto&& ranges = frozen->ranges;
+    auto it = std::upper_bound(
+        ranges.begin(), ranges.end(), address, [](uintptr_t addr, auto&& range) { return addr < range.start; });
+
+    if (it == ranges.begin()) {
+        return false;
+    }
+
+    --it;
+
+    if (address + size < address || address + size > it->end) {
+        return false;
+    }
+
+    memcpy(buffer, frozen->data.data() + it->offset + (address - it->start), size);
+    return true;
+}
+
+Process::FreezeStats Process::freeze(std::vector<std::pair<uintptr_t, size_t>> ranges) {
+    FreezeStats stats{};
+
+    thaw();
+
+    // Overlapping ranges (two pointers to the same object, an object inside an expanded array) are read once.
+    std::erase_if(ranges, [](auto&& r) { return r.second == 0 || r.first + r.second < r.first; });
+    std::sort(ranges.begin(), ranges.end());
+
+    auto frozen = std::make_shared<Frozen>();
+    size_t total{};
+
+    for (auto&& [start, size] : ranges) {
+        auto end = start + size;
+
+        if (!frozen->ranges.empty() && start < frozen->ranges.back().end) {
+            auto&& last = frozen->ranges.back();
+
+            if (end > last.end) {
+                total += end - last.end;
+                last.end = end;
+            }
+
+            continue;
+        }
+
+        frozen->ranges.emplace_back(start, end, total);
+        total += size;
+    }
+
+    // Nothing to read, don't stop the target for nothing.
+    if (frozen->ranges.empty()) {
+        return stats;
+    }
+
+    frozen->data.resize(total);
+
+    std::vector<ReadRequest> requests{};
+
+    requests.reserve(frozen->ranges.size());
+
+    for (auto&& r : frozen->ranges) {
+        requests.emplace_back(r.start, frozen->data.data() + r.offset, r.end - r.start);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto pause = handle_read_batch_suspended(requests);
+
+    stats.suspended = pause.has_value();
+    stats.pause = pause.value_or(std::chrono::steady_clock::now() - start);
+    m_io_stats.record_backend_read(requests.size());
+
+    // Failed ranges are dropped so reads of them go to the target like usual.
+    size_t kept{};
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (requests[i].ok) {
+            frozen->ranges[kept++] = frozen->ranges[i];
+            stats.bytes += requests[i].size;
+        } else {
+            ++stats.failed;
+        }
+    }
+
+    frozen->ranges.resize(kept);
+    stats.ranges = requests.size();
+
+    {
+        std::scoped_lock _{m_frozen_mtx};
+        m_frozen = std::move(frozen);
+        m_freeze_summary.last = stats;
+        ++m_freeze_summary.count;
+        m_freeze_summary.max_pause = std::max(m_freeze_summary.max_pause, stats.pause);
+        m_freeze_summary.total_pause += stats.pause;
+    }
+
+    m_has_frozen = true;
+
+    return stats;
+}
+
+std::optional<std::chrono::nanoseconds> Process::handle_read_batch_suspended(std::span<ReadRequest> requests) {
+    // Everything between suspend() and resume() is the pause the target sees, keep it to the one batch.
+    auto start = std::chrono::steady_clock::now();
+
+    if (!suspend()) {
+        handle_read_batch(requests);
+        return std::nullopt;
+    }
+
+    handle_read_batch(requests);
+    resume();
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+void Process::thaw() {
+    m_has_frozen = false;
+
+    std::scoped_lock _{m_frozen_mtx};
+    m_frozen.reset();
+}
+
+Process::FreezeSummary Process::freeze_summary() const {
+    std::scoped_lock _{m_frozen_mtx};
+    return m_freeze_summary;
 }
 
 bool Process::write(uintptr_t address, const void* buffer, size_t size) {
-    return handle_write(address, buffer, size);
+    IoStats::Timer timer{m_io_stats};
+    auto result = handle_write(address, buffer, size);
+
+    m_io_stats.record_write(timer, size, result);
+
+    // The frozen copy would keep showing the old value.
+    if (m_has_frozen.load(std::memory_order_relaxed)) {
+        thaw();
+    }
+
+    // Invalidate even if the write failed, part of it may have gone through.
+    m_epoch_cache.invalidate(address, address + size);
+    m_read_only_cache.invalidate(address, address + size);
+
+    return result;
+}
+
+std::optional<std::string> Process::get_typename(uintptr_t ptr) {
+    if (ptr == 0 || (!has_rtti() && m_rtti_catalog.empty())) {
+        return std::nullopt;
+    }
+
+    IoScope _{IoCategory::RTTI};
+    auto vtable = read<uintptr_t>(ptr);
+
+    if (!vtable) {
+        return std::nullopt;
+    }
+
+    return get_typename_from_vtable(*vtable);
+}
+
+std::optional<std::string> Process::get_typename_from_vtable(uintptr_t vtable) {
+    if (vtable == 0) {
+        return std::nullopt;
+    }
+
+    // A catalog knows every vtable of its module, so it's the final word even for backends without RTTI of their own.
+    if (auto cataloged = m_rtti_catalog.find_name(vtable)) {
+        return *cataloged;
+    }
+
+    if (!has_rtti()) {
+        return std::nullopt;
+    }
+
+    // Vtables live in a module's image. Most of what sweeps hand us doesn't, and isn't worth a cache entry.
+    if (!m_modules.empty() && get_module_within(vtable) == nullptr) {
+        m_typename_cache.reject();
+        return std::nullopt;
+    }
+
+    if (auto cached = m_typename_cache.find(vtable)) {
+        return *cached;
+    }
+
+    IoScope _{IoCategory::RTTI};
+    auto name = handle_get_typename_from_vtable(vtable);
+
+    m_typename_cache.insert(vtable, name);
+    return name;
+}
+
+std::vector<std::string> Process::get_base_typenames(uintptr_t ptr) {
+    if (ptr == 0 || (!has_rtti() && m_rtti_catalog.empty())) {
+        return {};
+    }
+
+    IoScope _{IoCategory::RTTI};
+    auto vtable = read<uintptr_t>(ptr);
+
+    if (!vtable) {
+        return {};
+    }
+
+    return get_base_typenames_from_vtable(*vtable);
+}
+
+std::vector<std::string> Process::get_base_typenames_from_vtable(uintptr_t vtable) {
+    if (vtable == 0) {
+        return {};
+    }
+
+    if (auto entry = m_rtti_catalog.find(vtable)) {
+        auto c = entry->catalog->find_vtable((uint32_t)(vtable - entry->start));
+
+        if (c == nullptr) {
+            return {};
+        }
+
+        std::vector<std::string> names{};
+
+        for (auto&& decorated : c->bases) {
+            auto base = entry->catalog->find_class(decorated);
+            names.emplace_back(base != nullptr ? base->name : rtti::msvc::undecorate(decorated));
+        }
+
+        return names;
+    }
+
+    if (!has_rtti() || (!m_modules.empty() && get_module_within(vtable) == nullptr)) {
+        return {};
+    }
+
+    IoScope _{IoCategory::RTTI};
+    return handle_get_base_typenames_from_vtable(vtable);
+}
+
+bool Process::derives_from(uintptr_t ptr, std::string_view type_name) {
+    return derives_from(ptr, class_id(type_name));
+}
+
+bool Process::derives_from(uintptr_t ptr, rtti::ClassId id) {
+    if (ptr == 0 || (!has_rtti() && m_rtti_catalog.empty())) {
+        return false;
+    }
+
+    IoScope _{IoCategory::RTTI};
+    auto vtable = read<uintptr_t>(ptr);
+
+    return vtable && vtable_derives_from(*vtable, id);
+}
+
+bool Process::vtable_derives_from(uintptr_t vtable, rtti::ClassId id) {
+    if (vtable == 0) {
+        return false;
+    }
+
+    if (auto set = m_hierarchy.find(vtable)) {
+        return set->contains(id);
+    }
+
+    // Same reject as get_typename_from_vtable, sweeps mostly hand us things that aren't vtables.
+    if (!m_modules.empty() && get_module_within(vtable) == nullptr) {
+        return false;
+    }
+
+    auto bases = get_base_typenames_from_vtable(vtable);
+
+    // Without RTTI of its own the backend only knows what the catalog knows, which may not have this module yet.
+    if (bases.empty() && !has_rtti()) {
+        return false;
+    }
+
+    return m_hierarchy.insert(vtable, bases)->contains(id);
+}
+
+std::vector<uintptr_t> Process::get_objects_derived_from(uintptr_t start, size_t size, std::string_view type_name) {
+    // The range can be a whole heap. Scanned a chunk at a time so memory use stays flat and an unreadable page only
+    // costs the chunk it's in.
+    constexpr size_t CHUNK_SIZE = 1024 * 1024;
+
+    IoScope _{IoCategory::RTTI};
+    std::vector<uintptr_t> results{};
+
+    if (start == 0 || size < sizeof(uintptr_t)) {
+        return results;
+    }
+
+    auto id = class_id(type_name);
+    std::vector<uint8_t> memory(std::min(size, CHUNK_SIZE));
+
+    for (size_t offset = 0; offset + sizeof(uintptr_t) <= size; offset += memory.size()) {
+        auto chunk_size = std::min(memory.size(), size - offset);
+
+        if (!read(start + offset, memory.data(), chunk_size)) {
+            continue;
+        }
+
+        for (size_t i = 0; i + sizeof(uintptr_t) <= chunk_size; i += sizeof(uintptr_t)) {
+            uintptr_t value{};
+
+            memcpy(&value, memory.data() + i, sizeof(value));
+
+            if (value >= 0x10000 && vtable_derives_from(value, id)) {
+                results.emplace_back(start + offset + i);
+            }
+        }
+    }
+
+    return results;
+}
+
+std::optional<std::string> Process::handle_get_typename_from_vtable(uintptr_t vtable) {
+    // For Itanium vtables the locator checks fail within a read or two.
+    if (auto name = m_msvc.type_name(*this, vtable)) {
+        return name;
+    }
+
+    return m_itanium.type_name(*this, vtable);
+}
+
+std::vector<std::string> Process::handle_get_base_typenames_from_vtable(uintptr_t vtable) {
+    if (auto bases = m_msvc.bases(*this, vtable); !bases->empty()) {
+        return *bases;
+    }
+
+    return *m_itanium.bases(*this, vtable);
 }
 
 std::optional<uint64_t> Process::protect(uintptr_t address, size_t size, uint64_t flags) {
@@ -33,10 +577,16 @@ std::optional<uintptr_t> Process::allocate(uintptr_t address, size_t size, uint6
 }
 
 const Process::Module* Process::get_module_within(uintptr_t addr) const {
-    for (auto& mod : modules()) {
-        if (addr >= mod.start && addr <= mod.end) {
-            return &mod;
-        }
+    if (auto i = m_region_index->module_within(addr); i != RegionIndex::npos) {
+        return &m_modules[i];
+    }
+
+    return nullptr;
+}
+
+const Process::Allocation* Process::get_allocation_within(uintptr_t addr) const {
+    if (auto i = m_region_index->allocation_within(addr); i != RegionIndex::npos) {
+        return &m_allocations[i];
     }
 
     return nullptr;
@@ -51,3 +601,162 @@ const Process::Module* Process::get_module(std::string_view name) const {
 
     return nullptr;
 }
+
+std::shared_ptr<const RegionIndex> Process::build_region_index(
+    const std::vector<Module>& modules, const std::vector<Allocation>& allocations) {
+    std::vector<RegionIndex::Range> module_ranges{};
+    std::vector<RegionIndex::Range> allocation_ranges{};
+    std::vector<RegionIndex::Range> cached{};
+    std::vector<uint8_t> protection{};
+
+    module_ranges.reserve(modules.size());
+    allocation_ranges.reserve(allocations.size());
+    protection.reserve(allocations.size());
+
+    for (size_t i = 0; i < modules.size(); ++i) {
+        module_ranges.emplace_back(modules[i].start, modules[i].end, i);
+    }
+
+    for (size_t i = 0; i < allocations.size(); ++i) {
+        auto&& a = allocations[i];
+
+        allocation_ranges.emplace_back(a.start, a.end, i);
+        protection.emplace_back((a.read ? RegionIndex::READ : 0) | (a.write ? RegionIndex::WRITE : 0) |
+                                (a.execute ? RegionIndex::EXECUTE : 0));
+
+        if (a.read && !a.write) {
+            cached.emplace_back(a.start, a.end, i);
+        }
+    }
+
+    return std::make_shared<const RegionIndex>(
+        std::move(module_ranges), std::move(allocation_ranges), std::move(cached), std::move(protection));
+}
+
+void Process::rebuild_region_index() {
+    m_region_index = build_region_index(m_modules, m_allocations);
+
+    // Pages that used to be unmapped may not be anymore.
+    m_unreadable_cache.clear();
+}
+
+std::string_view Process::MapEvent::kind_name(Kind kind) {
+    switch (kind) {
+    case Kind::ALLOCATION_ADDED:
+        return "allocation_added";
+    case Kind::ALLOCATION_REMOVED:
+        return "allocation_removed";
+    case Kind::PROTECTION_CHANGED:
+        return "protection_changed";
+    case Kind::MODULE_LOADED:
+        return "module_loaded";
+    case Kind::MODULE_UNLOADED:
+        return "module_unloaded";
+    }
+
+    return "unknown";
+}
+
+std::vector<Process::MapEvent> Process::diff_map(
+    const std::vector<Module>& modules, const std::vector<Allocation>& allocations, const MapSnapshot& snapshot) {
+    std::vector<MapEvent> events{};
+
+    auto allocation_event = [&](MapEvent::Kind kind, const Allocation& a) {
+        events.emplace_back(kind, a.start, a.end, std::string{}, a.read, a.write, a.execute);
+    };
+    auto module_event = [&](MapEvent::Kind kind, const Module& m) {
+        events.emplace_back(kind, m.start, m.end, m.name);
+    };
+
+    // Both sides come out of the backends sorted by start address, which keeps this a single linear walk even with
+    // hundreds of thousands of regions. Sort copies if a backend ever hands us something else.
+    auto by_start = [](auto&& a, auto&& b) { return a.start < b.start; };
+    auto sorted = [&](auto& items, auto& storage) -> auto& {
+        if (std::is_sorted(items.begin(), items.end(), by_start)) {
+            return items;
+        }
+
+        storage.assign(items.begin(), items.end());
+        std::sort(storage.begin(), storage.end(), by_start);
+        return std::as_const(storage);
+    };
+
+    auto walk = [&](auto& old_items, auto& new_items, auto&& same, auto&& changed, auto&& on_added, auto&& on_removed) {
+        std::remove_cvref_t<decltype(old_items)> old_storage{}, new_storage{};
+        auto& olds = sorted(old_items, old_storage);
+        auto& news = sorted(new_items, new_storage);
+        auto o = olds.begin();
+        auto n = news.begin();
+
+        while (o != olds.end() || n != news.end()) {
+            if (n == news.end() || (o != olds.end() && o->start < n->start)) {
+                on_removed(*o++);
+            } else if (o == olds.end() || n->start < o->start) {
+                on_added(*n++);
+            } else if (!same(*o, *n)) {
+                on_removed(*o++);
+                on_added(*n++);
+            } else {
+                changed(*o++, *n++);
+            }
+        }
+    };
+
+    walk(
+        modules, snapshot.modules,
+        [](const Module& a, const Module& b) { return a.end == b.end && a.name == b.name; },
+        [](const Module&, const Module&) {},
+        [&](const Module& m) { module_event(MapEvent::Kind::MODULE_LOADED, m); },
+        [&](const Module& m) { module_event(MapEvent::Kind::MODULE_UNLOADED, m); });
+
+    walk(
+        allocations, snapshot.allocations, [](const Allocation& a, const Allocation& b) { return a.end == b.end; },
+        [&](const Allocation& a, const Allocation& b) {
+            if (a.read != b.read || a.write != b.write || a.execute != b.execute) {
+                allocation_event(MapEvent::Kind::PROTECTION_CHANGED, b);
+            }
+        },
+        [&](const Allocation& a) { allocation_event(MapEvent::Kind::ALLOCATION_ADDED, a); },
+        [&](const Allocation& a) { allocation_event(MapEvent::Kind::ALLOCATION_REMOVED, a); });
+
+    return events;
+}
+
+void Process::apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) {
+    // Only the ranges that actually changed lose their cached pages.
+    for (auto&& e : events) {
+        switch (e.kind) {
+        case MapEvent::Kind::ALLOCATION_REMOVED:
+        case MapEvent::Kind::PROTECTION_CHANGED:
+            m_read_only_cache.invalidate(e.start, e.end);
+            m_epoch_cache.invalidate(e.start, e.end);
+            [[fallthrough]];
+
+        case MapEvent::Kind::ALLOCATION_ADDED:
+            m_unreadable_cache.invalidate(e.start, e.end);
+            break;
+
+        // Whatever was loaded at these addresses before (or nothing at all) has nothing to do with the new module. An
+        // image replaced by another with the same extents produces no allocation events, so its pages go here too.
+        case MapEvent::Kind::MODULE_LOADED:
+        case MapEvent::Kind::MODULE_UNLOADED:
+            m_read_only_cache.invalidate(e.start, e.end);
+            m_epoch_cache.invalidate(e.start, e.end);
+            m_unreadable_cache.invalidate(e.start, e.end);
+            m_typename_cache.invalidate(e.start, e.end);
+            m_rtti_catalog.remove(e.start, e.end);
+            m_msvc.invalidate(e.start, e.end);
+            m_itanium.invalidate(e.start, e.end);
+            m_hierarchy.invalidate(e.start, e.end);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    m_modules = std::move(snapshot.modules);
+    m_allocations = std::move(snapshot.allocations);
+    m_region_index = snapshot.region_index != nullptr ? std::move(snapshot.region_index)
+                                                       : build_region_index(m_modules, m_allocations);
+}
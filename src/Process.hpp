@@ -1,10 +1,25 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "IoStats.hpp"
+#include "PageCache.hpp"
+#include "RegionIndex.hpp"
+#include "TypenameCache.hpp"
+#include "rtti/Catalog.hpp"
+#include "rtti/Hierarchy.hpp"
+#include "rtti/Itanium.hpp"
+#include "rtti/MsvcDecoder.hpp"
+
 class Process {
 public:
     class Module {
@@ -25,29 +40,164 @@ public:
         bool execute{};
     };
 
-    struct ReadOnlyAllocation : public Allocation {
-        // Read only allocations get cached.
-        std::vector<std::byte> mem{};
+    struct ReadRequest {
+        uintptr_t address{};
+        void* buffer{};
+        size_t size{};
+
+        // Set by read_batch.
+        bool ok{};
+    };
+
+    struct FreezeStats {
+        // False if the backend couldn't stop the target. The ranges were still read with one batch.
+        bool suspended{};
+        // How long the target was stopped for (or the batch took, if it couldn't be stopped).
+        std::chrono::nanoseconds pause{};
+        size_t ranges{};
+        size_t bytes{};
+        size_t failed{};
+    };
+
+    struct FreezeSummary {
+        FreezeStats last{};
+        size_t count{};
+        std::chrono::nanoseconds max_pause{};
+        std::chrono::nanoseconds total_pause{};
+    };
+
+    struct MapSnapshot {
+        std::vector<Module> modules{};
+        std::vector<Allocation> allocations{};
+        // Optional, built off the main thread so publishing the snapshot is just a swap.
+        std::shared_ptr<const RegionIndex> region_index{};
+    };
+
+    struct MapEvent {
+        enum class Kind : uint8_t {
+            ALLOCATION_ADDED,
+            ALLOCATION_REMOVED,
+            PROTECTION_CHANGED,
+            MODULE_LOADED,
+            MODULE_UNLOADED,
+        };
+
+        Kind kind{};
+        uintptr_t start{};
+        uintptr_t end{};
+        // Module events only.
+        std::string module{};
+        // Allocation events only, the new protection for PROTECTION_CHANGED.
+        bool read{};
+        bool write{};
+        bool execute{};
+
+        static std::string_view kind_name(Kind kind);
     };
 
     bool read(uintptr_t address, void* buffer, size_t size);
+    // Straight to the backend, skipping the page caches. For bulk copies (snapshots) that would only evict everything
+    // else from them.
+    bool read_direct(uintptr_t address, void* buffer, size_t size);
+    // Reads every request in as few round trips to the target as the backend allows. Cacheable pages end up in the
+    // page caches exactly like they would with read(). Returns the number of requests that succeeded.
+    size_t read_batch(std::span<ReadRequest> requests);
     bool write(uintptr_t address, const void* buffer, size_t size);
     std::optional<uint64_t> protect(uintptr_t address, size_t size, uint64_t flags);
     std::optional<uintptr_t> allocate(uintptr_t address, size_t size, uint64_t flags);
+
+    // Stops the target, reads every (address, size) range with a single backend batch and lets it run again. Until
+    // thaw(), reads that fall entirely inside one of those ranges are served from that copy, so everything read from
+    // them describes the same instant instead of whatever the target was halfway through writing.
+    FreezeStats freeze(std::vector<std::pair<uintptr_t, size_t>> ranges);
+    void thaw();
+    // The last freeze() and totals over every one so far. Safe from any thread.
+    FreezeSummary freeze_summary() const;
+
+    virtual ~Process() = default;
     virtual uint32_t process_id() { return 0; }
 
     // NOTE: Return true by default so you can view structures without being attached.
     virtual bool ok() { return true; }
 
-    // RTTI
-    virtual std::optional<std::string> get_typename(uintptr_t ptr) { return std::nullopt; }
-    virtual std::optional<std::string> get_typename_from_vtable(uintptr_t ptr) { return std::nullopt; }
+    // Re-enumerates the target's memory map without touching the published one, so it's safe to call from a background
+    // thread. Backends without a live map return nullopt.
+    virtual std::optional<MapSnapshot> snapshot_map() { return std::nullopt; }
+    // What changed going from (modules, allocations) to snapshot.
+    static std::vector<MapEvent> diff_map(
+        const std::vector<Module>& modules, const std::vector<Allocation>& allocations, const MapSnapshot& snapshot);
+    // Publishes a new map. Cached pages are only dropped for the ranges named in events. Must not race with readers of
+    // modules()/allocations().
+    virtual void apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events);
+    static std::shared_ptr<const RegionIndex> build_region_index(
+        const std::vector<Module>& modules, const std::vector<Allocation>& allocations);
+
+    // RTTI. Vtables in a module with an RTTI catalog are answered from it, anything else is looked up once per vtable
+    // (see typename_cache()).
+    std::optional<std::string> get_typename(uintptr_t ptr);
+    std::optional<std::string> get_typename_from_vtable(uintptr_t vtable);
+    // The class and every class it derives from, the class itself first. Empty if ptr/vtable isn't an object/vtable.
+    std::vector<std::string> get_base_typenames(uintptr_t ptr);
+    std::vector<std::string> get_base_typenames_from_vtable(uintptr_t vtable);
+    // True if the object at ptr is a type_name or derives from one. Each vtable's hierarchy is kept as a set of
+    // class_id()s, so after the first object of a class this is one read and a bit test.
+    bool derives_from(uintptr_t ptr, std::string_view type_name);
+    bool derives_from(uintptr_t ptr, rtti::ClassId id);
+    bool vtable_derives_from(uintptr_t vtable, rtti::ClassId id);
+    rtti::ClassId class_id(std::string_view type_name) { return m_hierarchy.intern(type_name); }
+    // Every pointer aligned address in [start, start + size) holding the vtable of a class deriving from type_name,
+    // i.e. the objects of that type in the range. Secondary base subobjects of such objects show up too.
+    std::vector<uintptr_t> get_objects_derived_from(uintptr_t start, size_t size, std::string_view type_name);
+    // False if the backend has no way of naming a vtable, get_typename then doesn't even read the object. MSVC and
+    // Itanium C++ ABI (GCC/Clang) RTTI are read through read() by default, so only backends that know better override
+    // this.
+    virtual bool has_rtti() { return true; }
+
+    // Stops/restarts every thread of the target. Backends that can't, or that read through code running inside the
+    // target, return false and never get resume() called.
+    virtual bool suspend() { return false; }
+    virtual void resume() {}
+
+    // Pointer straight into the backend's memory for [address, address + size), for backends whose memory is already
+    // in our address space (mapped dump files). nullptr if that isn't possible, use read() instead.
+    virtual const std::byte* view(uintptr_t address, size_t size) { return nullptr; }
+
+    // Read only allocations are cached page by page as they're read.
+    auto&& read_only_cache() { return m_read_only_cache; }
+
+    // Writable allocations are cached for the duration of one refresh epoch so every node reading the same page
+    // shares one kernel read. Call advance_epoch() once per refresh tick.
+    auto&& epoch_cache() { return m_epoch_cache; }
+    void advance_epoch() { m_epoch_cache.advance_epoch(); }
+
+    // Per call-site counters for read/write/read_batch, tagged with IoScope. Off by default.
+    auto&& io_stats() { return m_io_stats; }
+
+    // Results of get_typename_from_vtable (negatives included) until the module holding the vtable unloads.
+    auto&& typename_cache() { return m_typename_cache; }
+
+    // Every polymorphic class of the modules cataloged so far (rtti::CatalogJob), by load address.
+    auto&& rtti_catalog() { return m_rtti_catalog; }
+
+    // Class ids and the per vtable sets behind derives_from.
+    auto&& class_hierarchy() { return m_hierarchy; }
+
+    // Pages that recently failed to read. Reads touching them fail immediately until the TTL runs out or the memory
+    // map is refreshed.
+    auto&& unreadable_cache() { return m_unreadable_cache; }
 
     auto&& modules() const { return m_modules; }
     auto&& allocations() const { return m_allocations; }
 
     const Process::Module* get_module_within(uintptr_t addr) const;
     const Process::Module* get_module(std::string_view name) const;
+    const Process::Allocation* get_allocation_within(uintptr_t addr) const;
+
+    // Shared O(log n) view of the address space. Rebuilt whenever the module/allocation lists change.
+    auto&& region_index() const { return m_region_index; }
+    std::optional<RegionIndex::Region> get_region_within(uintptr_t addr) const {
+        return m_region_index->region_within(addr);
+    }
 
     template <typename T> std::optional<T> read(uintptr_t address) {
         T out{};
@@ -64,13 +214,67 @@ public:
 protected:
     std::vector<Module> m_modules{};
     std::vector<Allocation> m_allocations{};
-    std::vector<ReadOnlyAllocation> m_read_only_allocations{};
+    std::shared_ptr<const RegionIndex> m_region_index{std::make_shared<RegionIndex>()};
+    ReadOnlyPageCache m_read_only_cache{};
+    EpochPageCache m_epoch_cache{};
+    UnreadablePageCache m_unreadable_cache{};
+    TypenameCache m_typename_cache{};
+    rtti::Catalog m_rtti_catalog{};
+    rtti::msvc::Provider m_msvc{};
+    rtti::itanium::Provider m_itanium{};
+    rtti::Hierarchy m_hierarchy{};
+    IoStats m_io_stats{};
+    // Set by freeze(), sorted by start and non-overlapping.
+    struct Frozen {
+        struct Range {
+            uintptr_t start{};
+            uintptr_t end{};
+            size_t offset{};
+        };
+
+        std::vector<Range> ranges{};
+        std::vector<std::byte> data{};
+    };
+
+    mutable std::mutex m_frozen_mtx{};
+    std::shared_ptr<const Frozen> m_frozen{};
+    FreezeSummary m_freeze_summary{};
+    // Lets reads skip the lock when nothing is frozen.
+    std::atomic<bool> m_has_frozen{};
+    // Set by backends that serve reads from a local mapping. The page caches would only add a copy so they're skipped.
+    bool m_mapped{};
+
+    enum class CachePath { NONE, READ_ONLY, EPOCH };
+
+    // Which page cache (if any) a read goes through.
+    CachePath cache_path(uintptr_t address, size_t size) const;
+
+    // read() without the instrumentation.
+    bool read_cached(uintptr_t address, void* buffer, size_t size);
+    // Serves the read from the frozen copy if it lies entirely inside one frozen range.
+    bool read_frozen(uintptr_t address, void* buffer, size_t size);
+    // handle_read that remembers failures in the unreadable page cache.
+    bool read_uncached(uintptr_t address, void* buffer, size_t size);
+
+    // Call after m_modules or m_allocations change.
+    void rebuild_region_index();
 
     virtual bool handle_write(uintptr_t address, const void* buffer, size_t size) { return true; }
     virtual bool handle_read(uintptr_t address, void* buffer, size_t size) { return true; }
+    // Backends that can read several ranges with one call (process_vm_readv, etc.) should override this. Must set ok
+    // on every request.
+    virtual void handle_read_batch(std::span<ReadRequest> requests);
+    // handle_read_batch with the target stopped around it. Returns how long it was stopped for, nullopt if it couldn't
+    // be (the batch is read anyway). Backends that can stop the target closer to where the reading happens override it.
+    virtual std::optional<std::chrono::nanoseconds> handle_read_batch_suspended(std::span<ReadRequest> requests);
     virtual std::optional<uint64_t> handle_protect(uintptr_t address, size_t size, uint64_t flags) {
         return std::nullopt;
     }
+    // Only called for vtables inside a module that aren't cached yet. Defaults to MSVC RTTI, then the Itanium C++ ABI.
+    virtual std::optional<std::string> handle_get_typename_from_vtable(uintptr_t vtable);
+    // Cached by the backend. Defaults to MSVC class hierarchy descriptors, then Itanium __si_class_type_info and
+    // __vmi_class_type_info.
+    virtual std::vector<std::string> handle_get_base_typenames_from_vtable(uintptr_t vtable);
     virtual std::optional<uintptr_t> handle_allocate(uintptr_t address, size_t size, uint64_t flags) {
         return std::nullopt;
     }
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cassert>
+#include <charconv>
 #include <cstdlib>
 #include <type_traits>
 
@@ -23,6 +24,11 @@ using namespace sdkgenny;
 #include "AboutUi.hpp"
 #include "Utility.hpp"
 #include "arch/Arch.hpp"
+#include "backend/Dump.hpp"
+#include "backend/RecordingProcess.hpp"
+#include "backend/RemoteProcess.hpp"
+#include "backend/ReplayProcess.hpp"
+#include "backend/TimelineProcess.hpp"
 #include "node/Undefined.hpp"
 
 #ifdef _WIN32
@@ -98,6 +104,20 @@ void ReGenny::update() {
         }
     }
 
+    if (m_attach_job != nullptr && m_attach_job->finished()) {
+        finish_attach();
+    }
+
+    if (m_capture_job != nullptr && m_capture_job->finished()) {
+        finish_capture();
+    }
+
+    if (m_catalog_job != nullptr && m_catalog_job->finished()) {
+        m_catalog_job.reset();
+    }
+
+    apply_map_update();
+
     if (m_cfg_save_time && now > *m_cfg_save_time) {
         save_cfg();
         m_cfg_save_time = std::nullopt;
@@ -114,8 +134,51 @@ void ReGenny::update() {
         if (auto da = m_api->consume_deferred_attach()) {
             m_project.process_id = da->pid;
             m_project.process_name = da->name;
+
+            if (da->remote != m_cfg.remote_address || da->token != m_cfg.remote_token) {
+                m_cfg.remote_address = da->remote;
+                m_cfg.remote_token = da->token;
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
             attach();
         }
+        if (auto dtrace = m_api->consume_deferred_trace()) {
+            switch (dtrace->op) {
+            case Api::DeferredTrace::Op::RECORD:
+                trace_record(dtrace->path);
+                break;
+            case Api::DeferredTrace::Op::STOP:
+                trace_stop();
+                break;
+            case Api::DeferredTrace::Op::OPEN:
+                trace_open(dtrace->path, dtrace->replay_latency);
+                break;
+            }
+        }
+        if (auto dtimeline = m_api->consume_deferred_timeline()) {
+            switch (dtimeline->op) {
+            case Api::DeferredTimeline::Op::START:
+                timeline_start();
+                break;
+            case Api::DeferredTimeline::Op::STOP:
+                timeline_stop();
+                break;
+            }
+        }
+        if (auto ddump = m_api->consume_deferred_dump()) {
+            dump_open(ddump->path);
+        }
+        if (auto dcapture = m_api->consume_deferred_capture()) {
+            snapshot::CaptureOptions options{};
+
+            for (auto&& [start, end] : dcapture->ranges) {
+                options.ranges.emplace_back(start, end);
+            }
+
+            options.compress = dcapture->compress;
+            capture_snapshot(dcapture->path, std::move(options));
+        }
         if (auto dopen = m_api->consume_deferred_open()) {
             file_open(dopen->filepath);
         }
@@ -180,6 +243,9 @@ void ReGenny::ui() {
         ImGui::EndPopup();
     }
 
+    attach_progress_ui();
+    capture_progress_ui();
+
     m_ui.rtti_popup = ImGui::GetID("RTTI");
 
     if (ImGui::BeginPopupModal("RTTI")) {
@@ -194,6 +260,19 @@ void ReGenny::ui() {
         ImGui::EndPopup();
     }
 
+    m_ui.diff_popup = ImGui::GetID("Diff");
+    if (ImGui::BeginPopupModal("Diff")) {
+        diff_ui();
+
+        ImGui::SameLine();
+
+        if (ImGui::Button("Close")) {
+            ImGui::CloseCurrentPopup();
+        }
+
+        ImGui::EndPopup();
+    }
+
     m_ui.rtti_sweep_popup = ImGui::GetID("RTTI Sweep");
     if (ImGui::BeginPopupModal("RTTI Sweep")) {
         rtti_sweep_ui();
@@ -240,6 +319,12 @@ void ReGenny::ui() {
     m_logger.ui();
     ImGui::End();
 
+    if (m_ui.show_io_stats) {
+        ImGui::Begin("I/O Stats", &m_ui.show_io_stats);
+        io_stats_ui();
+        ImGui::End();
+    }
+
     ImGui::Begin("LuaEval");
 
     ImGui::BeginChild("luaeval");
@@ -283,6 +368,8 @@ void ReGenny::ui() {
         m_eval_history.push_back(eval.data());
         m_eval_history_index = m_eval_history.size();
 
+        IoScope _{IoCategory::LUA};
+
         try {
             if (std::string_view{eval.data()} == "clear") {
                 m_logger.clear();
@@ -486,6 +573,8 @@ void ReGenny::menu_ui() {
                 save_cfg();
             }
 
+            ImGui::Checkbox("I/O Stats", &m_ui.show_io_stats);
+
             ImGui::EndMenu();
         }
 
@@ -528,6 +617,46 @@ void ReGenny::menu_ui() {
                 action_detach();
             }
 
+            auto recording = dynamic_cast<RecordingProcess*>(m_process.get()) != nullptr;
+            auto timeline = dynamic_cast<TimelineProcess*>(m_process.get()) != nullptr;
+
+            // Only one wrapper around the process at a time.
+            if (ImGui::MenuItem("Record Trace...", nullptr, false,
+                    !recording && !timeline && m_process->process_id() != 0)) {
+                trace_record();
+            }
+
+            if (ImGui::MenuItem("Stop Recording", nullptr, false, recording)) {
+                trace_stop();
+            }
+
+            if (ImGui::MenuItem("Start Timeline", nullptr, false,
+                    !recording && !timeline && m_process->process_id() != 0)) {
+                timeline_start();
+            }
+
+            if (ImGui::MenuItem("Stop Timeline", nullptr, false, timeline)) {
+                timeline_stop();
+            }
+
+            if (ImGui::MenuItem("Open Trace...")) {
+                trace_open();
+            }
+
+            if (ImGui::MenuItem("Open Dump...")) {
+                dump_open();
+            }
+
+            if (ImGui::MenuItem("Capture Snapshot...", nullptr, false,
+                    m_capture_job == nullptr && m_process->process_id() != 0)) {
+                capture_snapshot();
+            }
+
+            if (ImGui::MenuItem("Diff...")) {
+                m_ui.diff_error.clear();
+                ImGui::OpenPopup(m_ui.diff_popup);
+            }
+
             if (ImGui::MenuItem("Generate SDK")) {
                 action_generate_sdk();
             }
@@ -569,6 +698,146 @@ void ReGenny::menu_ui() {
                 m_cfg_save_time = std::chrono::system_clock::now() + 1s;
             }
 
+            if (ImGui::SliderInt("Read-only cache (MB)", &m_cfg.ro_cache_budget_mb, 0, 4096)) {
+                m_process->read_only_cache().budget((size_t)m_cfg.ro_cache_budget_mb * 1024 * 1024);
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
+            if (ImGui::BeginCombo("Refresh page size", fmt::format("0x{:X}", m_cfg.epoch_cache_page_size).c_str())) {
+                for (auto page_size : {0x1000, 0x4000, 0x10000}) {
+                    if (ImGui::Selectable(fmt::format("0x{:X}", page_size).c_str(),
+                            page_size == m_cfg.epoch_cache_page_size)) {
+                        m_cfg.epoch_cache_page_size = page_size;
+                        m_process->epoch_cache().page_size(page_size);
+                        save_cfg();
+                    }
+                }
+
+                ImGui::EndCombo();
+            }
+
+            if (ImGui::IsItemHovered()) {
+                auto stats = m_process->epoch_cache().stats();
+                ImGui::SetTooltip("Pages read from writable memory are shared by every node within one refresh.\n"
+                                  "Hits: %zu Misses: %zu",
+                    stats.hits, stats.misses);
+            }
+
+            if (ImGui::SliderInt("Map refresh (ms)", &m_cfg.map_refresh_ms, 0, 10000)) {
+                if (m_cfg.map_refresh_ms > 0 && m_map_refresher != nullptr) {
+                    m_map_refresher->interval(std::chrono::milliseconds{m_cfg.map_refresh_ms});
+                } else {
+                    start_map_refresher();
+                }
+
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
+            if (ImGui::IsItemHovered()) {
+                if (m_map_refresher != nullptr) {
+                    auto stats = m_map_refresher->stats();
+                    ImGui::SetTooltip("Re-reads the module and allocation map in the background. 0 disables it.\n"
+                                      "Regions: %zu Last refresh: %.1fms Updates: %zu",
+                        stats.regions, stats.last_duration.count() / 1000.0f, stats.updates);
+                } else {
+                    ImGui::SetTooltip("Re-reads the module and allocation map in the background. 0 disables it.");
+                }
+            }
+
+            if (ImGui::SliderInt("Unreadable page TTL (ms)", &m_cfg.unreadable_ttl_ms, 0, 5000)) {
+                m_process->unreadable_cache().ttl(std::chrono::milliseconds{m_cfg.unreadable_ttl_ms});
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
+            if (ImGui::IsItemHovered()) {
+                auto stats = m_process->unreadable_cache().stats();
+                ImGui::SetTooltip("Reads of pages that just failed are rejected without asking the target again.\n"
+                                  "Rejected: %zu Pages: %zu",
+                    stats.rejections, stats.pages);
+            }
+
+            if (ImGui::MenuItem("Clear RTTI cache")) {
+                m_process->typename_cache().clear();
+            }
+
+            if (ImGui::IsItemHovered()) {
+                auto stats = m_process->typename_cache().stats();
+                ImGui::SetTooltip("Type names are looked up once per vtable and kept until its module unloads.\n"
+                                  "Hits: %zu Negative hits: %zu Misses: %zu Not in a module: %zu Entries: %zu",
+                    stats.hits, stats.negative_hits, stats.misses, stats.rejections, stats.entries);
+            }
+
+            if (ImGui::SliderInt("Timeline interval (ms)", &m_cfg.timeline_interval_ms, 0, 60000)) {
+                if (auto timeline = dynamic_cast<TimelineProcess*>(m_process.get())) {
+                    timeline->interval(std::chrono::milliseconds{m_cfg.timeline_interval_ms});
+                }
+
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
+            if (ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("How often Action > Start Timeline captures writable memory. 0 only captures on "
+                                  "request.");
+            }
+
+            if (ImGui::SliderInt("Timeline points", &m_cfg.timeline_max_points, 1, 4096)) {
+                if (auto timeline = dynamic_cast<TimelineProcess*>(m_process.get())) {
+                    timeline->timeline().max_points((size_t)m_cfg.timeline_max_points);
+                }
+
+                m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+            }
+
+            if (ImGui::IsItemHovered()) {
+                if (auto timeline = dynamic_cast<TimelineProcess*>(m_process.get())) {
+                    auto stats = timeline->timeline().stats();
+                    ImGui::SetTooltip("Oldest points are dropped past this many.\n"
+                                      "Points: %zu Unique pages: %zu Logical pages: %zu",
+                        stats.points, stats.unique_pages, stats.logical_pages);
+                } else {
+                    ImGui::SetTooltip("Oldest points are dropped past this many.");
+                }
+            }
+
+            if (ImGui::Checkbox("RTTI catalog", &m_cfg.rtti_catalog)) {
+                if (m_cfg.rtti_catalog) {
+                    start_catalog_job();
+                } else {
+                    stop_catalog_job();
+                    m_process->rtti_catalog().clear();
+                }
+
+                save_cfg();
+            }
+
+            if (ImGui::IsItemHovered()) {
+                auto stats = m_process->rtti_catalog().stats();
+                std::string running{};
+
+                if (m_catalog_job != nullptr) {
+                    auto&& progress = *m_catalog_job->progress();
+                    running = fmt::format("\nCataloging {}/{} modules...", progress.modules_done.load(),
+                        progress.modules.load());
+                }
+
+                ImGui::SetTooltip("Scans every module's RTTI once in the background so type names are a lookup and "
+                                  "anything\nelse inside a cataloged module is known not to be a vtable. Saved next to "
+                                  "the project.\nModules: %zu Classes: %zu Vtables: %zu Hits: %zu Misses: %zu%s",
+                    stats.modules, stats.classes, stats.vtables, stats.hits, stats.misses, running.c_str());
+            }
+
+            if (ImGui::Checkbox("Consistent reads", &m_cfg.consistent_reads)) {
+                save_cfg();
+            }
+
+            if (ImGui::IsItemHovered()) {
+                auto summary = m_process->freeze_summary();
+                ImGui::SetTooltip("Stops the target for one batched read of everything visible each refresh, so "
+                                  "structs are never\nshown half updated. The target is paused for the duration of "
+                                  "that read.\nLast pause: %.0fus Max: %.0fus",
+                    summary.last.pause.count() / 1000.0f, summary.max_pause.count() / 1000.0f);
+            }
+
             if (ImGui::Checkbox("Always on top", &m_cfg.always_on_top)) {
                 save_cfg();
                 SDL_SetWindowAlwaysOnTop(m_window, m_cfg.always_on_top ? true : false);
@@ -791,6 +1060,7 @@ void ReGenny::file_run_lua_script() {
     }
 
     try {
+        IoScope _{IoCategory::LUA};
         m_lua->do_file(lua_path);
     } catch (const std::exception& e) {
         spdlog::error(e.what());
@@ -803,9 +1073,14 @@ void ReGenny::file_run_lua_script() {
 
 void ReGenny::action_detach() {
     spdlog::info("Detaching...");
+    m_capture_job.reset();
+    stop_catalog_job();
+    stop_map_refresher();
     {
         std::unique_lock lk{m_state_mtx};
+        m_map_events.clear();
         m_process = std::make_unique<Process>();
+        diff_result(nullptr);
         m_mem_ui = std::make_unique<MemoryUi>(
             m_cfg, *m_sdk, dynamic_cast<sdkgenny::Struct*>(m_type), *m_process, m_project.props[m_project.type_chosen]);
     }
@@ -840,8 +1115,23 @@ void ReGenny::action_generate_sdk(bool ida) {
 void ReGenny::attach_ui() {
     auto now = std::chrono::steady_clock::now();
 
-    if (m_ui.processes.empty() || now >= m_ui.next_attach_refresh_time) {
-        m_ui.processes = m_helpers->processes();
+    if (ImGui::InputTextWithHint("Remote", "host:port of a regenny-remote server, empty for this machine",
+            &m_cfg.remote_address)) {
+        m_ui.processes.clear();
+        m_ui.next_attach_refresh_time = now + 500ms;
+        m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+    }
+
+    if (!m_cfg.remote_address.empty() &&
+        ImGui::InputText("Token", &m_cfg.remote_token, ImGuiInputTextFlags_Password)) {
+        m_ui.processes.clear();
+        m_ui.next_attach_refresh_time = now + 500ms;
+        m_cfg_save_time = std::chrono::system_clock::now() + 1s;
+    }
+
+    // Don't connect to every partial address while it's being typed.
+    if (now >= m_ui.next_attach_refresh_time) {
+        m_ui.processes = helpers().processes();
         m_ui.next_attach_refresh_time = now + 1s;
     }
 
@@ -877,13 +1167,34 @@ void ReGenny::attach_ui() {
     }
 }
 
+Helpers& ReGenny::helpers() {
+    if (m_helpers == nullptr || m_helpers_remote != m_cfg.remote_address || m_helpers_token != m_cfg.remote_token) {
+        std::string host{};
+        uint16_t port{};
+
+        if (m_cfg.remote_address.empty()) {
+            m_helpers = arch::make_helpers();
+        } else if (remote::parse_address(m_cfg.remote_address, host, port)) {
+            m_helpers = std::make_unique<RemoteHelpers>(host, port, m_cfg.remote_token);
+        } else {
+            // Lists nothing until the address makes sense.
+            m_helpers = std::make_unique<RemoteHelpers>("", 0, "");
+        }
+
+        m_helpers_remote = m_cfg.remote_address;
+        m_helpers_token = m_cfg.remote_token;
+    }
+
+    return *m_helpers;
+}
+
 void ReGenny::attach() {
     if (m_project.process_id == 0) {
         return;
     }
 
     // Make sure we have an up-to-date process list.
-    m_ui.processes = m_helpers->processes();
+    m_ui.processes = helpers().processes();
 
     // Validate that the chosen process_id and process_name match.
     auto is_valid = false;
@@ -898,25 +1209,681 @@ void ReGenny::attach() {
         return;
     }
 
-    spdlog::info("Attaching to {} PID: {}...", m_project.process_name, m_project.process_id);
+    AttachJob::OpenFn open{};
+
+    if (!m_cfg.remote_address.empty()) {
+        std::string host{};
+        uint16_t port{};
+
+        if (!remote::parse_address(m_cfg.remote_address, host, port)) {
+            return;
+        }
+
+        spdlog::info("Attaching to {} PID: {} on {}...", m_project.process_name, m_project.process_id,
+            m_cfg.remote_address);
+
+        open = [host, port, token = m_cfg.remote_token](
+                   uint32_t process_id, AttachProgress&) -> std::unique_ptr<Process> {
+            return std::make_unique<RemoteProcess>(host, port, token, process_id);
+        };
+    } else {
+        spdlog::info("Attaching to {} PID: {}...", m_project.process_name, m_project.process_id);
+    }
+
+    // The process is opened in the background and swapped in by finish_attach. Replacing a running job cancels it.
+    m_attach_job = std::make_unique<AttachJob>(m_project.process_id, std::move(open));
 
     {
         std::unique_lock lk{m_state_mtx};
-        m_process = arch::open_process(m_project.process_id);
-        m_mem_ui = nullptr;
+        m_attach_progress = m_attach_job->progress();
+    }
+}
+
+void ReGenny::attach_progress_ui() {
+    if (m_attach_job == nullptr) {
+        return;
+    }
+
+    auto&& progress = *m_attach_job->progress();
+    auto elapsed = std::chrono::duration<float>{std::chrono::steady_clock::now() - progress.start_time};
+
+    ImGui::SetNextWindowPos(ImVec2{m_window_w / 2.0f, m_window_h / 2.0f}, ImGuiCond_Appearing, ImVec2{0.5f, 0.5f});
+    ImGui::Begin("Attaching", nullptr,
+        ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking);
+    ImGui::Text("%s (PID %u)", m_project.process_name.c_str(), m_attach_job->process_id());
+    ImGui::ProgressBar(-1.0f * (float)ImGui::GetTime(), ImVec2{300.0f, 0.0f},
+        AttachProgress::phase_name(progress.phase).data());
+    ImGui::Text("Modules: %zu", progress.modules.load());
+    ImGui::Text("Regions: %zu", progress.regions.load());
+    ImGui::Text("Read-only: %.1f MB", progress.bytes_cached.load() / (1024.0f * 1024.0f));
+    ImGui::Text("Elapsed: %.1fs", elapsed.count());
+
+    if (progress.cancelled()) {
+        ImGui::TextUnformatted("Cancelling...");
+    } else if (ImGui::Button("Cancel")) {
+        m_attach_job->cancel();
     }
 
-    if (!m_process->ok()) {
+    ImGui::End();
+}
+
+void ReGenny::finish_attach() {
+    auto progress = m_attach_job->progress();
+    auto process = m_attach_job->take();
+
+    m_attach_job.reset();
+
+    if (progress->phase == AttachProgress::Phase::CANCELLED) {
+        spdlog::info("Attach cancelled");
+        return;
+    }
+
+    if (process == nullptr) {
         action_detach();
         m_ui.error_msg = "Couldn't open the process!";
         ImGui::OpenPopup(m_ui.error_popup);
         return;
     }
 
+    configure_process(*process);
+    publish_process(std::move(process));
+}
+
+void ReGenny::configure_process(Process& process) {
+    process.read_only_cache().budget((size_t)m_cfg.ro_cache_budget_mb * 1024 * 1024);
+    process.epoch_cache().page_size(m_cfg.epoch_cache_page_size);
+    process.unreadable_cache().ttl(std::chrono::milliseconds{m_cfg.unreadable_ttl_ms});
+    process.io_stats().enabled(m_cfg.io_stats_enabled);
+}
+
+void ReGenny::publish_process(std::unique_ptr<Process> process) {
+    m_capture_job.reset();
+    stop_catalog_job();
+    stop_map_refresher();
+
+    // Publish in one step so the API thread sees either the old process or the fully constructed new one.
+    {
+        std::unique_lock lk{m_state_mtx};
+        m_process = std::move(process);
+        m_mem_ui = nullptr;
+        m_map_events.clear();
+        // Ranges from another address space would only highlight nonsense.
+        diff_result(nullptr);
+    }
+
+    start_map_refresher();
+    start_catalog_job();
     parse_file();
     set_window_title();
 }
 
+void ReGenny::trace_record(const std::filesystem::path& path) {
+    if (m_process == nullptr || m_process->process_id() == 0 || dynamic_cast<RecordingProcess*>(m_process.get()) ||
+        dynamic_cast<TimelineProcess*>(m_process.get())) {
+        return;
+    }
+
+    auto trace_path = path;
+
+    if (trace_path.empty()) {
+        nfdchar_t* out_path{};
+
+        if (NFD_SaveDialog("rgtrace", nullptr, &out_path) != NFD_OKAY) {
+            return;
+        }
+
+        trace_path = out_path;
+        free(out_path);
+    }
+
+    m_capture_job.reset();
+    stop_catalog_job();
+    stop_map_refresher();
+
+    auto failed = false;
+
+    // The wrapper takes over the current process, so it has to be swapped in under the same lock.
+    {
+        std::unique_lock lk{m_state_mtx};
+        auto recording = std::make_unique<RecordingProcess>(std::move(m_process), trace_path);
+
+        if (recording->recording()) {
+            configure_process(*recording);
+            m_process = std::move(recording);
+        } else {
+            m_process = recording->release();
+            configure_process(*m_process);
+            failed = true;
+        }
+
+        m_mem_ui = nullptr;
+    }
+
+    start_map_refresher();
+    start_catalog_job();
+    parse_file();
+
+    if (failed) {
+        m_ui.error_msg = fmt::format("Couldn't create trace {}", trace_path.string());
+        ImGui::OpenPopup(m_ui.error_popup);
+    } else {
+        spdlog::info("Recording trace to {}", trace_path.string());
+    }
+}
+
+void ReGenny::trace_stop() {
+    if (dynamic_cast<RecordingProcess*>(m_process.get()) == nullptr) {
+        return;
+    }
+
+    m_capture_job.reset();
+    stop_catalog_job();
+    stop_map_refresher();
+
+    {
+        std::unique_lock lk{m_state_mtx};
+        auto recording = std::unique_ptr<RecordingProcess>{static_cast<RecordingProcess*>(m_process.release())};
+
+        m_process = recording->release();
+        m_mem_ui = nullptr;
+    }
+
+    // The wrapper turned the inner process's caches off.
+    configure_process(*m_process);
+    spdlog::info("Stopped recording");
+
+    start_map_refresher();
+    start_catalog_job();
+    parse_file();
+}
+
+void ReGenny::timeline_start() {
+    if (m_process == nullptr || m_process->process_id() == 0 || dynamic_cast<RecordingProcess*>(m_process.get()) ||
+        dynamic_cast<TimelineProcess*>(m_process.get())) {
+        return;
+    }
+
+    m_capture_job.reset();
+    stop_catalog_job();
+    stop_map_refresher();
+
+    {
+        std::unique_lock lk{m_state_mtx};
+        auto timeline = std::make_unique<TimelineProcess>(std::move(m_process),
+            std::chrono::milliseconds{m_cfg.timeline_interval_ms}, (size_t)std::max(m_cfg.timeline_max_points, 1));
+
+        configure_process(*timeline);
+        m_process = std::move(timeline);
+        m_mem_ui = nullptr;
+    }
+
+    spdlog::info("Started timeline");
+
+    start_map_refresher();
+    start_catalog_job();
+    parse_file();
+}
+
+void ReGenny::timeline_stop() {
+    if (dynamic_cast<TimelineProcess*>(m_process.get()) == nullptr) {
+        return;
+    }
+
+    m_capture_job.reset();
+    stop_catalog_job();
+    stop_map_refresher();
+
+    {
+        std::unique_lock lk{m_state_mtx};
+        auto timeline = std::unique_ptr<TimelineProcess>{static_cast<TimelineProcess*>(m_process.release())};
+
+        m_process = timeline->release();
+        m_mem_ui = nullptr;
+    }
+
+    spdlog::info("Stopped timeline");
+
+    start_map_refresher();
+    start_catalog_job();
+    parse_file();
+}
+
+std::shared_ptr<const diff::Result> ReGenny::diff_result() const {
+    std::scoped_lock _{m_diff_mtx};
+    return m_diff;
+}
+
+void ReGenny::diff_result(std::shared_ptr<const diff::Result> result) {
+    std::scoped_lock _{m_diff_mtx};
+    m_diff = std::move(result);
+}
+
+std::shared_ptr<const diff::Result> ReGenny::run_diff(const std::string& before, const std::string& after,
+    std::vector<diff::Range> ranges, size_t merge_gap, std::string& error) {
+    if (m_process == nullptr) {
+        error = "No process";
+        return nullptr;
+    }
+
+    // "live" means the process itself, not whichever point the timeline is showing.
+    auto timeline = dynamic_cast<TimelineProcess*>(m_process.get());
+    auto& live = timeline != nullptr ? *timeline->inner() : *m_process;
+    // Dumps opened just for this comparison. Without explicit ranges the last one opened decides what's compared.
+    std::vector<std::unique_ptr<Process>> opened{};
+    Process* ranges_from = &live;
+
+    auto make_source = [&](const std::string& spec) -> std::optional<diff::Source> {
+        if (spec == "live") {
+            return diff::from_process(live);
+        }
+
+        if (spec.starts_with("timeline:")) {
+            uint64_t point{};
+            auto [end, ec] = std::from_chars(spec.data() + 9, spec.data() + spec.size(), point);
+
+            if (timeline == nullptr) {
+                error = "No timeline running";
+                return std::nullopt;
+            }
+
+            if (ec != std::errc{} || end != spec.data() + spec.size() || !timeline->timeline().contains(point)) {
+                error = fmt::format("No timeline point {}", spec.substr(9));
+                return std::nullopt;
+            }
+
+            return diff::from_timeline(timeline->timeline(), point);
+        }
+
+        auto dump = backend::open_dump(spec);
+
+        if (dump == nullptr) {
+            error = fmt::format("Couldn't open {}", spec);
+            return std::nullopt;
+        }
+
+        ranges_from = dump.get();
+        opened.emplace_back(std::move(dump));
+
+        return diff::from_process(*opened.back());
+    };
+
+    auto before_source = make_source(before);
+
+    if (!before_source) {
+        return nullptr;
+    }
+
+    auto after_source = make_source(after);
+
+    if (!after_source) {
+        return nullptr;
+    }
+
+    if (ranges.empty()) {
+        ranges = diff::readable_ranges(ranges_from->allocations());
+    }
+
+    auto result = std::make_shared<const diff::Result>(
+        diff::compare(*before_source, *after_source, std::move(ranges), {.merge_gap = merge_gap}));
+
+    spdlog::info("Diff {} -> {}: {} ranges, {} bytes changed in {:.1f}ms ({})", before, after, result->ranges.size(),
+        result->stats.bytes_changed, std::chrono::duration<double, std::milli>{result->stats.duration}.count(),
+        result->stats.kernel);
+
+    diff_result(result);
+
+    return result;
+}
+
+void ReGenny::diff_ui() {
+    ImGui::InputText("Before", &m_ui.diff_before);
+    ImGui::InputText("After", &m_ui.diff_after);
+    ImGui::TextDisabled("live, timeline:<point id> or the path of a snapshot/dump");
+
+    if (ImGui::Button("Compare")) {
+        m_ui.diff_error.clear();
+        run_diff(m_ui.diff_before, m_ui.diff_after, {}, 0, m_ui.diff_error);
+    }
+
+    ImGui::SameLine();
+
+    if (ImGui::Button("Clear")) {
+        diff_result(nullptr);
+    }
+
+    if (!m_ui.diff_error.empty()) {
+        ImGui::TextColored({1.0f, 0.0f, 0.0f, 1.0f}, "%s", m_ui.diff_error.c_str());
+    }
+
+    auto result = diff_result();
+
+    if (result == nullptr) {
+        return;
+    }
+
+    auto&& stats = result->stats;
+
+    ImGui::Text("%zu ranges, %zu bytes changed in %zu of %zu pages (%.1fms, %s)", result->ranges.size(),
+        stats.bytes_changed, stats.pages_changed, stats.pages,
+        std::chrono::duration<float, std::milli>{stats.duration}.count(), stats.kernel);
+
+    ImGui::BeginChild("DiffRanges", {0.0f, 256.0f}, ImGuiChildFlags_Borders);
+
+    ImGuiListClipper clipper{};
+    clipper.Begin((int)result->ranges.size());
+
+    while (clipper.Step()) {
+        for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            auto&& r = result->ranges[i];
+
+            ImGui::PushID(i);
+
+            // Jump to it.
+            if (ImGui::Selectable(fmt::format("0x{:X} - 0x{:X} ({} bytes)", r.start, r.end, r.end - r.start).c_str())) {
+                m_ui.address = fmt::format("0x{:X}", r.start);
+                set_address();
+            }
+
+            ImGui::PopID();
+        }
+    }
+
+    ImGui::EndChild();
+}
+
+void ReGenny::trace_open(const std::filesystem::path& path, bool replay_latency) {
+    auto trace_path = path;
+
+    if (trace_path.empty()) {
+        nfdchar_t* out_path{};
+
+        if (NFD_OpenDialog("rgtrace", nullptr, &out_path) != NFD_OKAY) {
+            return;
+        }
+
+        trace_path = out_path;
+        free(out_path);
+    }
+
+    auto replay = std::make_unique<ReplayProcess>(trace_path);
+
+    if (!replay->ok()) {
+        m_ui.error_msg = fmt::format("Couldn't open trace {}", trace_path.string());
+        ImGui::OpenPopup(m_ui.error_popup);
+        return;
+    }
+
+    replay->replay_latency(replay_latency);
+    configure_process(*replay);
+    m_attach_job.reset();
+    publish_process(std::move(replay));
+}
+
+void ReGenny::dump_open(const std::filesystem::path& path) {
+    auto dump_path = path;
+
+    if (dump_path.empty()) {
+        nfdchar_t* out_path{};
+
+        // Core files usually have no extension so there's no filter.
+        if (NFD_OpenDialog(nullptr, nullptr, &out_path) != NFD_OKAY) {
+            return;
+        }
+
+        dump_path = out_path;
+        free(out_path);
+    }
+
+    auto dump = backend::open_dump(dump_path);
+
+    if (dump == nullptr) {
+        m_ui.error_msg = fmt::format("Couldn't open dump {}", dump_path.string());
+        ImGui::OpenPopup(m_ui.error_popup);
+        return;
+    }
+
+    configure_process(*dump);
+    m_attach_job.reset();
+    publish_process(std::move(dump));
+}
+
+void ReGenny::capture_snapshot(const std::filesystem::path& path, snapshot::CaptureOptions options) {
+    if (m_capture_job != nullptr || m_process == nullptr || m_process->process_id() == 0) {
+        return;
+    }
+
+    auto snapshot_path = path;
+
+    if (snapshot_path.empty()) {
+        nfdchar_t* out_path{};
+
+        if (NFD_SaveDialog("rgsnap", nullptr, &out_path) != NFD_OKAY) {
+            return;
+        }
+
+        snapshot_path = out_path;
+        free(out_path);
+    }
+
+    options.process_name = m_project.process_name;
+
+    spdlog::info("Capturing snapshot to {}...", snapshot_path.string());
+
+    m_capture_job = std::make_unique<snapshot::CaptureJob>(*m_process, snapshot_path, std::move(options));
+
+    std::unique_lock lk{m_state_mtx};
+    m_capture_progress = m_capture_job->progress();
+}
+
+void ReGenny::capture_progress_ui() {
+    if (m_capture_job == nullptr) {
+        return;
+    }
+
+    auto&& progress = *m_capture_job->progress();
+    auto chunks = progress.chunks.load();
+    auto fraction = chunks != 0 ? (float)progress.chunks_done / chunks : 0.0f;
+    auto elapsed = std::chrono::duration<float>{std::chrono::steady_clock::now() - progress.start_time};
+
+    ImGui::SetNextWindowPos(ImVec2{m_window_w / 2.0f, m_window_h / 2.0f}, ImGuiCond_Appearing, ImVec2{0.5f, 0.5f});
+    ImGui::Begin("Capturing Snapshot", nullptr,
+        ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoDocking);
+    ImGui::TextUnformatted(m_capture_job->path().string().c_str());
+    ImGui::ProgressBar(fraction, ImVec2{300.0f, 0.0f});
+    ImGui::Text("Read: %.1f MB", progress.bytes_read / (1024.0f * 1024.0f));
+    ImGui::Text("Written: %.1f MB", progress.bytes_written / (1024.0f * 1024.0f));
+    ImGui::Text("Elapsed: %.1fs", elapsed.count());
+
+    if (progress.cancelled()) {
+        ImGui::TextUnformatted("Cancelling...");
+    } else if (ImGui::Button("Cancel")) {
+        m_capture_job->cancel();
+    }
+
+    ImGui::End();
+}
+
+void ReGenny::finish_capture() {
+    auto progress = m_capture_job->progress();
+
+    m_capture_job.reset();
+
+    if (!progress->ok && !progress->cancelled()) {
+        m_ui.error_msg = "Couldn't write the snapshot!";
+        ImGui::OpenPopup(m_ui.error_popup);
+    }
+}
+
+void ReGenny::io_stats_ui() {
+    auto&& stats = m_process->io_stats();
+
+    if (ImGui::Checkbox("Enabled", &m_cfg.io_stats_enabled)) {
+        stats.enabled(m_cfg.io_stats_enabled);
+        save_cfg();
+    }
+
+    ImGui::SameLine();
+
+    if (ImGui::Button("Reset")) {
+        stats.reset();
+    }
+
+    auto snapshot = stats.snapshot();
+    auto flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+
+    if (ImGui::BeginTable("io_stats", 8, flags)) {
+        ImGui::TableSetupColumn("Category");
+        ImGui::TableSetupColumn("Reads");
+        ImGui::TableSetupColumn("Bytes");
+        ImGui::TableSetupColumn("Failed");
+        ImGui::TableSetupColumn("Backend");
+        ImGui::TableSetupColumn("Writes");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableHeadersRow();
+
+        for (size_t i = 0; i < snapshot.size(); ++i) {
+            auto&& c = snapshot[i];
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(io_category_name((IoCategory)i).data());
+
+            if (ImGui::IsItemHovered()) {
+                std::array<float, IoStats::HISTOGRAM_BUCKETS> histogram{};
+
+                for (size_t j = 0; j < histogram.size(); ++j) {
+                    histogram[j] = (float)c.histogram[j];
+                }
+
+                ImGui::BeginTooltip();
+                ImGui::Text("Latency histogram (bucket i = 2^i ns)");
+                ImGui::PlotHistogram("##latency", histogram.data(), (int)histogram.size(), 0, nullptr, 0.0f, FLT_MAX,
+                    ImVec2{400.0f, 100.0f});
+                ImGui::EndTooltip();
+            }
+
+            auto cell = [](const std::string& text) {
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(text.c_str());
+            };
+
+            cell(fmt::format("{}", c.reads));
+            cell(fmt::format("{}", c.read_bytes + c.write_bytes));
+            cell(fmt::format("{}", c.read_failures + c.write_failures));
+            cell(fmt::format("{}", c.backend_reads));
+            cell(fmt::format("{}", c.writes));
+            cell(fmt::format("{:.1f}us", c.percentile(0.5).count() / 1000.0));
+            cell(fmt::format("{:.1f}us", c.percentile(0.99).count() / 1000.0));
+        }
+
+        ImGui::EndTable();
+    }
+}
+
+void ReGenny::start_map_refresher() {
+    stop_map_refresher();
+
+    if (m_cfg.map_refresh_ms <= 0 || m_process == nullptr || m_process->process_id() == 0) {
+        return;
+    }
+
+    auto refresher = std::make_unique<MapRefresher>(*m_process, std::chrono::milliseconds{m_cfg.map_refresh_ms});
+
+    std::unique_lock lk{m_state_mtx};
+    m_map_refresher = std::move(refresher);
+}
+
+void ReGenny::stop_map_refresher() {
+    std::unique_ptr<MapRefresher> refresher{};
+
+    {
+        std::unique_lock lk{m_state_mtx};
+        refresher = std::move(m_map_refresher);
+    }
+
+    // Joins the refresh thread, so not while holding the state lock.
+    refresher.reset();
+}
+
+void ReGenny::apply_map_update() {
+    if (m_map_refresher == nullptr) {
+        return;
+    }
+
+    auto update = m_map_refresher->poll();
+
+    if (!update) {
+        return;
+    }
+
+    auto modules_changed = false;
+
+    for (auto&& e : update->events) {
+        if (e.kind == Process::MapEvent::Kind::MODULE_LOADED) {
+            spdlog::info("Module loaded: {} (0x{:X})", e.module, e.start);
+            modules_changed = true;
+        } else if (e.kind == Process::MapEvent::Kind::MODULE_UNLOADED) {
+            spdlog::info("Module unloaded: {} (0x{:X})", e.module, e.start);
+            modules_changed = true;
+        }
+    }
+
+    // A running catalog job could otherwise publish a catalog for a module that just went away.
+    if (modules_changed) {
+        stop_catalog_job();
+    }
+
+    // Only keep enough history for the API to show what changed recently.
+    constexpr size_t MAX_MAP_EVENTS = 1024;
+
+    {
+        std::unique_lock lk{m_state_mtx};
+
+        m_process->apply_map(std::move(update->snapshot), update->events);
+
+        for (auto&& e : update->events) {
+            m_map_events.emplace_back(std::move(e));
+        }
+
+        while (m_map_events.size() > MAX_MAP_EVENTS) {
+            m_map_events.pop_front();
+        }
+    }
+
+    // Picks up the modules that were just loaded (and any the stopped job didn't get to).
+    if (modules_changed) {
+        start_catalog_job();
+    }
+}
+
+void ReGenny::start_catalog_job() {
+    stop_catalog_job();
+
+    if (!m_cfg.rtti_catalog || m_process == nullptr || m_process->modules().empty()) {
+        return;
+    }
+
+    // Saved next to the project (foo.genny -> foo.rtti/) so the next attach to the same builds skips the scan.
+    std::filesystem::path directory{};
+
+    if (!m_open_filepath.empty()) {
+        directory = m_open_filepath;
+        directory.replace_extension("rtti");
+    }
+
+    m_catalog_job = std::make_unique<rtti::CatalogJob>(*m_process, std::move(directory));
+
+    std::unique_lock lk{m_state_mtx};
+    m_catalog_progress = m_catalog_job->progress();
+}
+
+void ReGenny::stop_catalog_job() {
+    // Joins the catalog thread, which never takes the state lock. It only reads through read_direct, so it doesn't
+    // need stopping around apply_map either (see rtti::CatalogJob).
+    m_catalog_job.reset();
+}
+
 void ReGenny::module_memory_scan_ui() {
     if (m_process == nullptr || !m_process->ok() || m_process->process_id() == 0) {
         ImGui::Text("Error: No Process");
@@ -986,6 +1953,8 @@ void ReGenny::module_memory_scan_ui() {
 }
 
 void ReGenny::scan_module_memory() {
+    IoScope _{IoCategory::RTTI};
+
     if (m_ui.selected_module.name.empty() || m_ui.selected_module.size == 0) {
         m_ui.module_scan_text = "No module selected or invalid module";
         return;
@@ -1027,9 +1996,11 @@ void ReGenny::scan_module_memory() {
             continue;
         }
         
-        // Check if this could be a valid pointer within the process address space
+        // Check if this could be a valid pointer within the process address space. The value itself being a vtable
+        // (this is an object) is answered from what we already read, from the RTTI catalog without any read at all.
         for (size_t j = 0; j < 2; ++j) {
-            const auto tname = m_process->get_typename(j == 0 ? m_ui.selected_module.start + i : ptr_value);
+            const auto tname =
+                j == 0 ? m_process->get_typename_from_vtable(ptr_value) : m_process->get_typename(ptr_value);
             
             if (!tname || tname->empty()) {
                 continue;
@@ -1083,6 +2054,8 @@ void ReGenny::scan_module_memory() {
 }
 
 void ReGenny::rtti_sweep_ui() {
+    IoScope _{IoCategory::RTTI};
+
     if (m_process == nullptr || !m_process->ok() || m_process->process_id() == 0) {
         ImGui::Text("Error: No Process");
         return;
@@ -1224,6 +2197,8 @@ void ReGenny::rtti_sweep_ui() {
 }
 
 void ReGenny::rtti_ui() {
+    IoScope _{IoCategory::RTTI};
+
     if (m_process == nullptr || !m_process->ok() || m_process->process_id() == 0) {
         ImGui::Text("Error: No Process");
         return;
@@ -1310,6 +2285,7 @@ void ReGenny::rtti_ui() {
 
 void ReGenny::update_address() {
     std::unique_lock state_lk{m_state_mtx};
+    IoScope _{IoCategory::ADDRESS_RESOLVE};
     // If the parsed address has no offsets then it's not valid at all and there's nothing to update.
     if (m_parsed_address.offsets.empty()) {
         return;
@@ -1355,12 +2331,7 @@ void ReGenny::update_address() {
     }
 
     // Validate the final address.
-    for (auto&& allocation : m_process->allocations()) {
-        if (allocation.start <= m_address && m_address <= allocation.end) {
-            m_is_address_valid = true;
-            break;
-        }
-    }
+    m_is_address_valid = m_process->get_allocation_within(m_address) != nullptr;
 }
 
 void ReGenny::memory_ui() {
@@ -1405,9 +2376,12 @@ void ReGenny::memory_ui() {
         ImGui::TextColored({0.0f, 1.0f, 0.0f, 1.0f}, "%p", m_address);
     }
 
+    // Everything read from here on (address resolution, node refreshes) shares pages until the next frame.
+    m_process->advance_epoch();
     update_address();
 
     if (m_mem_ui != nullptr) {
+        node::Base::changes = diff_result();
         m_mem_ui->display(m_is_address_valid ? m_address : 0);
     }
 }
@@ -1650,6 +2624,17 @@ void ReGenny::reset_lua_state() {
 
     auto create_overlay = lua.safe_script("return function(addr, t) return sdkgenny.StructOverlay(addr, t) end").get<sol::function>();
 
+    auto diff_table = [](sol::this_state s, const diff::Result& result) {
+        auto lua = sol::state_view{s};
+        auto ranges = lua.create_table((int)result.ranges.size(), 0);
+
+        for (auto&& r : result.ranges) {
+            ranges.add(lua.create_table_with("start", r.start, "end", r.end, "size", r.end - r.start));
+        }
+
+        return ranges;
+    };
+
     m_lua->new_usertype<ReGenny>("ReGennyClass",
         sol::no_constructor,
         "type", &ReGenny::type,
@@ -1698,6 +2683,35 @@ void ReGenny::reset_lua_state() {
         },
         "remove_address_resolver", [](ReGenny* rg, uint32_t id) {
             rg->remove_address_resolver(id);
+        },
+        // regenny:diff("timeline:0", "live") -> {{start, end, size}, ...}, also highlighted in the node tree.
+        "diff", [diff_table](sol::this_state s, ReGenny* rg, const std::string& before, const std::string& after,
+                    sol::object merge_gap) -> sol::object {
+            std::string error{};
+            auto result = rg->run_diff(before, after, {}, merge_gap.is<size_t>() ? merge_gap.as<size_t>() : 0, error);
+
+            if (result == nullptr) {
+                spdlog::error("Diff failed: {}", error);
+                return sol::make_object(s, sol::nil);
+            }
+
+            return sol::make_object(s, diff_table(s, *result));
+        },
+        "diff_ranges", [diff_table](sol::this_state s, ReGenny* rg) -> sol::object {
+            auto result = rg->diff_result();
+
+            if (result == nullptr) {
+                return sol::make_object(s, sol::nil);
+            }
+
+            return sol::make_object(s, diff_table(s, *result));
+        },
+        "changed", [](ReGenny* rg, uintptr_t address, size_t size) {
+            auto result = rg->diff_result();
+            return result != nullptr && result->changed(address, address + size);
+        },
+        "clear_diff", [](ReGenny* rg) {
+            rg->diff_result(nullptr);
         }
     );
 
@@ -1771,6 +2785,16 @@ void ReGenny::reset_lua_state() {
         },
         "get_module_within", &Process::get_module_within,
         "get_module", &Process::get_module,
+        "get_allocation_within", &Process::get_allocation_within,
+        "get_typename", &Process::get_typename,
+        "get_typename_from_vtable", &Process::get_typename_from_vtable,
+        "get_base_typenames", &Process::get_base_typenames,
+        "derives_from", [](Process* p, uintptr_t obj_ptr, const std::string& type_name) {
+            return p->derives_from(obj_ptr, type_name);
+        },
+        "get_objects_derived_from", [](Process* p, uintptr_t start, size_t size, const std::string& type_name) {
+            return p->get_objects_derived_from(start, size, type_name);
+        },
         "modules", &Process::modules,
         "allocations", &Process::allocations
     );
@@ -1778,11 +2802,6 @@ void ReGenny::reset_lua_state() {
 #ifdef _WIN32
     m_lua->new_usertype<arch::WindowsProcess>("ReGennyWindowsProcess",
         sol::base_classes, sol::bases<Process>(),
-        "get_typename", &arch::WindowsProcess::get_typename,
-        "get_typename_from_vtable", &arch::WindowsProcess::get_typename_from_vtable,
-        "derives_from", [](arch::WindowsProcess* p, uintptr_t obj_ptr, const std::string& type_name) {
-            return p->derives_from(obj_ptr, type_name);
-        },
         "resolve_object_base_address", &arch::WindowsProcess::resolve_object_base_address,
         "allocate_rwx", [](arch::WindowsProcess* p, uintptr_t addr, size_t size) {
             return p->allocate(addr, size, PAGE_EXECUTE_READWRITE);
@@ -2092,8 +3111,14 @@ void ReGenny::set_window_title() {
         title += fmt::format(" - {}", m_open_filepath.string());
     }
 
-    if (m_process && m_process->process_id() != 0 && !m_project.process_name.empty()) {
+    if (auto dump = dynamic_cast<MappedProcess*>(m_process.get())) {
+        title += fmt::format(" - {}", dump->path().string());
+    } else if (m_process && m_process->process_id() != 0 && !m_project.process_name.empty()) {
         title += fmt::format(" - {} PID: {}", m_project.process_name, m_project.process_id);
+
+        if (auto remote = dynamic_cast<RemoteProcess*>(m_process.get())) {
+            title += fmt::format(" @ {}", remote->address());
+        }
     }
 
     SDL_SetWindowTitle(m_window, title.c_str());
@@ -13,14 +13,19 @@
 #include <sdkgenny.hpp>
 #include <sol/sol.hpp>
 
+#include "AttachJob.hpp"
 #include "Config.hpp"
 #include "Helpers.hpp"
 #include "LoggerUi.hpp"
+#include "MapRefresher.hpp"
 #include "MemoryUi.hpp"
 #include "Process.hpp"
 #include "Project.hpp"
 #include "Utility.hpp"
+#include "backend/Diff.hpp"
+#include "backend/Snapshot.hpp"
 #include "node/Property.hpp"
+#include "rtti/CatalogJob.hpp"
 #include "sdl_trigger.h"
 
 class Api;
@@ -44,8 +49,25 @@ public:
     auto& sdk() const { return m_sdk; }
     auto type() const { return m_type; }
     auto& process() const { return m_process; }
+    // Progress of the current (or last) attach, nullptr if we never attached. Guarded by state_mtx.
+    auto& attach_progress() const { return m_attach_progress; }
+    // Most recent memory map changes, oldest first. Guarded by state_mtx.
+    auto& map_events() const { return m_map_events; }
+    auto& map_refresher() const { return m_map_refresher; }
+    // Progress of the current (or last) snapshot capture, nullptr if there wasn't one. Guarded by state_mtx.
+    auto& capture_progress() const { return m_capture_progress; }
+    auto& catalog_progress() const { return m_catalog_progress; }
     auto address() const { return m_address; }
 
+    // Last diff, highlighted in the node tree. nullptr if there isn't one. Safe from any thread.
+    std::shared_ptr<const diff::Result> diff_result() const;
+    void diff_result(std::shared_ptr<const diff::Result> result);
+    // Compares two sources, each "live", "timeline:<point>" or the path of a snapshot/dump file. Without ranges every
+    // readable allocation is compared. Publishes and returns the result, or sets error and returns nullptr. Call on
+    // the main thread or with state_mtx held.
+    std::shared_ptr<const diff::Result> run_diff(const std::string& before, const std::string& after,
+        std::vector<diff::Range> ranges, size_t merge_gap, std::string& error);
+
     // API accessors — used by the embedded HTTP server (Api.cpp).
     auto& open_filepath() const { return m_open_filepath; }
     auto& project() const { return m_project; }
@@ -84,7 +106,23 @@ private:
     SDL_Window* m_window{};
 
     std::unique_ptr<Helpers> m_helpers{};
+    // The remote address and token m_helpers lists processes with, empty for this machine.
+    std::string m_helpers_remote{};
+    std::string m_helpers_token{};
     std::unique_ptr<Process> m_process{};
+    std::unique_ptr<AttachJob> m_attach_job{};
+    std::shared_ptr<AttachProgress> m_attach_progress{};
+    // Must go before m_process does, it holds a reference to it.
+    std::unique_ptr<MapRefresher> m_map_refresher{};
+    std::deque<Process::MapEvent> m_map_events{};
+    // Same as m_map_refresher, reset whenever m_process is replaced.
+    std::unique_ptr<snapshot::CaptureJob> m_capture_job{};
+    std::shared_ptr<snapshot::CaptureProgress> m_capture_progress{};
+    // Same again. Restarted after every process swap and module load/unload.
+    std::unique_ptr<rtti::CatalogJob> m_catalog_job{};
+    std::shared_ptr<rtti::CatalogProgress> m_catalog_progress{};
+    mutable std::mutex m_diff_mtx{};
+    std::shared_ptr<const diff::Result> m_diff{};
     std::unique_ptr<sdkgenny::Sdk> m_sdk{};
     sdkgenny::Type* m_type{};
     uintptr_t m_address{};
@@ -112,6 +150,12 @@ private:
 
         std::string rtti_text{};
 
+        bool show_io_stats{};
+
+        std::string diff_before{"timeline:0"};
+        std::string diff_after{"live"};
+        std::string diff_error{};
+
         std::recursive_mutex rtti_lock{};
         std::string rtti_sweep_text{};
         std::string rtti_sweep_search_name{};
@@ -123,6 +167,7 @@ private:
         ImGuiID about_popup{};
         ImGuiID extensions_popup{};
         ImGuiID module_memory_scan_popup{};
+        ImGuiID diff_popup{};
 
         // Module memory scanning
         Process::Module selected_module{};
@@ -176,7 +221,30 @@ private:
     void action_generate_sdk(bool ida = false);
 
     void attach_ui();
+    // Process list of this machine or of m_cfg.remote_address.
+    Helpers& helpers();
     void attach();
+    void attach_progress_ui();
+    void finish_attach();
+    void configure_process(Process& process);
+    void publish_process(std::unique_ptr<Process> process);
+    void trace_record(const std::filesystem::path& path = {});
+    void trace_stop();
+    void trace_open(const std::filesystem::path& path = {}, bool replay_latency = false);
+    void timeline_start();
+    void timeline_stop();
+    void diff_ui();
+    void dump_open(const std::filesystem::path& path = {});
+    void capture_snapshot(const std::filesystem::path& path = {}, snapshot::CaptureOptions options = {});
+    void capture_progress_ui();
+    void finish_capture();
+    void io_stats_ui();
+    void start_map_refresher();
+    void stop_map_refresher();
+    void apply_map_update();
+    // Catalogs whatever modules aren't yet, saving the catalogs next to the project.
+    void start_catalog_job();
+    void stop_catalog_job();
 
     void rtti_ui();
     void rtti_sweep_ui();
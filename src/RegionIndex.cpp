@@ -0,0 +1,68 @@
+#include <algorithm>
+
+#include "RegionIndex.hpp"
+
+RegionIndex::RegionIndex(std::vector<Range> modules, std::vector<Range> allocations, std::vector<Range> cached,
+    std::vector<uint8_t> allocation_protection)
+    : m_modules{std::move(modules)}, m_allocations{std::move(allocations)}, m_cached{std::move(cached)},
+      m_protection{std::move(allocation_protection)} {
+    auto by_start = [](const Range& a, const Range& b) { return a.start < b.start; };
+
+    std::sort(m_modules.begin(), m_modules.end(), by_start);
+    std::sort(m_allocations.begin(), m_allocations.end(), by_start);
+    std::sort(m_cached.begin(), m_cached.end(), by_start);
+}
+
+const RegionIndex::Range* RegionIndex::find_range(const std::vector<Range>& ranges, uintptr_t addr) {
+    // First range that starts after addr, the one before it is the only candidate.
+    auto it = std::upper_bound(
+        ranges.begin(), ranges.end(), addr, [](uintptr_t addr, const Range& r) { return addr < r.start; });
+
+    if (it == ranges.begin()) {
+        return nullptr;
+    }
+
+    --it;
+
+    if (addr >= it->end) {
+        return nullptr;
+    }
+
+    return &*it;
+}
+
+std::optional<RegionIndex::Region> RegionIndex::region_within(uintptr_t addr) const {
+    auto allocation = find_range(m_allocations, addr);
+    auto module = find_range(m_modules, addr);
+
+    if (allocation == nullptr && module == nullptr) {
+        return std::nullopt;
+    }
+
+    Region r{};
+
+    if (allocation != nullptr) {
+        r.start = allocation->start;
+        r.end = allocation->end;
+        r.allocation = allocation->index;
+
+        if (allocation->index < m_protection.size()) {
+            auto protection = m_protection[allocation->index];
+
+            r.read = protection & READ;
+            r.write = protection & WRITE;
+            r.execute = protection & EXECUTE;
+        }
+    } else {
+        r.start = module->start;
+        r.end = module->end;
+    }
+
+    if (module != nullptr) {
+        r.module = module->index;
+    }
+
+    r.cached = cached_within(addr);
+
+    return r;
+}
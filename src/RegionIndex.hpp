@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Sorted, immutable index over a process's address space. Built once from a module/allocation snapshot and answers
+// "which module, which allocation, what protection, is it cached" in O(log n). Lookups return indices into the
+// vectors the index was built from so it can be shared freely between threads.
+class RegionIndex {
+public:
+    static constexpr auto npos = (size_t)-1;
+
+    struct Range {
+        uintptr_t start{};
+        uintptr_t end{};
+        size_t index{npos};
+    };
+
+    struct Region {
+        uintptr_t start{};
+        uintptr_t end{};
+        size_t module{npos};
+        size_t allocation{npos};
+        // Same as allocation when the allocation is served from the read-only page cache.
+        size_t cached{npos};
+
+        bool read{};
+        bool write{};
+        bool execute{};
+    };
+
+    RegionIndex() = default;
+
+    // Each range list may be in any order, they are sorted by start address here.
+    RegionIndex(std::vector<Range> modules, std::vector<Range> allocations, std::vector<Range> cached,
+        std::vector<uint8_t> allocation_protection);
+
+    size_t module_within(uintptr_t addr) const { return find(m_modules, addr); }
+    size_t allocation_within(uintptr_t addr) const { return find(m_allocations, addr); }
+    size_t cached_within(uintptr_t addr) const { return find(m_cached, addr); }
+
+    // Everything we know about the allocation containing addr.
+    std::optional<Region> region_within(uintptr_t addr) const;
+
+    bool empty() const { return m_allocations.empty() && m_modules.empty(); }
+
+    enum Protection : uint8_t {
+        READ = 1 << 0,
+        WRITE = 1 << 1,
+        EXECUTE = 1 << 2,
+    };
+
+private:
+    std::vector<Range> m_modules{};
+    std::vector<Range> m_allocations{};
+    std::vector<Range> m_cached{};
+
+    // Indexed by allocation index (not sorted position).
+    std::vector<uint8_t> m_protection{};
+
+    static const Range* find_range(const std::vector<Range>& ranges, uintptr_t addr);
+    static size_t find(const std::vector<Range>& ranges, uintptr_t addr) {
+        auto range = find_range(ranges, addr);
+        return range != nullptr ? range->index : npos;
+    }
+};
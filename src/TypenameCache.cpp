@@ -0,0 +1,63 @@
+#include <mutex>
+
+#include "TypenameCache.hpp"
+
+std::optional<std::optional<std::string>> TypenameCache::find(uintptr_t vtable) {
+    std::shared_lock _{m_mtx};
+
+    auto search = m_names.find(vtable);
+
+    if (search == m_names.end()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    (search->second ? m_hits : m_negative_hits).fetch_add(1, std::memory_order_relaxed);
+    return search->second;
+}
+
+void TypenameCache::insert(uintptr_t vtable, std::optional<std::string> name) {
+    std::unique_lock _{m_mtx};
+
+    if (m_names.size() >= MAX_ENTRIES) {
+        m_names.clear();
+    }
+
+    m_names.insert_or_assign(vtable, std::move(name));
+}
+
+void TypenameCache::invalidate(uintptr_t start, uintptr_t end) {
+    std::unique_lock _{m_mtx};
+
+    auto erased = std::erase_if(m_names, [start, end](auto&& kv) { return kv.first >= start && kv.first < end; });
+
+    m_invalidations.fetch_add(erased, std::memory_order_relaxed);
+}
+
+void TypenameCache::clear() {
+    std::unique_lock _{m_mtx};
+    m_names.clear();
+}
+
+TypenameCache::Stats TypenameCache::stats() const {
+    Stats stats{};
+
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.negative_hits = m_negative_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    stats.rejections = m_rejections.load(std::memory_order_relaxed);
+    stats.invalidations = m_invalidations.load(std::memory_order_relaxed);
+
+    std::shared_lock _{m_mtx};
+    stats.entries = m_names.size();
+
+    return stats;
+}
+
+void TypenameCache::reset_stats() {
+    m_hits = 0;
+    m_negative_hits = 0;
+    m_misses = 0;
+    m_rejections = 0;
+    m_invalidations = 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// RTTI names by vtable address. Negative results are kept too, most lookups during a sweep are for values that turn
+// out not to be vtables. A vtable never changes its class while its module stays loaded, so entries only go away when
+// the range they're in is invalidated (module load/unload).
+class TypenameCache {
+public:
+    struct Stats {
+        size_t hits{};
+        size_t negative_hits{};
+        size_t misses{};
+        // Candidates outside every module, turned away before the cache was even consulted.
+        size_t rejections{};
+        size_t invalidations{};
+        size_t entries{};
+    };
+
+    // nullopt if vtable isn't cached, otherwise the cached result (which may itself be a negative).
+    std::optional<std::optional<std::string>> find(uintptr_t vtable);
+    void insert(uintptr_t vtable, std::optional<std::string> name);
+    void reject() { m_rejections.fetch_add(1, std::memory_order_relaxed); }
+
+    // Drops every entry in [start, end).
+    void invalidate(uintptr_t start, uintptr_t end);
+    void clear();
+
+    Stats stats() const;
+    void reset_stats();
+
+private:
+    // Past this many we start over, a sweep over garbage shouldn't grow the cache without bound.
+    static constexpr size_t MAX_ENTRIES = 1 << 18;
+
+    mutable std::shared_mutex m_mtx{};
+    std::unordered_map<uintptr_t, std::optional<std::string>> m_names{};
+
+    // Counted outside the lock so lookups only ever take it shared.
+    std::atomic<size_t> m_hits{};
+    std::atomic<size_t> m_negative_hits{};
+    std::atomic<size_t> m_misses{};
+    std::atomic<size_t> m_rejections{};
+    std::atomic<size_t> m_invalidations{};
+};
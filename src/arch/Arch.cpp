@@ -1,17 +1,43 @@
 #ifdef _WIN32
 #include "Windows.hpp"
+#elif defined(__linux__)
+#include "Linux.hpp"
 #endif
 
+#include <spdlog/spdlog.h>
+
+#include "backend/LocalProcess.hpp"
+#include "backend/SharedMemoryProcess.hpp"
+
 #include "Arch.hpp"
 
 std::unique_ptr<Helpers> arch::make_helpers() {
 #ifdef _WIN32
     return std::make_unique<arch::WindowsHelpers>();
+#elif defined(__linux__)
+    return std::make_unique<arch::LinuxHelpers>();
 #endif
 }
 
-std::unique_ptr<Process> arch::open_process(uint32_t process_id) {
+std::unique_ptr<Process> arch::open_process(uint32_t process_id, AttachProgress* progress) {
 #ifdef _WIN32
-    return std::make_unique<arch::WindowsProcess>(process_id);
+    auto process = std::make_unique<arch::WindowsProcess>(process_id, progress);
+#elif defined(__linux__)
+    auto process = std::make_unique<arch::LinuxProcess>((pid_t)process_id, progress);
 #endif
+
+    // Looking at ourselves (ReGenny injected into the target), skip the kernel for reads.
+    if (process_id == LocalProcess::current_process_id() && process->ok()) {
+        return std::make_unique<LocalProcess>(std::move(process));
+    }
+
+    // An agent loaded into the target serves reads from the inside, much cheaper than a syscall per read.
+    if (process->ok()) {
+        if (auto region = SharedMemoryProcess::open_agent(process_id); region != nullptr) {
+            spdlog::info("Using the shared memory agent in {}", process_id);
+            return std::make_unique<SharedMemoryProcess>(std::move(process), std::move(region));
+        }
+    }
+
+    return process;
 }
@@ -5,7 +5,10 @@
 #include "Helpers.hpp"
 #include "Process.hpp"
 
+struct AttachProgress;
+
 namespace arch {
 std::unique_ptr<Helpers> make_helpers();
-std::unique_ptr<Process> open_process(uint32_t process_id);
+// progress is optional, when given it's updated as the process is opened and checked for cancellation.
+std::unique_ptr<Process> open_process(uint32_t process_id, AttachProgress* progress = nullptr);
 } // namespace arch
\ No newline at end of file
@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "AttachJob.hpp"
+
+#include "Linux.hpp"
+
+namespace arch {
+LinuxProcess::LinuxProcess(pid_t process_id, AttachProgress* progress) : Process{}, m_pid{process_id} {
+    auto proc_path = "/proc/" + std::to_string(m_pid);
+
+    // Writing through /proc/<pid>/mem requires ptrace access; fall back to read-only if we don't have it.
+    m_mem_fd = open((proc_path + "/mem").c_str(), O_RDWR | O_CLOEXEC);
+
+    if (m_mem_fd == -1) {
+        m_mem_fd = open((proc_path + "/mem").c_str(), O_RDONLY | O_CLOEXEC);
+    }
+
+    if (!read_maps(m_modules, m_allocations, progress)) {
+        m_pid = 0;
+        return;
+    }
+
+    if (progress != nullptr) {
+        progress->phase = AttachProgress::Phase::INDEXING;
+    }
+
+    rebuild_region_index();
+}
+
+bool LinuxProcess::read_maps(
+    std::vector<Module>& modules, std::vector<Allocation>& allocations, AttachProgress* progress) const {
+    std::ifstream maps{"/proc/" + std::to_string(m_pid) + "/maps"};
+
+    if (!maps) {
+        return false;
+    }
+
+    // Module name -> index into modules. Shared objects are mapped as several consecutive segments (one per
+    // protection) so we merge every segment with the same backing file into one module.
+    std::unordered_map<std::string, size_t> module_indices{};
+    std::string line{};
+
+    // Modules come out of the same walk as the regions.
+    if (progress != nullptr) {
+        progress->phase = AttachProgress::Phase::REGIONS;
+    }
+
+    while (std::getline(maps, line)) {
+        if (progress != nullptr && progress->cancelled()) {
+            return false;
+        }
+
+        unsigned long long start{}, end{}, offset{}, inode{};
+        char perms[5]{};
+        char dev[16]{};
+        int path_pos{};
+
+        if (std::sscanf(line.c_str(), "%llx-%llx %4s %llx %15s %llu %n", &start, &end, perms, &offset, dev, &inode,
+                &path_pos) < 6) {
+            continue;
+        }
+
+        std::string path{};
+
+        if (path_pos > 0 && path_pos < (int)line.size()) {
+            path = line.substr(path_pos);
+        }
+
+        Allocation a{};
+
+        a.start = (uintptr_t)start;
+        a.end = (uintptr_t)end;
+        a.size = a.end - a.start;
+        a.read = perms[0] == 'r';
+        a.write = perms[1] == 'w';
+        a.execute = perms[2] == 'x';
+
+        // [vvar] and friends are readable according to maps but can't be read through process_vm_readv.
+        if (!a.read || path == "[vvar]" || path == "[vsyscall]") {
+            continue;
+        }
+
+        if (!path.empty() && path.front() == '/') {
+            if (auto search = module_indices.find(path); search != module_indices.end()) {
+                auto& m = modules[search->second];
+
+                m.start = std::min(m.start, a.start);
+                m.end = std::max(m.end, a.end);
+                m.size = m.end - m.start;
+            } else {
+                Module m{};
+
+                m.name = path;
+                m.start = a.start;
+                m.end = a.end;
+                m.size = m.end - m.start;
+
+                module_indices[path] = modules.size();
+                modules.emplace_back(std::move(m));
+            }
+        }
+
+        if (progress != nullptr) {
+            progress->modules = modules.size();
+            progress->regions = allocations.size() + 1;
+
+            if (!a.write) {
+                progress->bytes_cached += a.size;
+            }
+        }
+
+        allocations.emplace_back(std::move(a));
+    }
+
+    return true;
+}
+
+std::optional<Process::MapSnapshot> LinuxProcess::snapshot_map() {
+    MapSnapshot snapshot{};
+
+    if (m_pid == 0 || !read_maps(snapshot.modules, snapshot.allocations, nullptr)) {
+        return std::nullopt;
+    }
+
+    return snapshot;
+}
+
+LinuxProcess::~LinuxProcess() {
+    if (m_suspended) {
+        resume();
+    }
+
+    if (m_mem_fd != -1) {
+        close(m_mem_fd);
+    }
+}
+
+uint32_t LinuxProcess::process_id() {
+    return (uint32_t)m_pid;
+}
+
+bool LinuxProcess::ok() {
+    if (m_pid == 0) {
+        return false;
+    }
+
+    // EPERM still means the process exists, we just aren't allowed to signal it.
+    if (kill(m_pid, 0) == -1 && errno != EPERM) {
+        return false;
+    }
+
+    // Zombies still accept signals but their address space is gone.
+    std::ifstream stat{"/proc/" + std::to_string(m_pid) + "/stat"};
+    std::string stat_line{};
+
+    if (!std::getline(stat, stat_line)) {
+        return false;
+    }
+
+    auto comm_end = stat_line.rfind(')');
+
+    return comm_end == std::string::npos || comm_end + 2 >= stat_line.size() || stat_line[comm_end + 2] != 'Z';
+}
+
+bool LinuxProcess::all_threads_stopped() const {
+    auto task_path = "/proc/" + std::to_string(m_pid) + "/task";
+    auto dir = opendir(task_path.c_str());
+
+    if (dir == nullptr) {
+        return false;
+    }
+
+    auto stopped = true;
+    char stat[512]{};
+
+    while (auto entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        auto fd = open((task_path + "/" + entry->d_name + "/stat").c_str(), O_RDONLY | O_CLOEXEC);
+
+        // The thread exited in the meantime.
+        if (fd == -1) {
+            continue;
+        }
+
+        auto n = ::read(fd, stat, sizeof(stat) - 1);
+        close(fd);
+
+        if (n <= 0) {
+            continue;
+        }
+
+        stat[n] = '\0';
+
+        // The state follows the parenthesised comm, which may itself contain spaces and parentheses.
+        auto comm_end = strrchr(stat, ')');
+
+        if (comm_end == nullptr || comm_end + 2 >= stat + n) {
+            continue;
+        }
+
+        if (auto state = comm_end[2]; state != 'T' && state != 't' && state != 'Z' && state != 'X') {
+            stopped = false;
+            break;
+        }
+    }
+
+    closedir(dir);
+    return stopped;
+}
+
+bool LinuxProcess::suspend() {
+    if (m_pid == 0 || m_suspended) {
+        return false;
+    }
+
+    if (all_threads_stopped()) {
+        return true;
+    }
+
+    if (kill(m_pid, SIGSTOP) == -1) {
+        return false;
+    }
+
+    m_suspended = true;
+
+    // The group stop is asynchronous: kill() returns before the threads have actually stopped, and one that's still
+    // running can tear whatever we read next. Threads stuck in an uninterruptible syscall can take a while, so don't
+    // wait forever on them.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{20};
+
+    while (!all_threads_stopped()) {
+        // Some thread is still running, so reads wouldn't be consistent. Callers don't resume() a failed suspend(),
+        // send the SIGCONT here rather than leave the threads that did stop stopped.
+        if (std::chrono::steady_clock::now() >= deadline) {
+            resume();
+            return false;
+        }
+
+        sched_yield();
+    }
+
+    return true;
+}
+
+void LinuxProcess::resume() {
+    if (!m_suspended) {
+        return;
+    }
+
+    m_suspended = false;
+    kill(m_pid, SIGCONT);
+}
+
+bool LinuxProcess::handle_write(uintptr_t address, const void* buffer, size_t size) {
+    iovec local{(void*)buffer, size};
+    iovec remote{(void*)address, size};
+
+    if (process_vm_writev(m_pid, &local, 1, &remote, 1, 0) == (ssize_t)size) {
+        return true;
+    }
+
+    // process_vm_writev respects page protections, /proc/<pid>/mem doesn't (same as WriteProcessMemory).
+    if (m_mem_fd == -1) {
+        return false;
+    }
+
+    return pwrite(m_mem_fd, buffer, size, (off_t)address) == (ssize_t)size;
+}
+
+bool LinuxProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    iovec local{buffer, size};
+    iovec remote{(void*)address, size};
+
+    if (process_vm_readv(m_pid, &local, 1, &remote, 1, 0) == (ssize_t)size) {
+        return true;
+    }
+
+    if (m_mem_fd == -1) {
+        return false;
+    }
+
+    return pread(m_mem_fd, buffer, size, (off_t)address) == (ssize_t)size;
+}
+
+void LinuxProcess::handle_read_batch(std::span<ReadRequest> requests) {
+    // process_vm_readv takes at most IOV_MAX iovecs per side.
+    constexpr size_t MAX_IOVECS = 1024;
+
+    std::vector<iovec> local{};
+    std::vector<iovec> remote{};
+
+    local.reserve(std::min(requests.size(), MAX_IOVECS));
+    remote.reserve(std::min(requests.size(), MAX_IOVECS));
+
+    for (size_t i = 0; i < requests.size();) {
+        auto count = std::min(requests.size() - i, MAX_IOVECS);
+
+        local.clear();
+        remote.clear();
+
+        for (size_t j = i; j < i + count; ++j) {
+            local.emplace_back(requests[j].buffer, requests[j].size);
+            remote.emplace_back((void*)requests[j].address, requests[j].size);
+        }
+
+        // A partial read stops at the first remote iovec that couldn't be read completely. Everything before it is
+        // done; that one is retried on its own (which also gets the /proc/<pid>/mem fallback) and we carry on after.
+        auto bytes_read = process_vm_readv(m_pid, local.data(), count, remote.data(), count, 0);
+        auto remaining = bytes_read > 0 ? (size_t)bytes_read : 0;
+        auto j = i;
+
+        for (; j < i + count && remaining >= requests[j].size; ++j) {
+            requests[j].ok = true;
+            remaining -= requests[j].size;
+        }
+
+        if (j < i + count) {
+            auto&& r = requests[j];
+            r.ok = handle_read(r.address, r.buffer, r.size);
+            ++j;
+        }
+
+        i = j;
+    }
+}
+
+std::map<uint32_t, std::string> LinuxHelpers::processes() {
+    std::map<uint32_t, std::string> pids{};
+    std::error_code ec{};
+
+    for (auto&& entry : std::filesystem::directory_iterator{"/proc", ec}) {
+        auto&& filename = entry.path().filename().string();
+
+        if (filename.empty() || filename.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+
+        auto pid = (uint32_t)std::stoul(filename);
+
+        // Prefer the executable's filename (like szExeFile on Windows), comm is truncated to 15 characters.
+        if (auto exe = std::filesystem::read_symlink(entry.path() / "exe", ec); !ec) {
+            pids[pid] = exe.filename().string();
+            continue;
+        }
+
+        std::ifstream comm{entry.path() / "comm"};
+        std::string name{};
+
+        if (std::getline(comm, name)) {
+            pids[pid] = name;
+        }
+    }
+
+    return pids;
+}
+} // namespace arch
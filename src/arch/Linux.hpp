@@ -0,0 +1,48 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include "Helpers.hpp"
+#include "Process.hpp"
+
+struct AttachProgress;
+
+namespace arch {
+class LinuxProcess : public Process {
+public:
+    LinuxProcess(pid_t process_id, AttachProgress* progress = nullptr);
+    virtual ~LinuxProcess();
+
+    uint32_t process_id() override;
+    bool ok() override;
+
+    std::optional<MapSnapshot> snapshot_map() override;
+
+    // SIGSTOP/SIGCONT. A target something else already stopped (a debugger, job control) is left stopped.
+    bool suspend() override;
+    void resume() override;
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override;
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+    void handle_read_batch(std::span<ReadRequest> requests) override;
+
+private:
+    pid_t m_pid{};
+    // /proc/<pid>/mem, used when process_vm_readv/process_vm_writev are unavailable or fail.
+    int m_mem_fd{-1};
+    // We sent the SIGSTOP that's currently in effect.
+    bool m_suspended{};
+
+    // True once every thread of the target is in a stopped (or dead) state.
+    bool all_threads_stopped() const;
+
+    // Parses /proc/<pid>/maps. Doesn't touch any members so it can run next to readers.
+    bool read_maps(std::vector<Module>& modules, std::vector<Allocation>& allocations, AttachProgress* progress) const;
+};
+
+class LinuxHelpers : public Helpers {
+public:
+    std::map<uint32_t, std::string> processes() override;
+};
+} // namespace arch
@@ -1,39 +1,33 @@
 #pragma once
 
-#include <array>
-
 #include <Windows.h>
-#include <rttidata.h>
-#include <vcruntime_typeinfo.h>
 
 #include "Helpers.hpp"
 #include "Process.hpp"
 
+struct AttachProgress;
+
 namespace arch {
 class WindowsProcess : public Process {
 public:
-    WindowsProcess(DWORD process_id);
+    WindowsProcess(DWORD process_id, AttachProgress* progress = nullptr);
 
     uint32_t process_id() override;
     bool ok() override;
 
-    std::optional<std::string> get_typename(uintptr_t ptr) override;
-    std::optional<std::string> get_typename_from_vtable(uintptr_t ptr) override;
+    std::optional<MapSnapshot> snapshot_map() override;
+
+    // NtSuspendProcess/NtResumeProcess.
+    bool suspend() override;
+    void resume() override;
+
+    bool has_rtti() override { return true; }
 
     // RTTI
     std::optional<uintptr_t> get_complete_object_locator_ptr_from_vtable(uintptr_t vtable);
     std::optional<uintptr_t> get_complete_object_locator_ptr(uintptr_t ptr);
-    std::optional<_s_RTTICompleteObjectLocator> get_complete_object_locator(uintptr_t ptr);
-    std::optional<uintptr_t> resolve_object_base_address(uintptr_t ptr); // subtracts value of RTTICompleteObjectLocator.offset
+    std::optional<uintptr_t> resolve_object_base_address(uintptr_t ptr); // subtracts the locator's offset
     std::vector<uintptr_t> get_objects_of_type(uintptr_t start, size_t size, const std::string_view& type_name);
-    
-    std::optional<std::array<uint8_t, sizeof(std::type_info) + 256>> try_get_typeinfo_from_locator(uintptr_t locator_ptr);
-    std::optional<std::array<uint8_t, sizeof(std::type_info) + 256>> try_get_typeinfo_from_ptr(uintptr_t ptr);
-    std::optional<std::array<uint8_t, sizeof(std::type_info) + 256>> try_get_typeinfo_from_vtable(uintptr_t vtable);
-
-    // Inheritance checking
-    bool derives_from(uintptr_t obj_ptr, const std::string_view& type_name);
-    bool derives_from(uintptr_t obj_ptr, const std::array<uint8_t, sizeof(std::type_info) + 256>& ti_compare);
 
     HANDLE create_remote_thread(uintptr_t address, uintptr_t param);
 
@@ -45,6 +39,9 @@ protected:
 
 private:
     HANDLE m_process{};
+
+    // Enumerates modules and allocations without touching any members so it can run next to readers.
+    bool read_map(std::vector<Module>& modules, std::vector<Allocation>& allocations, AttachProgress* progress) const;
 };
 
 class WindowsHelpers : public Helpers {
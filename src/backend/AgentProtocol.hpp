@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Layout of the shared memory region between an in-target agent (agent/Agent.cpp) and SharedMemoryProcess.
+//
+// The region is a Header, then SLOTS request slots, then a data arena. It's a single-producer single-consumer ring:
+// the client fills slots and bumps submitted, the agent serves them in order and bumps completed. Read results are
+// copied by the agent straight from its own memory into the arena, and the client reads them from there; write data
+// goes the other way. Arena space is handed out by the client alone and reclaimed in submission order, so neither
+// side ever has to allocate or lock.
+namespace agent {
+constexpr uint32_t MAGIC = 0x544E4741; // "AGNT"
+constexpr uint32_t VERSION = 1;
+
+constexpr size_t SLOTS = 1024;
+constexpr size_t ARENA_SIZE = 16 * 1024 * 1024;
+// Reads larger than this are split so one request can't hog the arena.
+constexpr size_t MAX_REQUEST_SIZE = 1024 * 1024;
+
+enum class State : uint32_t {
+    STARTING,
+    RUNNING,
+    STOPPED,
+};
+
+enum class Op : uint32_t {
+    READ,
+    WRITE,
+};
+
+enum class Status : uint32_t {
+    PENDING,
+    OK,
+    FAULT,
+};
+
+struct Slot {
+    uint64_t address{};
+    uint64_t arena_offset{};
+    uint64_t size{};
+    Op op{};
+    Status status{};
+};
+
+struct Header {
+    uint32_t magic{};
+    uint32_t version{};
+    uint32_t pid{};
+    uint32_t slots{};
+    uint64_t arena_size{};
+    std::atomic<State> state{};
+    // Process id of the SharedMemoryProcess using the ring, 0 if none. Only one client at a time.
+    std::atomic<uint32_t> client{};
+    // Non-zero while the agent is parked waiting on doorbell; the client only rings it then.
+    std::atomic<uint32_t> sleeping{};
+    std::atomic<uint32_t> doorbell{};
+
+    // Each counter is written by one side only, keep them off each other's cache lines.
+    alignas(64) std::atomic<uint64_t> submitted{};
+    alignas(64) std::atomic<uint64_t> completed{};
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+    "The ring is shared between processes, its atomics can't be backed by a lock");
+
+constexpr size_t slots_offset() {
+    return (sizeof(Header) + 63) & ~(size_t)63;
+}
+
+constexpr size_t arena_offset() {
+    return (slots_offset() + sizeof(Slot) * SLOTS + 4095) & ~(size_t)4095;
+}
+
+constexpr size_t region_size() {
+    return arena_offset() + ARENA_SIZE;
+}
+
+inline Slot* slots(std::byte* region) {
+    return (Slot*)(region + slots_offset());
+}
+
+inline std::byte* arena(std::byte* region) {
+    return region + arena_offset();
+}
+
+inline std::string shm_name(uint32_t pid) {
+    return "/regenny-agent-" + std::to_string(pid);
+}
+} // namespace agent
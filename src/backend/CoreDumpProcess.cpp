@@ -0,0 +1,247 @@
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include <spdlog/spdlog.h>
+
+#include "CoreDumpProcess.hpp"
+
+namespace {
+// Just the parts of <elf.h> we need, so this builds everywhere.
+constexpr uint8_t ELFCLASS32 = 1;
+constexpr uint8_t ELFCLASS64 = 2;
+constexpr uint8_t ELFDATA2LSB = 1;
+constexpr uint16_t ET_CORE = 4;
+constexpr uint32_t PT_LOAD = 1;
+constexpr uint32_t PT_NOTE = 4;
+constexpr uint32_t PF_X = 1;
+constexpr uint32_t PF_W = 2;
+constexpr uint32_t PF_R = 4;
+constexpr uint32_t NT_PRPSINFO = 3;
+constexpr uint32_t NT_FILE = 0x46494c45;
+
+struct Elf32_Ehdr {
+    uint8_t e_ident[16];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint32_t e_entry;
+    uint32_t e_phoff;
+    uint32_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+};
+
+struct Elf64_Ehdr {
+    uint8_t e_ident[16];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint64_t e_entry;
+    uint64_t e_phoff;
+    uint64_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+};
+
+struct Elf32_Phdr {
+    uint32_t p_type;
+    uint32_t p_offset;
+    uint32_t p_vaddr;
+    uint32_t p_paddr;
+    uint32_t p_filesz;
+    uint32_t p_memsz;
+    uint32_t p_flags;
+    uint32_t p_align;
+};
+
+struct Elf64_Phdr {
+    uint32_t p_type;
+    uint32_t p_flags;
+    uint64_t p_offset;
+    uint64_t p_vaddr;
+    uint64_t p_paddr;
+    uint64_t p_filesz;
+    uint64_t p_memsz;
+    uint64_t p_align;
+};
+
+struct Elf_Nhdr {
+    uint32_t n_namesz;
+    uint32_t n_descsz;
+    uint32_t n_type;
+};
+
+constexpr uint64_t align4(uint64_t n) {
+    return (n + 3) & ~3ull;
+}
+} // namespace
+
+bool CoreDumpProcess::is_core_dump(const MappedFile& file) {
+    Elf32_Ehdr ehdr{};
+
+    if (!file.read(0, ehdr) || memcmp(ehdr.e_ident, "\x7f" "ELF", 4) != 0) {
+        return false;
+    }
+
+    return ehdr.e_ident[5] == ELFDATA2LSB && ehdr.e_type == ET_CORE;
+}
+
+CoreDumpProcess::CoreDumpProcess(const std::filesystem::path& path) : MappedProcess{path} {
+    if (!m_file.ok() || !is_core_dump(m_file)) {
+        spdlog::error("{} isn't an ELF core file", path.string());
+        return;
+    }
+
+    auto elf_class = (uint8_t)m_file.data()[4];
+
+    if (elf_class == ELFCLASS64) {
+        load<Elf64_Ehdr, Elf64_Phdr, uint64_t>();
+    } else if (elf_class == ELFCLASS32) {
+        load<Elf32_Ehdr, Elf32_Phdr, uint32_t>();
+    }
+
+    finish_segments();
+
+    m_description = fmt::format("core dump, {} segments, {} modules", m_allocations.size(), m_modules.size());
+    spdlog::info("Opened {} ({})", path.string(), m_description);
+}
+
+template <typename Ehdr, typename Phdr, typename Word> void CoreDumpProcess::load() {
+    Ehdr ehdr{};
+
+    if (!m_file.read(0, ehdr) || ehdr.e_phentsize < sizeof(Phdr)) {
+        return;
+    }
+
+    for (size_t i = 0; i < ehdr.e_phnum; ++i) {
+        Phdr phdr{};
+
+        if (!m_file.read(ehdr.e_phoff + i * ehdr.e_phentsize, phdr)) {
+            break;
+        }
+
+        if (phdr.p_type == PT_NOTE) {
+            parse_notes<Word>(phdr.p_offset, phdr.p_filesz);
+            continue;
+        }
+
+        if (phdr.p_type != PT_LOAD || phdr.p_memsz == 0) {
+            continue;
+        }
+
+        Allocation a{};
+
+        a.start = (uintptr_t)phdr.p_vaddr;
+        a.end = (uintptr_t)(phdr.p_vaddr + phdr.p_memsz);
+        a.size = a.end - a.start;
+        a.read = (phdr.p_flags & PF_R) != 0;
+        a.write = (phdr.p_flags & PF_W) != 0;
+        a.execute = (phdr.p_flags & PF_X) != 0;
+
+        // In a core file a short p_filesz means the kernel skipped the rest, not that it's .bss.
+        add_segment(a.start, a.end, phdr.p_offset, phdr.p_filesz, false);
+        m_allocations.emplace_back(std::move(a));
+    }
+}
+
+template <typename Word> void CoreDumpProcess::parse_notes(uint64_t offset, uint64_t size) {
+    auto notes = m_file.at(offset, size);
+
+    if (notes == nullptr) {
+        return;
+    }
+
+    for (uint64_t pos = 0; pos + sizeof(Elf_Nhdr) <= size;) {
+        Elf_Nhdr nhdr{};
+
+        memcpy(&nhdr, notes + pos, sizeof(nhdr));
+
+        auto desc_pos = pos + sizeof(nhdr) + align4(nhdr.n_namesz);
+        auto next = desc_pos + align4(nhdr.n_descsz);
+
+        if (next > size) {
+            break;
+        }
+
+        auto desc = notes + desc_pos;
+
+        if (nhdr.n_type == NT_FILE) {
+            parse_file_note<Word>(desc, nhdr.n_descsz);
+        } else if (nhdr.n_type == NT_PRPSINFO) {
+            // elf_prpsinfo: 4 chars, (pad), unsigned long flag, uid, gid, then pr_pid. uid/gid are 32-bit on 64-bit
+            // targets and 16-bit on i386.
+            auto pid_offset = sizeof(Word) == 8 ? 24 : 12;
+            int32_t pid{};
+
+            if (nhdr.n_descsz >= pid_offset + sizeof(pid)) {
+                memcpy(&pid, desc + pid_offset, sizeof(pid));
+                m_process_id = (uint32_t)pid;
+            }
+        }
+
+        pos = next;
+    }
+}
+
+template <typename Word> void CoreDumpProcess::parse_file_note(const std::byte* desc, size_t size) {
+    // count, page size, count * (start, end, file offset in pages), then count NUL terminated paths.
+    if (size < sizeof(Word) * 2) {
+        return;
+    }
+
+    Word count{};
+
+    memcpy(&count, desc, sizeof(Word));
+
+    // Checked before multiplying, a crafted count could wrap the product back into range.
+    if (count > (size - sizeof(Word) * 2) / (sizeof(Word) * 3)) {
+        return;
+    }
+
+    auto entries = desc + sizeof(Word) * 2;
+    auto entries_size = (uint64_t)count * sizeof(Word) * 3;
+
+    auto names = std::string_view{(const char*)entries + entries_size, (size_t)(size - sizeof(Word) * 2 - entries_size)};
+    // Libraries are mapped as several ranges, one module per path like the Linux backend does.
+    std::unordered_map<std::string_view, size_t> module_indices{};
+
+    for (Word i = 0; i < count && !names.empty(); ++i) {
+        Word range[3]{};
+
+        memcpy(range, entries + i * sizeof(range), sizeof(range));
+
+        auto name_end = names.find('\0');
+        auto name = names.substr(0, name_end);
+
+        names.remove_prefix(name_end == std::string_view::npos ? names.size() : name_end + 1);
+
+        if (auto search = module_indices.find(name); search != module_indices.end()) {
+            auto& m = m_modules[search->second];
+
+            m.start = std::min<uintptr_t>(m.start, range[0]);
+            m.end = std::max<uintptr_t>(m.end, range[1]);
+            m.size = m.end - m.start;
+        } else {
+            Module m{};
+
+            m.name = std::string{name};
+            m.start = (uintptr_t)range[0];
+            m.end = (uintptr_t)range[1];
+            m.size = m.end - m.start;
+
+            module_indices[name] = m_modules.size();
+            m_modules.emplace_back(std::move(m));
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "MappedProcess.hpp"
+
+// ELF core file (Linux, 32 or 64-bit little endian). PT_LOAD segments become allocations and the NT_FILE note
+// provides the modules. Segments the kernel didn't dump (coredump_filter) are present but unreadable.
+class CoreDumpProcess : public MappedProcess {
+public:
+    explicit CoreDumpProcess(const std::filesystem::path& path);
+
+    // True if the file starts with an ELF header of type ET_CORE.
+    static bool is_core_dump(const MappedFile& file);
+
+private:
+    template <typename Ehdr, typename Phdr, typename Word> void load();
+    template <typename Word> void parse_notes(uint64_t offset, uint64_t size);
+    template <typename Word> void parse_file_note(const std::byte* desc, size_t size);
+};
@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DIFF_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC compiles AVX2 intrinsics anywhere, GCC and Clang need them in functions targeting AVX2.
+#define DIFF_TARGET_AVX2
+#else
+#define DIFF_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#include "Timeline.hpp"
+
+#include "Diff.hpp"
+
+namespace diff {
+namespace {
+// Appends the runs of set bits in mask (bit i set means byte address + i changed).
+inline void emit_mask(uint64_t mask, uintptr_t address, std::vector<Range>& out) {
+    while (mask != 0) {
+        auto first = (size_t)std::countr_zero(mask);
+        auto run = (size_t)std::countr_one(mask >> first);
+        auto start = address + first;
+
+        if (!out.empty() && out.back().end == start) {
+            out.back().end = start + run;
+        } else {
+            out.emplace_back(start, start + run);
+        }
+
+        if (first + run >= 64) {
+            break;
+        }
+
+        mask &= ~0ull << (first + run);
+    }
+}
+
+void scan_tail(const std::byte* a, const std::byte* b, size_t size, uintptr_t address, std::vector<Range>& out) {
+    uint64_t mask{};
+
+    for (size_t i = 0; i < size; ++i) {
+        mask |= (uint64_t)(a[i] != b[i]) << i;
+    }
+
+    emit_mask(mask, address, out);
+}
+
+#ifndef DIFF_X86
+bool equal_scalar(const std::byte* a, const std::byte* b, size_t size) {
+    return memcmp(a, b, size) == 0;
+}
+
+void scan_scalar(const std::byte* a, const std::byte* b, size_t size, uintptr_t address, std::vector<Range>& out) {
+    size_t i{};
+
+    for (; i + 64 <= size; i += 64) {
+        // Most blocks are equal, only build a mask for the ones that aren't.
+        if (memcmp(a + i, b + i, 64) != 0) {
+            scan_tail(a + i, b + i, 64, address + i, out);
+        }
+    }
+
+    scan_tail(a + i, b + i, size - i, address + i, out);
+}
+#else
+bool equal_sse2(const std::byte* a, const std::byte* b, size_t size) {
+    size_t i{};
+
+    for (; i + 64 <= size; i += 64) {
+        auto x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        auto x1 = _mm_xor_si128(
+            _mm_loadu_si128((const __m128i*)(a + i + 16)), _mm_loadu_si128((const __m128i*)(b + i + 16)));
+        auto x2 = _mm_xor_si128(
+            _mm_loadu_si128((const __m128i*)(a + i + 32)), _mm_loadu_si128((const __m128i*)(b + i + 32)));
+        auto x3 = _mm_xor_si128(
+            _mm_loadu_si128((const __m128i*)(a + i + 48)), _mm_loadu_si128((const __m128i*)(b + i + 48)));
+        auto x = _mm_or_si128(_mm_or_si128(x0, x1), _mm_or_si128(x2, x3));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+    }
+
+    return memcmp(a + i, b + i, size - i) == 0;
+}
+
+void scan_sse2(const std::byte* a, const std::byte* b, size_t size, uintptr_t address, std::vector<Range>& out) {
+    size_t i{};
+
+    for (; i + 64 <= size; i += 64) {
+        uint64_t equal_mask{};
+
+        for (size_t j = 0; j < 4; ++j) {
+            auto eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i + j * 16)),
+                _mm_loadu_si128((const __m128i*)(b + i + j * 16)));
+            equal_mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(eq) << (j * 16);
+        }
+
+        if (equal_mask != ~0ull) {
+            emit_mask(~equal_mask, address + i, out);
+        }
+    }
+
+    scan_tail(a + i, b + i, size - i, address + i, out);
+}
+
+DIFF_TARGET_AVX2 bool equal_avx2(const std::byte* a, const std::byte* b, size_t size) {
+    size_t i{};
+
+    for (; i + 128 <= size; i += 128) {
+        auto x0 = _mm256_xor_si256(
+            _mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        auto x1 = _mm256_xor_si256(
+            _mm256_loadu_si256((const __m256i*)(a + i + 32)), _mm256_loadu_si256((const __m256i*)(b + i + 32)));
+        auto x2 = _mm256_xor_si256(
+            _mm256_loadu_si256((const __m256i*)(a + i + 64)), _mm256_loadu_si256((const __m256i*)(b + i + 64)));
+        auto x3 = _mm256_xor_si256(
+            _mm256_loadu_si256((const __m256i*)(a + i + 96)), _mm256_loadu_si256((const __m256i*)(b + i + 96)));
+        auto x = _mm256_or_si256(_mm256_or_si256(x0, x1), _mm256_or_si256(x2, x3));
+
+        if (!_mm256_testz_si256(x, x)) {
+            return false;
+        }
+    }
+
+    return memcmp(a + i, b + i, size - i) == 0;
+}
+
+DIFF_TARGET_AVX2 void scan_avx2(
+    const std::byte* a, const std::byte* b, size_t size, uintptr_t address, std::vector<Range>& out) {
+    size_t i{};
+
+    for (; i + 64 <= size; i += 64) {
+        auto eq0 = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        auto eq1 = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)(a + i + 32)), _mm256_loadu_si256((const __m256i*)(b + i + 32)));
+        auto equal_mask = (uint64_t)(uint32_t)_mm256_movemask_epi8(eq0) |
+                          (uint64_t)(uint32_t)_mm256_movemask_epi8(eq1) << 32;
+
+        if (equal_mask != ~0ull) {
+            emit_mask(~equal_mask, address + i, out);
+        }
+    }
+
+    scan_tail(a + i, b + i, size - i, address + i, out);
+}
+
+bool has_avx2() {
+#ifdef _MSC_VER
+    int info[4]{};
+
+    __cpuid(info, 0);
+
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // AVX and OSXSAVE, and the OS actually saves the YMM registers.
+    __cpuid(info, 1);
+
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+struct Kernel {
+    const char* name{};
+    bool (*equal)(const std::byte* a, const std::byte* b, size_t size){};
+    void (*scan)(const std::byte* a, const std::byte* b, size_t size, uintptr_t address, std::vector<Range>& out){};
+};
+
+const Kernel& kernel() {
+    static const Kernel kernel = [] {
+#ifdef DIFF_X86
+        if (has_avx2()) {
+            return Kernel{"avx2", equal_avx2, scan_avx2};
+        }
+
+        return Kernel{"sse2", equal_sse2, scan_sse2};
+#else
+        return Kernel{"scalar", equal_scalar, scan_scalar};
+#endif
+    }();
+
+    return kernel;
+}
+
+// Pages per work item. Big enough that each read is worth the round trip, small enough to spread over threads.
+constexpr size_t CHUNK_PAGES = 256;
+
+struct Chunk {
+    uintptr_t address{};
+    size_t pages{};
+};
+
+// Reads or views a chunk into buffer, falling back to page by page when the whole chunk can't be read. Returns a
+// pointer to the chunk's bytes; readable[i] tells which pages are valid.
+const std::byte* load(const Source& source, const Chunk& chunk, const std::vector<bool>& wanted,
+    std::vector<std::byte>& buffer, std::vector<bool>& readable) {
+    auto size = chunk.pages * PAGE_SIZE;
+
+    if (source.view) {
+        if (auto p = source.view(chunk.address, size)) {
+            std::fill(readable.begin(), readable.begin() + chunk.pages, true);
+            return p;
+        }
+    }
+
+    if (source.read(chunk.address, buffer.data(), size)) {
+        std::fill(readable.begin(), readable.begin() + chunk.pages, true);
+        return buffer.data();
+    }
+
+    for (size_t i = 0; i < chunk.pages; ++i) {
+        readable[i] = wanted[i] && source.read(chunk.address + i * PAGE_SIZE, buffer.data() + i * PAGE_SIZE, PAGE_SIZE);
+    }
+
+    return buffer.data();
+}
+} // namespace
+
+bool equal(const std::byte* a, const std::byte* b, size_t size) {
+    return kernel().equal(a, b, size);
+}
+
+void changed_ranges(const std::byte* a, const std::byte* b, size_t size, uintptr_t address, std::vector<Range>& out) {
+    kernel().scan(a, b, size, address, out);
+}
+
+const char* kernel_name() {
+    return kernel().name;
+}
+
+Source from_process(Process& process) {
+    Source source{};
+
+    source.read = [&process](uintptr_t address, void* buffer, size_t size) {
+        return process.read_direct(address, buffer, size);
+    };
+    source.view = [&process](uintptr_t address, size_t size) { return process.view(address, size); };
+
+    return source;
+}
+
+Source from_timeline(const Timeline& timeline, uint64_t point) {
+    Source source{};
+
+    source.read = [&timeline, point](uintptr_t address, void* buffer, size_t size) {
+        return timeline.read(point, address, buffer, size) == Timeline::ReadResult::OK;
+    };
+    source.page_id = [&timeline, point](uintptr_t page_address) -> std::optional<uint64_t> {
+        return timeline.page_id(point, page_address);
+    };
+    source.id_space = &timeline;
+
+    return source;
+}
+
+std::vector<Range> readable_ranges(const std::vector<Process::Allocation>& allocations) {
+    std::vector<Range> ranges{};
+
+    for (auto&& a : allocations) {
+        if (a.read) {
+            ranges.emplace_back(a.start, a.end);
+        }
+    }
+
+    return ranges;
+}
+
+bool Result::changed(uintptr_t start, uintptr_t end) const {
+    // First range ending after start.
+    auto it = std::upper_bound(
+        ranges.begin(), ranges.end(), start, [](uintptr_t addr, auto&& r) { return addr < r.end; });
+
+    return it != ranges.end() && it->start < end;
+}
+
+Result compare(const Source& before, const Source& after, std::vector<Range> ranges, const Options& options) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    for (auto&& r : ranges) {
+        r.start &= ~(PAGE_SIZE - 1);
+        r.end = (r.end + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](auto&& a, auto&& b) { return a.start < b.start; });
+
+    std::vector<Chunk> chunks{};
+    uintptr_t covered{};
+
+    // Overlapping ranges are only compared once.
+    for (auto&& r : ranges) {
+        for (auto address = std::max(r.start, covered); address < r.end; address += CHUNK_PAGES * PAGE_SIZE) {
+            chunks.emplace_back(address, std::min<size_t>(CHUNK_PAGES, (r.end - address) / PAGE_SIZE));
+        }
+
+        covered = std::max(covered, r.end);
+    }
+
+    auto use_ids = before.page_id && after.page_id && before.id_space != nullptr && before.id_space == after.id_space;
+    auto thread_count = options.threads != 0 ? options.threads : std::max(std::thread::hardware_concurrency(), 1u);
+
+    thread_count = std::min(thread_count, std::max<size_t>(chunks.size(), 1));
+
+    // Each chunk's ranges are kept apart so they can be joined in address order afterwards.
+    std::vector<std::vector<Range>> chunk_ranges(chunks.size());
+    std::vector<Stats> thread_stats(thread_count);
+    std::atomic<size_t> next{};
+
+    auto worker = [&](Stats& stats) {
+        std::vector<std::byte> buffer_a(CHUNK_PAGES * PAGE_SIZE);
+        std::vector<std::byte> buffer_b(CHUNK_PAGES * PAGE_SIZE);
+        std::vector<bool> wanted(CHUNK_PAGES);
+        std::vector<bool> readable_a(CHUNK_PAGES);
+        std::vector<bool> readable_b(CHUNK_PAGES);
+
+        for (auto i = next++; i < chunks.size(); i = next++) {
+            auto&& chunk = chunks[i];
+            auto&& out = chunk_ranges[i];
+            auto any_wanted = false;
+
+            stats.pages += chunk.pages;
+
+            // Pre-pass: pages with the same id on both sides are equal, no need to touch them.
+            for (size_t j = 0; j < chunk.pages; ++j) {
+                wanted[j] = true;
+
+                if (use_ids) {
+                    auto page_address = chunk.address + j * PAGE_SIZE;
+                    auto id_a = before.page_id(page_address);
+                    auto id_b = after.page_id(page_address);
+
+                    if (id_a && id_b && *id_a == *id_b) {
+                        wanted[j] = false;
+                        ++stats.pages_skipped;
+                    }
+                }
+
+                any_wanted |= wanted[j];
+            }
+
+            if (!any_wanted) {
+                continue;
+            }
+
+            auto a = load(before, chunk, wanted, buffer_a, readable_a);
+            auto b = load(after, chunk, wanted, buffer_b, readable_b);
+
+            for (size_t j = 0; j < chunk.pages; ++j) {
+                if (!wanted[j]) {
+                    continue;
+                }
+
+                auto page_address = chunk.address + j * PAGE_SIZE;
+
+                if (!readable_a[j] && !readable_b[j]) {
+                    ++stats.pages_unreadable;
+                    continue;
+                }
+
+                if (readable_a[j] != readable_b[j]) {
+                    ++stats.pages_changed;
+
+                    if (!out.empty() && out.back().end == page_address) {
+                        out.back().end += PAGE_SIZE;
+                    } else {
+                        out.emplace_back(page_address, page_address + PAGE_SIZE);
+                    }
+
+                    continue;
+                }
+
+                auto page_a = a + j * PAGE_SIZE;
+                auto page_b = b + j * PAGE_SIZE;
+
+                stats.bytes_compared += PAGE_SIZE;
+
+                // Coarse check first, most pages don't change.
+                if (kernel().equal(page_a, page_b, PAGE_SIZE)) {
+                    continue;
+                }
+
+                ++stats.pages_changed;
+                kernel().scan(page_a, page_b, PAGE_SIZE, page_address, out);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers{};
+
+    for (size_t i = 1; i < thread_count; ++i) {
+        workers.emplace_back(worker, std::ref(thread_stats[i]));
+    }
+
+    worker(thread_stats[0]);
+
+    for (auto&& t : workers) {
+        t.join();
+    }
+
+    Result result{};
+
+    for (auto&& s : thread_stats) {
+        result.stats.pages += s.pages;
+        result.stats.pages_skipped += s.pages_skipped;
+        result.stats.pages_unreadable += s.pages_unreadable;
+        result.stats.pages_changed += s.pages_changed;
+        result.stats.bytes_compared += s.bytes_compared;
+    }
+
+    for (auto&& cr : chunk_ranges) {
+        for (auto&& r : cr) {
+            result.stats.bytes_changed += r.end - r.start;
+
+            if (!result.ranges.empty() && r.start <= result.ranges.back().end + options.merge_gap) {
+                result.ranges.back().end = std::max(result.ranges.back().end, r.end);
+            } else {
+                result.ranges.emplace_back(r);
+            }
+        }
+    }
+
+    result.stats.duration = std::chrono::steady_clock::now() - start_time;
+    result.stats.kernel = kernel_name();
+
+    return result;
+}
+} // namespace diff
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Process.hpp"
+
+class Timeline;
+
+// Finds the bytes that differ between two views of the same address space (snapshots, timeline points, the live
+// process). Pages are compared with SIMD kernels picked at runtime and only pages that differ are scanned for exact
+// byte ranges.
+namespace diff {
+constexpr size_t PAGE_SIZE = 0x1000;
+
+struct Range {
+    uintptr_t start{};
+    uintptr_t end{};
+};
+
+// One side of a comparison. Everything must be safe to call from several threads at once.
+struct Source {
+    std::function<bool(uintptr_t address, void* buffer, size_t size)> read{};
+    // Optional, skips the copy when the memory is already in our address space (mapped dumps).
+    std::function<const std::byte*(uintptr_t address, size_t size)> view{};
+    // Optional content id of the page at a page aligned address. When both sides share an id_space, pages with equal
+    // ids are known to be equal without reading them (points of the same timeline).
+    std::function<std::optional<uint64_t>(uintptr_t page_address)> page_id{};
+    const void* id_space{};
+};
+
+// Reads straight from the backend, past the page caches.
+Source from_process(Process& process);
+Source from_timeline(const Timeline& timeline, uint64_t point);
+
+struct Options {
+    size_t threads{};
+    // Changed ranges closer than this are joined into one.
+    size_t merge_gap{};
+};
+
+struct Stats {
+    size_t pages{};
+    // Pages known to be equal from their ids alone.
+    size_t pages_skipped{};
+    // Pages that couldn't be read on either side.
+    size_t pages_unreadable{};
+    size_t pages_changed{};
+    size_t bytes_compared{};
+    size_t bytes_changed{};
+    std::chrono::nanoseconds duration{};
+    const char* kernel{};
+};
+
+struct Result {
+    // Sorted and non-overlapping.
+    std::vector<Range> ranges{};
+    Stats stats{};
+
+    bool changed(uintptr_t start, uintptr_t end) const;
+};
+
+// Compares before and after over ranges (rounded out to pages). A page that's only readable on one side counts as
+// changed in full.
+Result compare(const Source& before, const Source& after, std::vector<Range> ranges, const Options& options = {});
+
+// The readable allocations of a process, the usual ranges to compare.
+std::vector<Range> readable_ranges(const std::vector<Process::Allocation>& allocations);
+
+// The kernels, exposed for anything else that needs to compare memory. changed_ranges appends to out, extending its
+// last range when the first change touches it.
+bool equal(const std::byte* a, const std::byte* b, size_t size);
+void changed_ranges(const std::byte* a, const std::byte* b, size_t size, uintptr_t address, std::vector<Range>& out);
+// "avx2", "sse2" or "scalar".
+const char* kernel_name();
+} // namespace diff
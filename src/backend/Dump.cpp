@@ -0,0 +1,41 @@
+#include <spdlog/spdlog.h>
+
+#include "CoreDumpProcess.hpp"
+#include "MinidumpProcess.hpp"
+#include "PeImageProcess.hpp"
+#include "SnapshotProcess.hpp"
+
+#include "Dump.hpp"
+
+namespace backend {
+std::unique_ptr<MappedProcess> open_dump(const std::filesystem::path& path) {
+    std::unique_ptr<MappedProcess> process{};
+
+    // Only used for sniffing, the backend maps the file again itself.
+    MappedFile file{path};
+
+    if (!file.ok()) {
+        spdlog::error("Couldn't open {}", path.string());
+        return nullptr;
+    }
+
+    if (SnapshotProcess::is_snapshot(file)) {
+        process = std::make_unique<SnapshotProcess>(path);
+    } else if (CoreDumpProcess::is_core_dump(file)) {
+        process = std::make_unique<CoreDumpProcess>(path);
+    } else if (MinidumpProcess::is_minidump(file)) {
+        process = std::make_unique<MinidumpProcess>(path);
+    } else if (PeImageProcess::is_pe_image(file)) {
+        process = std::make_unique<PeImageProcess>(path);
+    } else {
+        spdlog::error("{} isn't a supported dump format", path.string());
+        return nullptr;
+    }
+
+    if (!process->ok()) {
+        return nullptr;
+    }
+
+    return process;
+}
+} // namespace backend
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+#include "MappedProcess.hpp"
+
+namespace backend {
+// Opens a dump file as a process, picking the backend from the file's contents. nullptr if the format isn't
+// recognised or the file couldn't be loaded.
+std::unique_ptr<MappedProcess> open_dump(const std::filesystem::path& path);
+} // namespace backend
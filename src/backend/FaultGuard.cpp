@@ -0,0 +1,103 @@
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <csetjmp>
+#include <csignal>
+#endif
+
+#include "FaultGuard.hpp"
+
+namespace fault_guard {
+#ifdef _WIN32
+bool copy(void* dst, const void* src, size_t size) {
+    __try {
+        memcpy(dst, src, size);
+    } __except (GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION || GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR
+                    ? EXCEPTION_EXECUTE_HANDLER
+                    : EXCEPTION_CONTINUE_SEARCH) {
+        return false;
+    }
+
+    return true;
+}
+#else
+namespace {
+// Where a faulting copy on this thread jumps back to. nullptr outside of copy(). Volatile so arming it around a memcpy
+// the compiler can see through isn't optimised away as a dead store.
+thread_local sigjmp_buf* volatile t_guard{};
+
+struct sigaction g_previous_segv{};
+struct sigaction g_previous_bus{};
+
+void chain(const struct sigaction& previous, int sig, siginfo_t* info, void* context) {
+    if ((previous.sa_flags & SA_SIGINFO) != 0 && previous.sa_sigaction != nullptr) {
+        previous.sa_sigaction(sig, info, context);
+        return;
+    }
+
+    if (previous.sa_handler == SIG_IGN) {
+        return;
+    }
+
+    if (previous.sa_handler != SIG_DFL && previous.sa_handler != nullptr) {
+        previous.sa_handler(sig);
+        return;
+    }
+
+    // Nobody else wanted it, crash like we would have without the guard.
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+void fault_handler(int sig, siginfo_t* info, void* context) {
+    if (auto guard = t_guard; guard != nullptr) {
+        t_guard = nullptr;
+        siglongjmp(*guard, 1);
+    }
+
+    chain(sig == SIGBUS ? g_previous_bus : g_previous_segv, sig, info, context);
+}
+
+void install_fault_handler() {
+    static std::once_flag once{};
+
+    std::call_once(once, [] {
+        struct sigaction sa{};
+
+        sa.sa_sigaction = fault_handler;
+        // SA_NODEFER keeps the signal unblocked after jumping out of the handler, so sigsetjmp doesn't have to save
+        // (and siglongjmp restore) the signal mask with a syscall on every copy.
+        sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+        sigemptyset(&sa.sa_mask);
+
+        sigaction(SIGSEGV, &sa, &g_previous_segv);
+        sigaction(SIGBUS, &sa, &g_previous_bus);
+    });
+}
+} // namespace
+
+bool copy(void* dst, const void* src, size_t size) {
+    install_fault_handler();
+
+    // Left uninitialised, sigsetjmp fills it and zeroing 200 bytes per copy adds up.
+    sigjmp_buf guard;
+
+    if (sigsetjmp(guard, 0) != 0) {
+        return false;
+    }
+
+    t_guard = &guard;
+    // Keep the copy between arming and disarming the guard.
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    memcpy(dst, src, size);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    t_guard = nullptr;
+
+    return true;
+}
+#endif
+} // namespace fault_guard
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+// Memory copies that fail instead of crashing when either side isn't mapped. Shared by LocalProcess and the in-target
+// agent, so it doesn't depend on anything else in ReGenny.
+namespace fault_guard {
+// Copies size bytes from src to dst. Returns false if either side faulted; dst may be partially written then.
+bool copy(void* dst, const void* src, size_t size);
+} // namespace fault_guard
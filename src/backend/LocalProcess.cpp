@@ -0,0 +1,82 @@
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "FaultGuard.hpp"
+
+#include "LocalProcess.hpp"
+
+LocalProcess::LocalProcess(std::unique_ptr<Process> inner) : Process{}, m_inner{std::move(inner)} {
+    m_modules = m_inner->modules();
+    m_allocations = m_inner->allocations();
+    m_region_index = m_inner->region_index();
+    m_map = m_region_index;
+
+    // A local read is cheaper than a page cache lookup.
+    m_mapped = true;
+}
+
+uint32_t LocalProcess::current_process_id() {
+#ifdef _WIN32
+    return (uint32_t)GetCurrentProcessId();
+#else
+    return (uint32_t)getpid();
+#endif
+}
+
+bool LocalProcess::mapped(uintptr_t address, size_t size, bool write) const {
+    auto end = address + size;
+
+    if (end < address) {
+        return false;
+    }
+
+    // Keeps this index alive for the walk even if apply_map publishes another one meanwhile.
+    auto map = m_map.load();
+
+    // Allocations can sit back to back, so walk them until the range is covered.
+    while (address < end) {
+        auto region = map->region_within(address);
+
+        if (!region || region->allocation == RegionIndex::npos || !region->read || (write && !region->write)) {
+            return false;
+        }
+
+        address = region->end;
+    }
+
+    return true;
+}
+
+void LocalProcess::apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) {
+    m_inner->apply_map(snapshot, events);
+    Process::apply_map(std::move(snapshot), events);
+    m_map = m_region_index;
+}
+
+bool LocalProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    if (!mapped(address, size, false)) {
+        return false;
+    }
+
+    return fault_guard::copy(buffer, (const void*)address, size);
+}
+
+bool LocalProcess::handle_write(uintptr_t address, const void* buffer, size_t size) {
+    if (mapped(address, size, true) && fault_guard::copy((void*)address, buffer, size)) {
+        return true;
+    }
+
+    // Read-only memory: the regular backend writes through the page protection (like WriteProcessMemory does).
+    return m_inner->write(address, buffer, size);
+}
+
+std::optional<uint64_t> LocalProcess::handle_protect(uintptr_t address, size_t size, uint64_t flags) {
+    return m_inner->protect(address, size, flags);
+}
+
+std::optional<uintptr_t> LocalProcess::handle_allocate(uintptr_t address, size_t size, uint64_t flags) {
+    return m_inner->allocate(address, size, flags);
+}
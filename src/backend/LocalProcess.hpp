@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "Process.hpp"
+
+// ReGenny's own address space, for when it runs inside the target (injected, or just looking at itself). Reads and
+// writes are plain memcpy guarded against faults (fault_guard::copy), so a bad pointer fails the read instead of
+// crashing the host. RTTI is walked by the base Process providers over those same reads. The memory map, protect and
+// allocate still go through the regular backend for this process.
+class LocalProcess : public Process {
+public:
+    explicit LocalProcess(std::unique_ptr<Process> inner);
+
+    static uint32_t current_process_id();
+
+    auto&& inner() const { return m_inner; }
+
+    uint32_t process_id() override { return m_inner->process_id(); }
+    bool ok() override { return m_inner->ok(); }
+
+    bool has_rtti() override { return m_inner->has_rtti(); }
+
+    std::optional<MapSnapshot> snapshot_map() override { return m_inner->snapshot_map(); }
+    void apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) override;
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override;
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+    std::optional<uint64_t> handle_protect(uintptr_t address, size_t size, uint64_t flags) override;
+    std::optional<uintptr_t> handle_allocate(uintptr_t address, size_t size, uint64_t flags) override;
+
+private:
+    std::unique_ptr<Process> m_inner{};
+
+    // The region index last published by apply_map. Reads happen on any thread (snapshots, timeline, read_direct
+    // users) while apply_map replaces m_region_index and m_allocations, so mapped() only ever looks at this copy.
+    std::atomic<std::shared_ptr<const RegionIndex>> m_map{};
+
+    // True if [address, address + size) lies in readable (or writable) allocations of the published map. Rejects most
+    // bad pointers without ever touching them; the fault guard catches whatever changed since the map was taken.
+    bool mapped(uintptr_t address, size_t size, bool write) const;
+};
@@ -0,0 +1,77 @@
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER size{};
+
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+
+    // The mapping keeps the file open.
+    CloseHandle(file);
+
+    if (m_mapping == nullptr) {
+        return;
+    }
+
+    m_data = (const std::byte*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (m_data != nullptr) {
+        m_size = (size_t)size.QuadPart;
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1) {
+        return;
+    }
+
+    struct stat st {};
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        auto data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED) {
+            m_data = (const std::byte*)data;
+            m_size = (size_t)st.st_size;
+        }
+    }
+
+    // The mapping keeps the file open.
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        munmap((void*)m_data, m_size);
+    }
+}
+#endif
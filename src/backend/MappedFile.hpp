@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+// Read-only view of a whole file. Pages are only faulted in when touched, so mapping a huge dump is free.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool ok() const { return m_data != nullptr; }
+    const std::byte* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    // nullptr unless [offset, offset + size) lies inside the file.
+    const std::byte* at(uint64_t offset, uint64_t size) const {
+        return offset <= m_size && size <= m_size - offset ? m_data + offset : nullptr;
+    }
+
+    // Headers in dump files aren't necessarily aligned, so structures are copied out rather than cast in place.
+    template <typename T> bool read(uint64_t offset, T& out) const {
+        auto p = at(offset, sizeof(T));
+
+        if (p == nullptr) {
+            return false;
+        }
+
+        memcpy(&out, p, sizeof(T));
+        return true;
+    }
+
+private:
+    const std::byte* m_data{};
+    size_t m_size{};
+
+#ifdef _WIN32
+    void* m_mapping{};
+#endif
+};
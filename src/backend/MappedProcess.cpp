@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cstring>
+
+#include "MappedProcess.hpp"
+
+MappedProcess::MappedProcess(const std::filesystem::path& path) : Process{}, m_file{path}, m_path{path} {
+    m_mapped = true;
+}
+
+void MappedProcess::add_segment(
+    uintptr_t start, uintptr_t end, uint64_t file_offset, uint64_t file_size, bool zero_fill) {
+    if (end <= start) {
+        return;
+    }
+
+    file_size = std::min<uint64_t>(file_size, end - start);
+
+    if (m_file.at(file_offset, file_size) == nullptr) {
+        // Truncated dump, keep whatever part of the segment made it into the file.
+        file_size = file_offset < m_file.size() ? m_file.size() - file_offset : 0;
+    }
+
+    m_segments.emplace_back(start, end, file_offset, file_size, zero_fill);
+}
+
+void MappedProcess::finish_segments() {
+    std::sort(m_segments.begin(), m_segments.end(), [](auto&& a, auto&& b) { return a.start < b.start; });
+    rebuild_region_index();
+}
+
+const MappedProcess::Segment* MappedProcess::find_segment(uintptr_t address) const {
+    auto it = std::upper_bound(
+        m_segments.begin(), m_segments.end(), address, [](uintptr_t addr, auto&& s) { return addr < s.start; });
+
+    if (it == m_segments.begin()) {
+        return nullptr;
+    }
+
+    --it;
+
+    return address < it->end ? &*it : nullptr;
+}
+
+const std::byte* MappedProcess::view(uintptr_t address, size_t size) {
+    auto segment = find_segment(address);
+
+    if (segment == nullptr || size > segment->file_size || address - segment->start > segment->file_size - size) {
+        return nullptr;
+    }
+
+    return m_file.data() + segment->file_offset + (address - segment->start);
+}
+
+bool MappedProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    auto out = (std::byte*)buffer;
+
+    // A read may run across adjacent segments (consecutive core dump PT_LOADs, PE sections).
+    while (size > 0) {
+        auto segment = find_segment(address);
+
+        if (segment == nullptr) {
+            return false;
+        }
+
+        auto offset = address - segment->start;
+        auto n = std::min<size_t>(size, segment->end - address);
+
+        if (offset + n <= segment->file_size) {
+            memcpy(out, m_file.data() + segment->file_offset + offset, n);
+        } else if (segment->zero_fill) {
+            auto in_file = offset < segment->file_size ? (size_t)(segment->file_size - offset) : 0;
+
+            if (in_file > 0) {
+                memcpy(out, m_file.data() + segment->file_offset + offset, in_file);
+            }
+
+            memset(out + in_file, 0, n - in_file);
+        } else {
+            return false;
+        }
+
+        out += n;
+        address += n;
+        size -= n;
+    }
+
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "Process.hpp"
+
+// Base for backends that lay a file out as an address space (core dumps, minidumps, PE images). Subclasses describe
+// which file ranges land where with add_segment(); reads are served straight out of the mapping.
+class MappedProcess : public Process {
+public:
+    explicit MappedProcess(const std::filesystem::path& path);
+
+    // Dumps don't always record a process id, but 0 means "not attached" to the rest of the app.
+    uint32_t process_id() override { return ok() ? std::max<uint32_t>(m_process_id, 1) : 0; }
+    bool ok() override { return m_file.ok() && !m_segments.empty(); }
+
+    const std::byte* view(uintptr_t address, size_t size) override;
+
+    auto&& path() const { return m_path; }
+    // Short description of what was loaded, for logs and the UI.
+    auto&& description() const { return m_description; }
+
+protected:
+    struct Segment {
+        uintptr_t start{};
+        uintptr_t end{};
+        uint64_t file_offset{};
+        // Bytes of the segment present in the file. Past that it reads as zeros if zero_fill is set, otherwise the
+        // memory wasn't captured and reads fail.
+        uint64_t file_size{};
+        bool zero_fill{};
+    };
+
+    MappedFile m_file;
+    std::filesystem::path m_path{};
+    uint32_t m_process_id{};
+    std::string m_description{};
+
+    // Ignored if the file range is out of bounds. Call finish_segments() once everything has been added.
+    void add_segment(uintptr_t start, uintptr_t end, uint64_t file_offset, uint64_t file_size, bool zero_fill);
+    // Sorts the segments and rebuilds the region index from m_modules/m_allocations.
+    void finish_segments();
+
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override { return false; }
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+
+private:
+    std::vector<Segment> m_segments{};
+
+    const Segment* find_segment(uintptr_t address) const;
+};
@@ -0,0 +1,326 @@
+#include <cstring>
+#include <iterator>
+
+#include <spdlog/spdlog.h>
+#include <utf8.h>
+
+#include "MinidumpProcess.hpp"
+
+namespace {
+// Layouts from minidumpapiset.h / DbgHelp.h. Everything in a minidump is little endian and 4 byte packed.
+constexpr uint32_t MINIDUMP_SIGNATURE = 0x504d444d; // "MDMP"
+
+enum StreamType : uint32_t {
+    ModuleListStream = 4,
+    MemoryListStream = 5,
+    Memory64ListStream = 9,
+    MiscInfoStream = 15,
+    MemoryInfoListStream = 16,
+};
+
+constexpr uint32_t MINIDUMP_MISC1_PROCESS_ID = 1;
+
+constexpr uint32_t MEM_COMMIT = 0x1000;
+constexpr uint32_t PAGE_NOACCESS = 0x01;
+constexpr uint32_t PAGE_GUARD = 0x100;
+constexpr uint32_t PAGE_WRITE_MASK = 0x04 | 0x08 | 0x40 | 0x80; // READWRITE, WRITECOPY, EXECUTE_READWRITE/WRITECOPY
+constexpr uint32_t PAGE_EXECUTE_MASK = 0x10 | 0x20 | 0x40 | 0x80;
+
+#pragma pack(push, 4)
+struct MINIDUMP_HEADER {
+    uint32_t Signature;
+    uint32_t Version;
+    uint32_t NumberOfStreams;
+    uint32_t StreamDirectoryRva;
+    uint32_t CheckSum;
+    uint32_t TimeDateStamp;
+    uint64_t Flags;
+};
+
+struct MINIDUMP_LOCATION_DESCRIPTOR {
+    uint32_t DataSize;
+    uint32_t Rva;
+};
+
+struct MINIDUMP_DIRECTORY {
+    uint32_t StreamType;
+    MINIDUMP_LOCATION_DESCRIPTOR Location;
+};
+
+struct MINIDUMP_MODULE {
+    uint64_t BaseOfImage;
+    uint32_t SizeOfImage;
+    uint32_t CheckSum;
+    uint32_t TimeDateStamp;
+    uint32_t ModuleNameRva;
+    uint32_t VersionInfo[13];
+    MINIDUMP_LOCATION_DESCRIPTOR CvRecord;
+    MINIDUMP_LOCATION_DESCRIPTOR MiscRecord;
+    uint64_t Reserved0;
+    uint64_t Reserved1;
+};
+
+struct MINIDUMP_MEMORY_DESCRIPTOR {
+    uint64_t StartOfMemoryRange;
+    MINIDUMP_LOCATION_DESCRIPTOR Memory;
+};
+
+struct MINIDUMP_MEMORY64_LIST {
+    uint64_t NumberOfMemoryRanges;
+    uint64_t BaseRva;
+};
+
+struct MINIDUMP_MEMORY_DESCRIPTOR64 {
+    uint64_t StartOfMemoryRange;
+    uint64_t DataSize;
+};
+
+struct MINIDUMP_MEMORY_INFO_LIST {
+    uint32_t SizeOfHeader;
+    uint32_t SizeOfEntry;
+    uint64_t NumberOfEntries;
+};
+
+struct MINIDUMP_MEMORY_INFO {
+    uint64_t BaseAddress;
+    uint64_t AllocationBase;
+    uint32_t AllocationProtect;
+    uint32_t __alignment1;
+    uint64_t RegionSize;
+    uint32_t State;
+    uint32_t Protect;
+    uint32_t Type;
+    uint32_t __alignment2;
+};
+
+struct MINIDUMP_MISC_INFO {
+    uint32_t SizeOfInfo;
+    uint32_t Flags1;
+    uint32_t ProcessId;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(MINIDUMP_HEADER) == 32);
+static_assert(sizeof(MINIDUMP_MODULE) == 108);
+static_assert(sizeof(MINIDUMP_MEMORY_DESCRIPTOR) == 16);
+static_assert(sizeof(MINIDUMP_MEMORY_INFO) == 48);
+} // namespace
+
+bool MinidumpProcess::is_minidump(const MappedFile& file) {
+    uint32_t signature{};
+
+    return file.read(0, signature) && signature == MINIDUMP_SIGNATURE;
+}
+
+MinidumpProcess::MinidumpProcess(const std::filesystem::path& path) : MappedProcess{path} {
+    MINIDUMP_HEADER header{};
+
+    if (!m_file.read(0, header) || header.Signature != MINIDUMP_SIGNATURE) {
+        spdlog::error("{} isn't a minidump", path.string());
+        return;
+    }
+
+    std::vector<Allocation> ranges{};
+    std::vector<Allocation> allocations{};
+    auto has_memory_info = false;
+
+    for (uint32_t i = 0; i < header.NumberOfStreams; ++i) {
+        MINIDUMP_DIRECTORY dir{};
+
+        if (!m_file.read(header.StreamDirectoryRva + (uint64_t)i * sizeof(dir), dir)) {
+            break;
+        }
+
+        auto rva = dir.Location.Rva;
+        auto size = dir.Location.DataSize;
+
+        switch (dir.StreamType) {
+        case ModuleListStream:
+            parse_modules(rva);
+            break;
+        case MemoryListStream:
+            parse_memory(rva, ranges);
+            break;
+        case Memory64ListStream:
+            parse_memory64(rva, ranges);
+            break;
+        case MemoryInfoListStream:
+            parse_memory_info(rva, allocations);
+            has_memory_info = true;
+            break;
+        case MiscInfoStream:
+            parse_misc_info(rva, size);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Without MemoryInfoList all we know is which ranges were captured.
+    if (has_memory_info) {
+        m_allocations = std::move(allocations);
+    } else {
+        for (auto&& a : ranges) {
+            a.read = true;
+            a.write = true;
+        }
+
+        m_allocations = std::move(ranges);
+    }
+
+    finish_segments();
+
+    m_description = fmt::format("minidump, {} allocations, {} modules", m_allocations.size(), m_modules.size());
+    spdlog::info("Opened {} ({})", path.string(), m_description);
+}
+
+void MinidumpProcess::parse_modules(uint64_t rva) {
+    uint32_t count{};
+
+    if (!m_file.read(rva, count) || !m_file.at(rva + sizeof(count), (uint64_t)count * sizeof(MINIDUMP_MODULE))) {
+        return;
+    }
+
+    m_modules.reserve(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        MINIDUMP_MODULE module{};
+
+        m_file.read(rva + sizeof(count) + (uint64_t)i * sizeof(module), module);
+
+        Module m{};
+
+        m.name = read_string(module.ModuleNameRva);
+        m.start = (uintptr_t)module.BaseOfImage;
+        m.size = module.SizeOfImage;
+        m.end = m.start + m.size;
+
+        m_modules.emplace_back(std::move(m));
+    }
+}
+
+void MinidumpProcess::parse_memory(uint64_t rva, std::vector<Allocation>& ranges) {
+    uint32_t count{};
+
+    if (!m_file.read(rva, count)) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        MINIDUMP_MEMORY_DESCRIPTOR desc{};
+
+        if (!m_file.read(rva + sizeof(count) + (uint64_t)i * sizeof(desc), desc)) {
+            break;
+        }
+
+        auto start = (uintptr_t)desc.StartOfMemoryRange;
+        auto end = start + desc.Memory.DataSize;
+
+        add_segment(start, end, desc.Memory.Rva, desc.Memory.DataSize, false);
+        ranges.emplace_back(Allocation{start, end, end - start});
+    }
+}
+
+void MinidumpProcess::parse_memory64(uint64_t rva, std::vector<Allocation>& ranges) {
+    MINIDUMP_MEMORY64_LIST list{};
+
+    if (!m_file.read(rva, list)) {
+        return;
+    }
+
+    // The ranges' data follows one another starting at BaseRva.
+    auto data_rva = list.BaseRva;
+
+    for (uint64_t i = 0; i < list.NumberOfMemoryRanges; ++i) {
+        MINIDUMP_MEMORY_DESCRIPTOR64 desc{};
+
+        if (!m_file.read(rva + sizeof(list) + i * sizeof(desc), desc)) {
+            break;
+        }
+
+        auto start = (uintptr_t)desc.StartOfMemoryRange;
+        auto end = (uintptr_t)(desc.StartOfMemoryRange + desc.DataSize);
+
+        add_segment(start, end, data_rva, desc.DataSize, false);
+        data_rva += desc.DataSize;
+
+        // Full memory dumps split regions up page run by page run, merge them back together.
+        if (ranges.empty() || ranges.back().end != start) {
+            ranges.emplace_back(Allocation{start, end, end - start});
+        } else {
+            ranges.back().end = end;
+            ranges.back().size = end - ranges.back().start;
+        }
+    }
+}
+
+void MinidumpProcess::parse_memory_info(uint64_t rva, std::vector<Allocation>& allocations) {
+    MINIDUMP_MEMORY_INFO_LIST list{};
+
+    if (!m_file.read(rva, list) || list.SizeOfEntry < sizeof(MINIDUMP_MEMORY_INFO)) {
+        return;
+    }
+
+    for (uint64_t i = 0; i < list.NumberOfEntries; ++i) {
+        MINIDUMP_MEMORY_INFO info{};
+
+        if (!m_file.read(rva + list.SizeOfHeader + i * list.SizeOfEntry, info)) {
+            break;
+        }
+
+        if (info.State != MEM_COMMIT || (info.Protect & (PAGE_NOACCESS | PAGE_GUARD)) != 0 || info.Protect == 0) {
+            continue;
+        }
+
+        Allocation a{};
+
+        a.start = (uintptr_t)info.BaseAddress;
+        a.size = (size_t)info.RegionSize;
+        a.end = a.start + a.size;
+        a.read = true;
+        a.write = (info.Protect & PAGE_WRITE_MASK) != 0;
+        a.execute = (info.Protect & PAGE_EXECUTE_MASK) != 0;
+
+        allocations.emplace_back(std::move(a));
+    }
+}
+
+void MinidumpProcess::parse_misc_info(uint64_t rva, uint64_t size) {
+    MINIDUMP_MISC_INFO info{};
+
+    if (size >= sizeof(info) && m_file.read(rva, info) && (info.Flags1 & MINIDUMP_MISC1_PROCESS_ID) != 0) {
+        m_process_id = info.ProcessId;
+    }
+}
+
+std::string MinidumpProcess::read_string(uint64_t rva) const {
+    // MINIDUMP_STRING: byte length, then UTF-16.
+    uint32_t length{};
+
+    if (!m_file.read(rva, length)) {
+        return {};
+    }
+
+    auto data = m_file.at(rva + sizeof(length), length);
+
+    if (data == nullptr) {
+        return {};
+    }
+
+    std::vector<uint16_t> utf16(length / 2);
+    std::string out{};
+
+    memcpy(utf16.data(), data, utf16.size() * sizeof(uint16_t));
+
+    try {
+        utf8::utf16to8(utf16.begin(), utf16.end(), std::back_inserter(out));
+    } catch (const utf8::exception&) {
+        out.clear();
+
+        for (auto c : utf16) {
+            out += c < 0x80 ? (char)c : '?';
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "MappedProcess.hpp"
+
+// Windows minidump (.dmp), parsed by hand so it works on any platform. Memory comes from the Memory64List stream
+// (full memory dumps) or the MemoryList stream, allocations from MemoryInfoList when present and modules from
+// ModuleList.
+class MinidumpProcess : public MappedProcess {
+public:
+    explicit MinidumpProcess(const std::filesystem::path& path);
+
+    // True if the file starts with the MDMP signature.
+    static bool is_minidump(const MappedFile& file);
+
+private:
+    void parse_modules(uint64_t rva);
+    // Add the captured ranges as segments and to ranges.
+    void parse_memory(uint64_t rva, std::vector<Allocation>& ranges);
+    void parse_memory64(uint64_t rva, std::vector<Allocation>& ranges);
+    void parse_memory_info(uint64_t rva, std::vector<Allocation>& allocations);
+    void parse_misc_info(uint64_t rva, uint64_t size);
+
+    std::string read_string(uint64_t rva) const;
+};
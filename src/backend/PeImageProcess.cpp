@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstring>
+
+#include <spdlog/spdlog.h>
+
+#include "PeImageProcess.hpp"
+
+namespace {
+// Layouts from winnt.h, only the fields we use.
+constexpr uint16_t IMAGE_DOS_SIGNATURE = 0x5a4d;    // "MZ"
+constexpr uint32_t IMAGE_NT_SIGNATURE = 0x00004550; // "PE\0\0"
+constexpr uint16_t IMAGE_NT_OPTIONAL_HDR32_MAGIC = 0x10b;
+constexpr uint16_t IMAGE_NT_OPTIONAL_HDR64_MAGIC = 0x20b;
+constexpr uint32_t IMAGE_SCN_MEM_EXECUTE = 0x20000000;
+constexpr uint32_t IMAGE_SCN_MEM_READ = 0x40000000;
+constexpr uint32_t IMAGE_SCN_MEM_WRITE = 0x80000000;
+// The loader rounds PointerToRawData down to this regardless of FileAlignment.
+constexpr uint32_t RAW_DATA_ALIGNMENT = 0x200;
+
+struct IMAGE_FILE_HEADER {
+    uint16_t Machine;
+    uint16_t NumberOfSections;
+    uint32_t TimeDateStamp;
+    uint32_t PointerToSymbolTable;
+    uint32_t NumberOfSymbols;
+    uint16_t SizeOfOptionalHeader;
+    uint16_t Characteristics;
+};
+
+// Common prefix of IMAGE_OPTIONAL_HEADER32/64 up to SizeOfHeaders. ImageBase is 32-bit with BaseOfData in front of
+// it in PE32 and 64-bit in PE32+.
+struct IMAGE_OPTIONAL_HEADER_PREFIX {
+    uint16_t Magic;
+    uint8_t MajorLinkerVersion;
+    uint8_t MinorLinkerVersion;
+    uint32_t SizeOfCode;
+    uint32_t SizeOfInitializedData;
+    uint32_t SizeOfUninitializedData;
+    uint32_t AddressOfEntryPoint;
+    uint32_t BaseOfCode;
+    uint32_t BaseOfDataOrImageBaseLow;
+    uint32_t ImageBaseOrImageBaseHigh;
+    uint32_t SectionAlignment;
+    uint32_t FileAlignment;
+    uint16_t MajorOperatingSystemVersion;
+    uint16_t MinorOperatingSystemVersion;
+    uint16_t MajorImageVersion;
+    uint16_t MinorImageVersion;
+    uint16_t MajorSubsystemVersion;
+    uint16_t MinorSubsystemVersion;
+    uint32_t Win32VersionValue;
+    uint32_t SizeOfImage;
+    uint32_t SizeOfHeaders;
+};
+
+struct IMAGE_SECTION_HEADER {
+    char Name[8];
+    uint32_t VirtualSize;
+    uint32_t VirtualAddress;
+    uint32_t SizeOfRawData;
+    uint32_t PointerToRawData;
+    uint32_t PointerToRelocations;
+    uint32_t PointerToLinenumbers;
+    uint16_t NumberOfRelocations;
+    uint16_t NumberOfLinenumbers;
+    uint32_t Characteristics;
+};
+
+static_assert(sizeof(IMAGE_FILE_HEADER) == 20);
+static_assert(sizeof(IMAGE_OPTIONAL_HEADER_PREFIX) == 64);
+static_assert(sizeof(IMAGE_SECTION_HEADER) == 40);
+
+constexpr uint64_t align_up(uint64_t n, uint64_t alignment) {
+    return alignment != 0 ? (n + alignment - 1) / alignment * alignment : n;
+}
+
+// Offset of the NT headers, 0 if there aren't any.
+uint32_t nt_headers_offset(const MappedFile& file) {
+    uint16_t dos_signature{};
+    uint32_t e_lfanew{};
+    uint32_t nt_signature{};
+
+    if (!file.read(0, dos_signature) || dos_signature != IMAGE_DOS_SIGNATURE || !file.read(0x3c, e_lfanew) ||
+        !file.read(e_lfanew, nt_signature) || nt_signature != IMAGE_NT_SIGNATURE) {
+        return 0;
+    }
+
+    return e_lfanew;
+}
+} // namespace
+
+bool PeImageProcess::is_pe_image(const MappedFile& file) {
+    return nt_headers_offset(file) != 0;
+}
+
+PeImageProcess::PeImageProcess(const std::filesystem::path& path) : MappedProcess{path} {
+    auto nt_offset = nt_headers_offset(m_file);
+    IMAGE_FILE_HEADER file_header{};
+    IMAGE_OPTIONAL_HEADER_PREFIX optional_header{};
+    auto optional_offset = (uint64_t)nt_offset + sizeof(uint32_t) + sizeof(file_header);
+
+    if (nt_offset == 0 || !m_file.read(nt_offset + sizeof(uint32_t), file_header) ||
+        !m_file.read(optional_offset, optional_header)) {
+        spdlog::error("{} isn't a PE image", path.string());
+        return;
+    }
+
+    if (optional_header.Magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
+        m_image_base = (uintptr_t)(((uint64_t)optional_header.ImageBaseOrImageBaseHigh << 32) |
+                                   optional_header.BaseOfDataOrImageBaseLow);
+    } else if (optional_header.Magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+        m_image_base = optional_header.ImageBaseOrImageBaseHigh;
+    } else {
+        spdlog::error("{} has an unknown optional header magic {:x}", path.string(), optional_header.Magic);
+        return;
+    }
+
+    auto section_alignment = std::max<uint32_t>(optional_header.SectionAlignment, 1);
+    auto headers_size = align_up(optional_header.SizeOfHeaders, section_alignment);
+
+    Module m{};
+
+    m.name = path.filename().string();
+    m.start = m_image_base;
+    m.size = optional_header.SizeOfImage;
+    m.end = m.start + m.size;
+    m_modules.emplace_back(std::move(m));
+
+    add_segment(m_image_base, m_image_base + headers_size, 0, optional_header.SizeOfHeaders, true);
+    m_allocations.emplace_back(Allocation{m_image_base, m_image_base + headers_size, headers_size, true});
+
+    auto sections_offset = optional_offset + file_header.SizeOfOptionalHeader;
+
+    for (size_t i = 0; i < file_header.NumberOfSections; ++i) {
+        IMAGE_SECTION_HEADER section{};
+
+        if (!m_file.read(sections_offset + i * sizeof(section), section)) {
+            break;
+        }
+
+        auto virtual_size = section.VirtualSize != 0 ? section.VirtualSize : section.SizeOfRawData;
+        auto raw_offset = section.PointerToRawData & ~(RAW_DATA_ALIGNMENT - 1);
+        auto raw_size = std::min<uint64_t>(section.SizeOfRawData, virtual_size);
+
+        Allocation a{};
+
+        a.start = m_image_base + section.VirtualAddress;
+        a.size = align_up(virtual_size, section_alignment);
+        a.end = a.start + a.size;
+        a.read = (section.Characteristics & IMAGE_SCN_MEM_READ) != 0;
+        a.write = (section.Characteristics & IMAGE_SCN_MEM_WRITE) != 0;
+        a.execute = (section.Characteristics & IMAGE_SCN_MEM_EXECUTE) != 0;
+
+        if (a.size == 0) {
+            continue;
+        }
+
+        // Uninitialized data (.bss style sections) and the tail past SizeOfRawData read as zeros, like the loader
+        // leaves them.
+        add_segment(a.start, a.end, raw_offset, section.SizeOfRawData != 0 ? raw_size : 0, true);
+        m_allocations.emplace_back(std::move(a));
+    }
+
+    finish_segments();
+
+    m_description = fmt::format("PE image at {:x}, {} sections", m_image_base, m_allocations.size() - 1);
+    spdlog::info("Opened {} ({})", path.string(), m_description);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "MappedProcess.hpp"
+
+// A PE file (exe/dll, 32 or 64-bit) laid out the way the loader would: headers at ImageBase and every section at
+// ImageBase + its RVA, straight out of the mapped file. Meant for dumped executables, so relocations and imports are
+// left alone.
+class PeImageProcess : public MappedProcess {
+public:
+    explicit PeImageProcess(const std::filesystem::path& path);
+
+    // True if the file has DOS and NT headers.
+    static bool is_pe_image(const MappedFile& file);
+
+    uintptr_t image_base() const { return m_image_base; }
+
+private:
+    uintptr_t m_image_base{};
+};
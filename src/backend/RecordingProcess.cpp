@@ -0,0 +1,76 @@
+#include "RecordingProcess.hpp"
+
+RecordingProcess::RecordingProcess(std::unique_ptr<Process> inner, const std::filesystem::path& path)
+    : Process{}, m_inner{std::move(inner)}, m_writer{path} {
+    m_modules = m_inner->modules();
+    m_allocations = m_inner->allocations();
+    rebuild_region_index();
+
+    // Caching happens out here so the trace sees exactly the reads the backend would have.
+    m_ro_budget = m_inner->read_only_cache().budget();
+    m_epoch_enabled = m_inner->epoch_cache().enabled();
+    m_unreadable_ttl = m_inner->unreadable_cache().ttl();
+
+    m_inner->read_only_cache().budget(0);
+    m_inner->epoch_cache().enabled(false);
+    m_inner->unreadable_cache().ttl(std::chrono::milliseconds{0});
+
+    m_writer.process(m_inner->process_id());
+    m_writer.map(m_modules, m_allocations);
+}
+
+RecordingProcess::~RecordingProcess() {
+    m_writer.flush();
+}
+
+std::unique_ptr<Process> RecordingProcess::release() {
+    m_writer.flush();
+
+    m_inner->read_only_cache().budget(m_ro_budget);
+    m_inner->epoch_cache().enabled(m_epoch_enabled);
+    m_inner->unreadable_cache().ttl(m_unreadable_ttl);
+    // Refresh ticks advanced our epoch, not its, whatever it still holds is from before the recording.
+    m_inner->advance_epoch();
+
+    return std::move(m_inner);
+}
+
+void RecordingProcess::apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) {
+    m_inner->apply_map(snapshot, events);
+    m_writer.map(snapshot.modules, snapshot.allocations);
+    Process::apply_map(std::move(snapshot), events);
+}
+
+bool RecordingProcess::handle_write(uintptr_t address, const void* buffer, size_t size) {
+    return m_inner->write(address, buffer, size);
+}
+
+bool RecordingProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    auto start = std::chrono::steady_clock::now();
+    auto result = m_inner->read(address, buffer, size);
+
+    m_writer.read(address, buffer, size, std::chrono::steady_clock::now() - start, result);
+
+    return result;
+}
+
+void RecordingProcess::handle_read_batch(std::span<ReadRequest> requests) {
+    auto start = std::chrono::steady_clock::now();
+
+    m_inner->read_batch(requests);
+
+    // One latency for the whole batch, spread evenly so replaying it takes as long as it did here.
+    auto latency = (std::chrono::steady_clock::now() - start) / std::max<size_t>(requests.size(), 1);
+
+    for (auto&& r : requests) {
+        m_writer.read(r.address, r.buffer, r.size, latency, r.ok);
+    }
+}
+
+std::optional<uint64_t> RecordingProcess::handle_protect(uintptr_t address, size_t size, uint64_t flags) {
+    return m_inner->protect(address, size, flags);
+}
+
+std::optional<uintptr_t> RecordingProcess::handle_allocate(uintptr_t address, size_t size, uint64_t flags) {
+    return m_inner->allocate(address, size, flags);
+}
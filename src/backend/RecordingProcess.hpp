@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+#include "Process.hpp"
+#include "Trace.hpp"
+
+// Wraps another process and writes every read that gets past the page caches, along with the memory map, to a trace
+// file that ReplayProcess can play back.
+class RecordingProcess : public Process {
+public:
+    RecordingProcess(std::unique_ptr<Process> inner, const std::filesystem::path& path);
+    ~RecordingProcess() override;
+
+    // False if the trace file couldn't be written.
+    bool recording() const { return m_writer.ok(); }
+    auto&& inner() const { return m_inner; }
+
+    // Stops recording and hands back the wrapped process with its page caches set up as they were before.
+    std::unique_ptr<Process> release();
+
+    uint32_t process_id() override { return m_inner != nullptr ? m_inner->process_id() : 0; }
+    bool ok() override { return m_inner != nullptr && m_inner->ok(); }
+
+    std::optional<MapSnapshot> snapshot_map() override { return m_inner->snapshot_map(); }
+    void apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) override;
+
+    bool suspend() override { return m_inner->suspend(); }
+    void resume() override { m_inner->resume(); }
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override;
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+    void handle_read_batch(std::span<ReadRequest> requests) override;
+    std::optional<uint64_t> handle_protect(uintptr_t address, size_t size, uint64_t flags) override;
+    std::optional<uintptr_t> handle_allocate(uintptr_t address, size_t size, uint64_t flags) override;
+
+private:
+    std::unique_ptr<Process> m_inner{};
+    trace::Writer m_writer;
+
+    // The wrapped process's cache settings from before we turned them off.
+    size_t m_ro_budget{};
+    bool m_epoch_enabled{};
+    std::chrono::milliseconds m_unreadable_ttl{};
+};
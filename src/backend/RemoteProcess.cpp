@@ -0,0 +1,460 @@
+#include <chrono>
+
+#include <spdlog/spdlog.h>
+
+#include "RemoteProcess.hpp"
+
+using namespace remote;
+
+namespace {
+constexpr auto CONNECT_TIMEOUT = std::chrono::milliseconds{3000};
+// The process list is fetched on the UI thread, an unreachable server mustn't freeze it for long.
+constexpr auto LIST_TIMEOUT = std::chrono::milliseconds{500};
+constexpr auto LIST_RETRY = std::chrono::seconds{5};
+// Requests sent ahead of the responses we've read. Kept small enough that the unanswered requests always fit in the
+// socket buffers, otherwise both sides could end up blocked sending to each other.
+constexpr size_t WINDOW = 8;
+// Limits for one READ frame, a big batch becomes several frames that are pipelined.
+constexpr size_t MAX_READS_PER_FRAME = 512;
+constexpr size_t MAX_READ_BYTES_PER_FRAME = 256 * 1024;
+// ok() is polled every frame, don't ask the server that often.
+constexpr auto STATUS_INTERVAL = std::chrono::milliseconds{500};
+
+std::unique_ptr<Socket> handshake(const std::string& host, uint16_t port, const std::string& token, bool compress,
+    std::chrono::milliseconds timeout = CONNECT_TIMEOUT) {
+    auto socket = Socket::connect(host, port, timeout);
+
+    if (socket == nullptr) {
+        spdlog::error("Couldn't connect to {}:{}", host, port);
+        return nullptr;
+    }
+
+    Writer w{};
+    w.put(MAGIC).put(VERSION).put(compress ? HELLO_COMPRESS : 0u).put_string(token);
+
+    FrameHeader header{(uint32_t)w.data().size(), 0, Type::HELLO, 0};
+    std::vector<std::byte> payload{};
+
+    if (!send_frame(*socket, header, w.data()) || !recv_frame(*socket, header, payload)) {
+        spdlog::error("{}:{} isn't a compatible regenny-remote server", host, port);
+        return nullptr;
+    }
+
+    if (header.type == Type::ERROR) {
+        spdlog::error("{}:{} refused us: {}", host, port, Reader{payload}.get_string());
+        return nullptr;
+    }
+
+    if (header.type != Type::HELLO) {
+        spdlog::error("{}:{} isn't a compatible regenny-remote server", host, port);
+        return nullptr;
+    }
+
+    return socket;
+}
+} // namespace
+
+RemoteProcess::RemoteProcess(
+    const std::string& host, uint16_t port, const std::string& token, uint32_t process_id, bool compress)
+    : Process{}, m_address{host + ":" + std::to_string(port)} {
+    m_socket = handshake(host, port, token, compress);
+
+    if (m_socket == nullptr) {
+        return;
+    }
+
+    m_next_id = 1;
+    m_connected = true;
+
+    Writer w{};
+    w.put(process_id);
+
+    auto opened = call(Type::OPEN, std::move(w.data()));
+
+    if (!opened || Reader{*opened}.get<uint32_t>() != process_id) {
+        spdlog::error("{} couldn't open process {}", m_address, process_id);
+        m_connected = false;
+        return;
+    }
+
+    // Servers that don't say are asked about every vtable, the answers get cached either way.
+    Reader opened_reader{*opened};
+    opened_reader.get<uint32_t>();
+    auto has_rtti = opened_reader.get<uint8_t>();
+
+    m_has_rtti = !opened_reader.ok() || has_rtti != 0;
+    m_process_id = process_id;
+
+    auto snapshot = snapshot_map();
+
+    if (!snapshot) {
+        m_connected = false;
+        return;
+    }
+
+    m_modules = std::move(snapshot->modules);
+    m_allocations = std::move(snapshot->allocations);
+    rebuild_region_index();
+}
+
+bool RemoteProcess::ok() {
+    using Clock = std::chrono::steady_clock;
+
+    if (!m_connected) {
+        return false;
+    }
+
+    auto now = Clock::now().time_since_epoch().count();
+    auto next = m_next_status.load();
+
+    // Whoever wins the exchange asks, everyone else goes with the last answer.
+    if (now >= next &&
+        m_next_status.compare_exchange_strong(next, now + Clock::duration{STATUS_INTERVAL}.count())) {
+        auto status = call(Type::STATUS, {});
+
+        if (status && Reader{*status}.get<uint8_t>() == 0) {
+            m_connected = false;
+        }
+    }
+
+    return m_connected;
+}
+
+RemoteProcess::Stats RemoteProcess::stats() const {
+    std::scoped_lock _{m_mtx};
+    return m_stats;
+}
+
+bool RemoteProcess::exchange(
+    std::span<const std::pair<remote::Type, std::vector<std::byte>>> requests, const ResponseFn& fn) {
+    std::scoped_lock _{m_mtx};
+
+    if (!m_connected) {
+        return false;
+    }
+
+    auto first_id = m_next_id;
+    size_t sent{};
+    size_t received{};
+    FrameHeader header{};
+    std::vector<std::byte> payload{};
+
+    m_next_id += (uint32_t)requests.size();
+
+    auto fail = [this] {
+        if (m_connected.exchange(false)) {
+            spdlog::error("Lost connection to {}", m_address);
+            m_socket->shutdown();
+        }
+
+        return false;
+    };
+
+    while (received < requests.size()) {
+        for (; sent < requests.size() && sent - received < WINDOW; ++sent) {
+            auto&& [type, request_payload] = requests[sent];
+            FrameHeader request{(uint32_t)request_payload.size(), first_id + (uint32_t)sent, type, 0};
+
+            if (!send_frame(*m_socket, request, request_payload)) {
+                return fail();
+            }
+
+            ++m_stats.frames;
+            m_stats.bytes_sent += sizeof(request) + request_payload.size();
+        }
+
+        if (!recv_frame(*m_socket, header, payload) || header.id != first_id + (uint32_t)received) {
+            return fail();
+        }
+
+        m_stats.bytes_received += sizeof(header) + payload.size();
+
+        Reader r{payload};
+
+        if (header.type == Type::ERROR) {
+            spdlog::debug("{}: {}", m_address, r.get_string());
+        } else {
+            fn(received, header, r);
+        }
+
+        ++received;
+    }
+
+    return true;
+}
+
+std::optional<std::vector<std::byte>> RemoteProcess::call(remote::Type type, std::vector<std::byte> payload) {
+    std::pair<Type, std::vector<std::byte>> request{type, std::move(payload)};
+    std::optional<std::vector<std::byte>> response{};
+
+    exchange({&request, 1}, [&](size_t, const FrameHeader&, Reader& r) {
+        auto rest = r.rest();
+        response.emplace(rest.begin(), rest.end());
+    });
+
+    return response;
+}
+
+std::optional<Process::MapSnapshot> RemoteProcess::snapshot_map() {
+    auto response = call(Type::MAP, {});
+
+    if (!response) {
+        return std::nullopt;
+    }
+
+    Reader r{*response};
+    MapSnapshot snapshot{};
+
+    if (r.get<uint8_t>() == 0 || !read_map(r, snapshot.modules, snapshot.allocations)) {
+        return std::nullopt;
+    }
+
+    return snapshot;
+}
+
+std::optional<std::string> RemoteProcess::typename_request(remote::Type type, uintptr_t ptr) {
+    Writer w{};
+    w.put((uint64_t)ptr);
+
+    auto response = call(type, std::move(w.data()));
+
+    if (!response) {
+        return std::nullopt;
+    }
+
+    Reader r{*response};
+
+    if (r.get<uint8_t>() == 0) {
+        return std::nullopt;
+    }
+
+    return r.get_string();
+}
+
+std::optional<std::string> RemoteProcess::handle_get_typename_from_vtable(uintptr_t vtable) {
+    return typename_request(Type::VTABLE_TYPENAME, vtable);
+}
+
+bool RemoteProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    ReadRequest r{address, buffer, size};
+    handle_read_batch({&r, 1});
+    return r.ok;
+}
+
+void RemoteProcess::handle_read_batch(std::span<ReadRequest> requests) {
+    read_frames(requests, false);
+}
+
+std::optional<std::chrono::nanoseconds> RemoteProcess::handle_read_batch_suspended(std::span<ReadRequest> requests) {
+    return read_frames(requests, true);
+}
+
+std::optional<std::chrono::nanoseconds> RemoteProcess::read_frames(std::span<ReadRequest> requests, bool suspend) {
+    // A piece of one request small enough to fit in a frame. Most requests are a single piece.
+    struct Piece {
+        size_t request{};
+        size_t offset{};
+        size_t size{};
+    };
+
+    std::vector<Piece> pieces{};
+    // Pieces of each request that haven't arrived yet.
+    std::vector<uint32_t> missing(requests.size());
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto&& r = requests[i];
+
+        for (size_t offset = 0; offset < r.size; offset += MAX_READ_BYTES_PER_FRAME) {
+            pieces.emplace_back(i, offset, std::min(r.size - offset, MAX_READ_BYTES_PER_FRAME));
+            ++missing[i];
+        }
+    }
+
+    std::vector<std::pair<Type, std::vector<std::byte>>> frames{};
+    // Index of the first piece of each frame, plus one past the end.
+    std::vector<size_t> frame_starts{};
+
+    // The server handles frames in order, so bracketing the reads with SUSPEND/RESUME in the same pipeline stops the
+    // target for as long as the server takes to read, not for our round trips.
+    if (suspend) {
+        frames.emplace_back(Type::SUSPEND, std::vector<std::byte>{});
+    }
+
+    for (size_t i = 0; i < pieces.size();) {
+        auto end = i;
+        size_t bytes{};
+
+        while (end < pieces.size() && end - i < MAX_READS_PER_FRAME &&
+               bytes + pieces[end].size <= MAX_READ_BYTES_PER_FRAME) {
+            bytes += pieces[end++].size;
+        }
+
+        Writer w{};
+        w.put((uint32_t)(end - i));
+
+        for (auto j = i; j < end; ++j) {
+            w.put((uint64_t)(requests[pieces[j].request].address + pieces[j].offset)).put((uint32_t)pieces[j].size);
+        }
+
+        frame_starts.emplace_back(i);
+        frames.emplace_back(Type::READ, std::move(w.data()));
+        i = end;
+    }
+
+    frame_starts.emplace_back(pieces.size());
+
+    if (suspend) {
+        frames.emplace_back(Type::RESUME, std::vector<std::byte>{});
+    }
+
+    std::vector<std::byte> decompressed{};
+    std::optional<std::chrono::nanoseconds> pause{};
+
+    exchange(frames, [&](size_t frame, const FrameHeader& header, Reader& r) {
+        if (header.type == Type::SUSPEND) {
+            return;
+        }
+
+        if (header.type == Type::RESUME) {
+            auto was_suspended = r.get<uint8_t>() != 0;
+            auto ns = r.get<uint64_t>();
+
+            if (r.ok() && was_suspended) {
+                pause = std::chrono::nanoseconds{ns};
+            }
+
+            return;
+        }
+
+        frame -= suspend ? 1 : 0;
+
+        auto first = frame_starts[frame];
+        auto count = frame_starts[frame + 1] - first;
+        auto statuses = r.take(count);
+
+        if (statuses == nullptr) {
+            return;
+        }
+
+        auto data = r.rest();
+
+        if ((header.flags & FLAG_COMPRESSED) != 0) {
+            if (!decompress(data, decompressed)) {
+                return;
+            }
+
+            m_stats.compressed_bytes += data.size();
+            data = decompressed;
+        } else {
+            m_stats.compressed_bytes += data.size();
+        }
+
+        m_stats.raw_bytes += data.size();
+
+        size_t offset{};
+
+        for (size_t i = 0; i < count; ++i) {
+            auto&& piece = pieces[first + i];
+
+            if (statuses[i] == std::byte{0} || piece.size > data.size() - offset) {
+                continue;
+            }
+
+            memcpy((std::byte*)requests[piece.request].buffer + piece.offset, data.data() + offset, piece.size);
+            offset += piece.size;
+            --missing[piece.request];
+        }
+    });
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].ok = missing[i] == 0;
+    }
+
+    return pause;
+}
+
+bool RemoteProcess::suspend() {
+    auto response = call(Type::SUSPEND, {});
+    return response && Reader{*response}.get<uint8_t>() != 0;
+}
+
+void RemoteProcess::resume() {
+    call(Type::RESUME, {});
+}
+
+bool RemoteProcess::handle_write(uintptr_t address, const void* buffer, size_t size) {
+    Writer w{};
+    w.put((uint64_t)address).put_bytes(buffer, size);
+
+    auto response = call(Type::WRITE, std::move(w.data()));
+
+    return response && Reader{*response}.get<uint8_t>() != 0;
+}
+
+std::optional<uint64_t> RemoteProcess::memory_request(
+    remote::Type type, uintptr_t address, size_t size, uint64_t flags) {
+    Writer w{};
+    w.put((uint64_t)address).put((uint64_t)size).put(flags);
+
+    auto response = call(type, std::move(w.data()));
+
+    if (!response) {
+        return std::nullopt;
+    }
+
+    Reader r{*response};
+
+    if (r.get<uint8_t>() == 0) {
+        return std::nullopt;
+    }
+
+    return r.get<uint64_t>();
+}
+
+std::optional<uint64_t> RemoteProcess::handle_protect(uintptr_t address, size_t size, uint64_t flags) {
+    return memory_request(Type::PROTECT, address, size, flags);
+}
+
+std::optional<uintptr_t> RemoteProcess::handle_allocate(uintptr_t address, size_t size, uint64_t flags) {
+    if (auto result = memory_request(Type::ALLOCATE, address, size, flags)) {
+        return (uintptr_t)*result;
+    }
+
+    return std::nullopt;
+}
+
+std::map<uint32_t, std::string> RemoteHelpers::processes() {
+    std::map<uint32_t, std::string> processes{};
+
+    if (std::chrono::steady_clock::now() < m_retry_time) {
+        return processes;
+    }
+
+    auto socket = handshake(m_host, m_port, m_token, false, LIST_TIMEOUT);
+
+    if (socket == nullptr) {
+        m_retry_time = std::chrono::steady_clock::now() + LIST_RETRY;
+        return processes;
+    }
+
+    FrameHeader header{0, 1, Type::PROCESSES, 0};
+    std::vector<std::byte> payload{};
+
+    if (!send_frame(*socket, header, {}) || !recv_frame(*socket, header, payload) || header.type != Type::PROCESSES) {
+        return processes;
+    }
+
+    Reader r{payload};
+    auto count = r.get<uint32_t>();
+
+    for (uint32_t i = 0; i < count && r.ok(); ++i) {
+        auto pid = r.get<uint32_t>();
+        auto name = r.get_string();
+
+        if (r.ok()) {
+            processes[pid] = std::move(name);
+        }
+    }
+
+    return processes;
+}
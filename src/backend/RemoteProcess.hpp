@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Helpers.hpp"
+#include "Process.hpp"
+#include "RemoteProtocol.hpp"
+#include "Socket.hpp"
+
+// A process on another machine, served by regenny-remote (RemoteServer). Batched reads are split into READ frames that
+// are all sent before the first response is waited for, so a refresh costs about one round trip no matter how many
+// pages it touches. Returned pages are LZ4 compressed when that makes them smaller.
+class RemoteProcess : public Process {
+public:
+    // token has to match the one the server was started with.
+    RemoteProcess(const std::string& host, uint16_t port, const std::string& token, uint32_t process_id,
+        bool compress = true);
+
+    // "host:port" of the server.
+    auto&& address() const { return m_address; }
+
+    uint32_t process_id() override { return m_connected ? m_process_id : 0; }
+    bool ok() override;
+
+    std::optional<MapSnapshot> snapshot_map() override;
+
+    bool has_rtti() override { return m_has_rtti; }
+
+    // Stops the target on the server's side. Servers too old to know SUSPEND just fail it.
+    bool suspend() override;
+    void resume() override;
+
+    struct Stats {
+        size_t frames{};
+        size_t bytes_sent{};
+        size_t bytes_received{};
+        // Read data before and after compression.
+        size_t raw_bytes{};
+        size_t compressed_bytes{};
+    };
+
+    Stats stats() const;
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override;
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+    void handle_read_batch(std::span<ReadRequest> requests) override;
+    std::optional<std::chrono::nanoseconds> handle_read_batch_suspended(std::span<ReadRequest> requests) override;
+    std::optional<uint64_t> handle_protect(uintptr_t address, size_t size, uint64_t flags) override;
+    std::optional<uintptr_t> handle_allocate(uintptr_t address, size_t size, uint64_t flags) override;
+    std::optional<std::string> handle_get_typename_from_vtable(uintptr_t vtable) override;
+
+private:
+    using ResponseFn = std::function<void(size_t index, const remote::FrameHeader& header, remote::Reader& r)>;
+
+    std::string m_address{};
+    std::unique_ptr<Socket> m_socket{};
+    uint32_t m_process_id{};
+    bool m_has_rtti{};
+    std::atomic<bool> m_connected{};
+    // steady_clock ticks, when ok() asks the server again.
+    std::atomic<std::chrono::steady_clock::rep> m_next_status{};
+
+    // One conversation at a time, responses come back in request order.
+    mutable std::mutex m_mtx{};
+    uint32_t m_next_id{};
+    Stats m_stats{};
+
+    // Sends every request, keeping at most a window of them unanswered, and hands each response to fn in order. Returns
+    // false (and drops the connection) if the connection failed part way. fn isn't called for ERROR responses.
+    bool exchange(std::span<const std::pair<remote::Type, std::vector<std::byte>>> requests, const ResponseFn& fn);
+    // Single request, single response. nullopt if the connection failed or the server sent ERROR.
+    std::optional<std::vector<std::byte>> call(remote::Type type, std::vector<std::byte> payload);
+
+    // Splits the batch into pipelined READ frames, bracketed by SUSPEND/RESUME if asked to. Returns the server's pause.
+    std::optional<std::chrono::nanoseconds> read_frames(std::span<ReadRequest> requests, bool suspend);
+    std::optional<std::string> typename_request(remote::Type type, uintptr_t ptr);
+    std::optional<uint64_t> memory_request(remote::Type type, uintptr_t address, size_t size, uint64_t flags);
+};
+
+// Process list of a remote machine, for the attach dialog.
+class RemoteHelpers : public Helpers {
+public:
+    RemoteHelpers(const std::string& host, uint16_t port, const std::string& token)
+        : m_host{host}, m_port{port}, m_token{token} {}
+
+    // Empty if the server can't be reached.
+    std::map<uint32_t, std::string> processes() override;
+
+private:
+    std::string m_host{};
+    uint16_t m_port{};
+    std::string m_token{};
+    // Don't keep trying an unreachable server every time the list refreshes.
+    std::chrono::steady_clock::time_point m_retry_time{};
+};
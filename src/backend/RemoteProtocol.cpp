@@ -0,0 +1,167 @@
+#include <lz4.h>
+
+#include "RemoteProtocol.hpp"
+
+namespace remote {
+bool parse_address(const std::string& address, std::string& host, uint16_t& port) {
+    auto port_pos = std::string::npos;
+
+    if (address.starts_with('[')) {
+        auto close = address.find(']');
+
+        if (close == std::string::npos) {
+            return false;
+        }
+
+        host = address.substr(1, close - 1);
+
+        if (close + 1 < address.size()) {
+            if (address[close + 1] != ':') {
+                return false;
+            }
+
+            port_pos = close + 1;
+        }
+    } else {
+        port_pos = address.find(':');
+        host = address.substr(0, port_pos);
+    }
+
+    port = DEFAULT_PORT;
+
+    if (port_pos != std::string::npos) {
+        auto digits = address.substr(port_pos + 1);
+
+        if (digits.empty() || digits.size() > 5 || digits.find_first_not_of("0123456789") != std::string::npos ||
+            std::stoul(digits) > 65535) {
+            return false;
+        }
+
+        port = (uint16_t)std::stoul(digits);
+    }
+
+    return !host.empty();
+}
+
+bool send_frame(Socket& socket, const FrameHeader& header, std::span<const std::byte> payload) {
+    // One send for small frames, so a pipelined request doesn't go out as two segments.
+    if (payload.size() <= 4096) {
+        std::byte buffer[sizeof(FrameHeader) + 4096];
+
+        memcpy(buffer, &header, sizeof(header));
+
+        if (!payload.empty()) {
+            memcpy(buffer + sizeof(header), payload.data(), payload.size());
+        }
+
+        return socket.send_all(buffer, sizeof(header) + payload.size());
+    }
+
+    return socket.send_all(&header, sizeof(header)) && socket.send_all(payload.data(), payload.size());
+}
+
+bool recv_frame(Socket& socket, FrameHeader& header, std::vector<std::byte>& payload) {
+    if (!socket.recv_all(&header, sizeof(header)) || header.size > MAX_PAYLOAD) {
+        return false;
+    }
+
+    payload.resize(header.size);
+
+    return header.size == 0 || socket.recv_all(payload.data(), header.size);
+}
+
+void write_map(
+    Writer& w, const std::vector<Process::Module>& modules, const std::vector<Process::Allocation>& allocations) {
+    w.put((uint32_t)modules.size());
+
+    for (auto&& m : modules) {
+        w.put_string(m.name).put((uint64_t)m.start).put((uint64_t)m.end);
+    }
+
+    w.put((uint32_t)allocations.size());
+
+    for (auto&& a : allocations) {
+        w.put((uint64_t)a.start).put((uint64_t)a.end);
+        w.put((uint8_t)((a.read ? 1 : 0) | (a.write ? 2 : 0) | (a.execute ? 4 : 0)));
+    }
+}
+
+bool read_map(Reader& r, std::vector<Process::Module>& modules, std::vector<Process::Allocation>& allocations) {
+    auto module_count = r.get<uint32_t>();
+
+    for (uint32_t i = 0; i < module_count && r.ok(); ++i) {
+        Process::Module m{};
+
+        m.name = r.get_string();
+        m.start = (uintptr_t)r.get<uint64_t>();
+        m.end = (uintptr_t)r.get<uint64_t>();
+        m.size = m.end - m.start;
+
+        modules.emplace_back(std::move(m));
+    }
+
+    auto allocation_count = r.get<uint32_t>();
+
+    for (uint32_t i = 0; i < allocation_count && r.ok(); ++i) {
+        Process::Allocation a{};
+
+        a.start = (uintptr_t)r.get<uint64_t>();
+        a.end = (uintptr_t)r.get<uint64_t>();
+        a.size = a.end - a.start;
+
+        auto protection = r.get<uint8_t>();
+
+        a.read = (protection & 1) != 0;
+        a.write = (protection & 2) != 0;
+        a.execute = (protection & 4) != 0;
+
+        allocations.emplace_back(a);
+    }
+
+    return r.ok();
+}
+
+bool compress(std::span<const std::byte> data, std::vector<std::byte>& out) {
+    if (data.size() > (size_t)LZ4_MAX_INPUT_SIZE) {
+        return false;
+    }
+
+    std::vector<std::byte> compressed(sizeof(uint32_t) + LZ4_compressBound((int)data.size()));
+    auto raw_size = (uint32_t)data.size();
+
+    memcpy(compressed.data(), &raw_size, sizeof(raw_size));
+
+    auto n = LZ4_compress_default((const char*)data.data(), (char*)compressed.data() + sizeof(raw_size),
+        (int)data.size(), (int)(compressed.size() - sizeof(raw_size)));
+
+    if (n <= 0 || sizeof(raw_size) + (size_t)n >= data.size()) {
+        return false;
+    }
+
+    compressed.resize(sizeof(raw_size) + (size_t)n);
+    out = std::move(compressed);
+
+    return true;
+}
+
+bool decompress(std::span<const std::byte> data, std::vector<std::byte>& out) {
+    uint32_t raw_size{};
+
+    if (data.size() < sizeof(raw_size)) {
+        return false;
+    }
+
+    memcpy(&raw_size, data.data(), sizeof(raw_size));
+
+    if (raw_size > MAX_PAYLOAD) {
+        return false;
+    }
+
+    out.resize(raw_size);
+
+    auto n = LZ4_decompress_safe((const char*)data.data() + sizeof(raw_size), (char*)out.data(),
+        (int)(data.size() - sizeof(raw_size)), (int)raw_size);
+
+    return n == (int)raw_size;
+}
+} // namespace remote
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Process.hpp"
+#include "Socket.hpp"
+
+// Wire format between RemoteProcess and regenny-remote (RemoteServer). Every message is a FrameHeader followed by size
+// bytes of payload, little-endian throughout. The client may send any number of requests before reading responses;
+// the server answers each in order with the request's id. Reads are batched: one READ carries many (address, size)
+// pairs and its response carries a status byte for each followed by the data of the ones that succeeded, optionally
+// LZ4 compressed.
+namespace remote {
+constexpr uint32_t MAGIC = 0x4D455247; // "GREM"
+constexpr uint32_t VERSION = 2;
+constexpr uint16_t DEFAULT_PORT = 27015;
+
+// Anything bigger is a corrupt stream, not a message.
+constexpr uint32_t MAX_PAYLOAD = 64 * 1024 * 1024;
+
+enum class Type : uint16_t {
+    // Request: u32 magic, u32 version, u32 flags (HELLO_*), string token. Response: u32 magic, u32 version, u32 flags
+    // accepted. Must come first, everything else is refused until a HELLO with the server's token succeeded.
+    HELLO,
+    // Request: nothing. Response: u32 count, then (u32 pid, string name) each.
+    PROCESSES,
+    // Request: u32 pid. Response: u32 pid (0 if it couldn't be opened), u8 whether the server can name vtables.
+    OPEN,
+    // Request: nothing. Response: u8 ok.
+    STATUS,
+    // Request: nothing. Response: u8 valid, then the map (see write_map).
+    MAP,
+    // Request: u32 count, then (u64 address, u32 size) each. Response: u8 status each, then the data of every
+    // successful read back to back. With FLAG_COMPRESSED the data is u32 raw size followed by one LZ4 block.
+    READ,
+    // Request: u64 address, then the data. Response: u8 ok.
+    WRITE,
+    // Request: u64 address, u64 size, u64 flags. Response: u8 valid, u64 old flags.
+    PROTECT,
+    // Request: u64 address, u64 size, u64 flags. Response: u8 valid, u64 address.
+    ALLOCATE,
+    // Request: u64 pointer. Response: u8 valid, string name.
+    TYPENAME,
+    VTABLE_TYPENAME,
+    // Response only: string message. Sent instead of the regular response when a request can't be handled.
+    ERROR,
+    // Request: nothing. Response: u8 ok. The target stays stopped until RESUME or the connection closes.
+    SUSPEND,
+    // Request: nothing. Response: u8 was suspended, u64 nanoseconds it was stopped for.
+    RESUME,
+};
+
+enum : uint16_t {
+    FLAG_COMPRESSED = 1 << 0,
+};
+
+enum : uint32_t {
+    // The client wants READ data compressed when it pays off.
+    HELLO_COMPRESS = 1 << 0,
+};
+
+struct FrameHeader {
+    uint32_t size{};
+    uint32_t id{};
+    Type type{};
+    uint16_t flags{};
+};
+
+static_assert(sizeof(FrameHeader) == 12);
+
+// Appends to a payload.
+class Writer {
+public:
+    template <typename T> Writer& put(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return put_bytes(&value, sizeof(T));
+    }
+
+    Writer& put_bytes(const void* data, size_t size) {
+        auto p = (const std::byte*)data;
+        m_data.insert(m_data.end(), p, p + size);
+        return *this;
+    }
+
+    Writer& put_string(const std::string& s) {
+        put((uint32_t)s.size());
+        return put_bytes(s.data(), s.size());
+    }
+
+    auto&& data() { return m_data; }
+
+private:
+    std::vector<std::byte> m_data{};
+};
+
+// Consumes a payload. Reading past the end sets a sticky failure and yields zeros.
+class Reader {
+public:
+    explicit Reader(std::span<const std::byte> data) : m_data{data} {}
+
+    template <typename T> T get() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        get_bytes(&value, sizeof(T));
+        return value;
+    }
+
+    bool get_bytes(void* out, size_t size) {
+        if (auto p = take(size); p != nullptr) {
+            memcpy(out, p, size);
+            return true;
+        }
+
+        return false;
+    }
+
+    std::string get_string() {
+        auto size = get<uint32_t>();
+        auto p = take(size);
+        return p != nullptr ? std::string{(const char*)p, size} : std::string{};
+    }
+
+    // Pointer to the next size bytes, nullptr if there aren't that many left.
+    const std::byte* take(size_t size) {
+        if (!m_ok || size > m_data.size() - m_pos) {
+            m_ok = false;
+            return nullptr;
+        }
+
+        auto p = m_data.data() + m_pos;
+        m_pos += size;
+        return p;
+    }
+
+    std::span<const std::byte> rest() const { return m_data.subspan(m_pos); }
+    bool ok() const { return m_ok; }
+
+private:
+    std::span<const std::byte> m_data{};
+    size_t m_pos{};
+    bool m_ok{true};
+};
+
+// "host", "host:port" or "[v6 address]:port". Port defaults to DEFAULT_PORT.
+bool parse_address(const std::string& address, std::string& host, uint16_t& port);
+
+bool send_frame(Socket& socket, const FrameHeader& header, std::span<const std::byte> payload);
+// Fails on a closed connection or a payload larger than MAX_PAYLOAD.
+bool recv_frame(Socket& socket, FrameHeader& header, std::vector<std::byte>& payload);
+
+void write_map(
+    Writer& w, const std::vector<Process::Module>& modules, const std::vector<Process::Allocation>& allocations);
+bool read_map(Reader& r, std::vector<Process::Module>& modules, std::vector<Process::Allocation>& allocations);
+
+// Compresses data into out (u32 raw size + LZ4 block). False if it wouldn't get smaller, out is untouched then.
+bool compress(std::span<const std::byte> data, std::vector<std::byte>& out);
+bool decompress(std::span<const std::byte> data, std::vector<std::byte>& out);
+} // namespace remote
@@ -0,0 +1,388 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+#include <spdlog/spdlog.h>
+
+#include "arch/Arch.hpp"
+
+#include "RemoteProtocol.hpp"
+
+#include "RemoteServer.hpp"
+
+using namespace remote;
+
+namespace {
+// Doesn't stop at the first difference, so the time taken says nothing about how much of the token was right.
+bool token_equals(const std::string& a, const std::string& b) {
+    auto diff = a.size() ^ b.size();
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        diff |= (uint8_t)a[i] ^ (uint8_t)(i < b.size() ? b[i] : 0);
+    }
+
+    return diff == 0;
+}
+
+// One client's view: the process it opened and what it asked for in HELLO.
+struct Session {
+    Socket& socket;
+    const std::string& token;
+    // Set once HELLO presented the right token.
+    bool authenticated{};
+    std::unique_ptr<Process> process{};
+    bool compress{};
+    std::vector<std::byte> payload{};
+    // Set between SUSPEND and RESUME.
+    std::optional<std::chrono::steady_clock::time_point> suspended{};
+
+    // A client that goes away (or opens another process) mid-freeze mustn't leave the target stopped.
+    ~Session() { resume(); }
+
+    std::chrono::nanoseconds resume() {
+        if (!suspended) {
+            return {};
+        }
+
+        process->resume();
+
+        auto pause = std::chrono::steady_clock::now() - *suspended;
+        suspended.reset();
+        return pause;
+    }
+
+    bool respond(const FrameHeader& request, Writer& w, uint16_t flags = 0) {
+        FrameHeader header{(uint32_t)w.data().size(), request.id, request.type, flags};
+        return send_frame(socket, header, w.data());
+    }
+
+    bool error(const FrameHeader& request, const std::string& message) {
+        Writer w{};
+        w.put_string(message);
+
+        FrameHeader header{(uint32_t)w.data().size(), request.id, Type::ERROR, 0};
+        return send_frame(socket, header, w.data());
+    }
+
+    bool handle(const FrameHeader& request, Reader& r);
+    bool read(const FrameHeader& request, Reader& r);
+};
+
+bool Session::handle(const FrameHeader& request, Reader& r) {
+    Writer w{};
+
+    switch (request.type) {
+    case Type::HELLO: {
+        auto magic = r.get<uint32_t>();
+        auto version = r.get<uint32_t>();
+        auto flags = r.get<uint32_t>();
+        auto client_token = r.get_string();
+
+        if (!r.ok() || magic != MAGIC || version != VERSION) {
+            error(request, "Unsupported protocol version");
+            return false;
+        }
+
+        if (!token_equals(client_token, token)) {
+            spdlog::warn("{} presented the wrong token", socket.peer());
+            error(request, "Wrong token");
+            return false;
+        }
+
+        authenticated = true;
+        compress = (flags & HELLO_COMPRESS) != 0;
+        w.put(MAGIC).put(VERSION).put(flags & HELLO_COMPRESS);
+        return respond(request, w);
+    }
+
+    default:
+        break;
+    }
+
+    if (!authenticated) {
+        error(request, "Not authenticated");
+        return false;
+    }
+
+    switch (request.type) {
+    case Type::PROCESSES: {
+        auto processes = arch::make_helpers()->processes();
+
+        w.put((uint32_t)processes.size());
+
+        for (auto&& [pid, name] : processes) {
+            w.put(pid).put_string(name);
+        }
+
+        return respond(request, w);
+    }
+
+    case Type::OPEN: {
+        auto pid = r.get<uint32_t>();
+
+        resume();
+        process = arch::open_process(pid);
+
+        if (process == nullptr || !process->ok()) {
+            process.reset();
+            w.put((uint32_t)0);
+            return respond(request, w);
+        }
+
+        // Nothing advances the epoch here, every READ has to see the target as it is now.
+        process->epoch_cache().enabled(false);
+        spdlog::info("{} opened process {}", socket.peer(), pid);
+
+        w.put(pid).put((uint8_t)process->has_rtti());
+        return respond(request, w);
+    }
+
+    default:
+        break;
+    }
+
+    if (process == nullptr) {
+        return error(request, "No process open");
+    }
+
+    switch (request.type) {
+    case Type::STATUS:
+        w.put((uint8_t)process->ok());
+        return respond(request, w);
+
+    case Type::MAP: {
+        auto snapshot = process->snapshot_map();
+
+        if (!snapshot) {
+            w.put((uint8_t)0);
+            return respond(request, w);
+        }
+
+        // Keep our own copy current too, it decides what the read-only page cache may hold.
+        auto events = Process::diff_map(process->modules(), process->allocations(), *snapshot);
+
+        w.put((uint8_t)1);
+        write_map(w, snapshot->modules, snapshot->allocations);
+
+        if (!events.empty()) {
+            process->apply_map(std::move(*snapshot), events);
+        }
+
+        return respond(request, w);
+    }
+
+    case Type::READ:
+        return read(request, r);
+
+    case Type::WRITE: {
+        auto address = r.get<uint64_t>();
+        auto data = r.rest();
+
+        w.put((uint8_t)(r.ok() && process->write((uintptr_t)address, data.data(), data.size())));
+        return respond(request, w);
+    }
+
+    case Type::PROTECT:
+    case Type::ALLOCATE: {
+        auto address = r.get<uint64_t>();
+        auto size = r.get<uint64_t>();
+        auto flags = r.get<uint64_t>();
+        auto result = request.type == Type::PROTECT ? process->protect((uintptr_t)address, (size_t)size, flags)
+                                                    : process->allocate((uintptr_t)address, (size_t)size, flags);
+
+        w.put((uint8_t)result.has_value()).put((uint64_t)result.value_or(0));
+        return respond(request, w);
+    }
+
+    case Type::SUSPEND: {
+        auto start = std::chrono::steady_clock::now();
+
+        if (!suspended && process->suspend()) {
+            suspended = start;
+        }
+
+        w.put((uint8_t)suspended.has_value());
+        return respond(request, w);
+    }
+
+    case Type::RESUME: {
+        auto was_suspended = suspended.has_value();
+        auto pause = resume();
+
+        w.put((uint8_t)was_suspended).put((uint64_t)pause.count());
+        return respond(request, w);
+    }
+
+    case Type::TYPENAME:
+    case Type::VTABLE_TYPENAME: {
+        auto ptr = (uintptr_t)r.get<uint64_t>();
+        auto name =
+            request.type == Type::TYPENAME ? process->get_typename(ptr) : process->get_typename_from_vtable(ptr);
+
+        w.put((uint8_t)name.has_value()).put_string(name.value_or(""));
+        return respond(request, w);
+    }
+
+    default:
+        return error(request, "Unknown request");
+    }
+}
+
+bool Session::read(const FrameHeader& request, Reader& r) {
+    auto count = r.get<uint32_t>();
+    std::vector<Process::ReadRequest> requests{};
+    size_t total{};
+
+    requests.reserve(std::min<uint32_t>(count, MAX_PAYLOAD / 12));
+
+    for (uint32_t i = 0; i < count && r.ok(); ++i) {
+        auto address = r.get<uint64_t>();
+        auto size = r.get<uint32_t>();
+
+        requests.emplace_back((uintptr_t)address, nullptr, size);
+        total += size;
+    }
+
+    if (!r.ok() || total > MAX_PAYLOAD) {
+        return error(request, "Malformed read");
+    }
+
+    // Statuses first, data after. Everything is read in place and the failures squeezed out afterwards.
+    std::vector<std::byte> out(count + total);
+    auto data = out.data() + count;
+
+    for (size_t i = 0, offset = 0; i < requests.size(); offset += requests[i].size, ++i) {
+        requests[i].buffer = data + offset;
+    }
+
+    process->read_batch(requests);
+
+    size_t used{};
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto&& req = requests[i];
+
+        out[i] = (std::byte)req.ok;
+
+        if (req.ok) {
+            memmove(data + used, req.buffer, req.size);
+            used += req.size;
+        }
+    }
+
+    out.resize(count + used);
+
+    // Mostly pointers and zeros, LZ4 does well on those.
+    if (compress && used >= 512) {
+        std::vector<std::byte> compressed{};
+
+        if (remote::compress({data, used}, compressed)) {
+            out.resize(count);
+            out.insert(out.end(), compressed.begin(), compressed.end());
+
+            FrameHeader header{(uint32_t)out.size(), request.id, request.type, FLAG_COMPRESSED};
+            return send_frame(socket, header, out);
+        }
+    }
+
+    FrameHeader header{(uint32_t)out.size(), request.id, request.type, 0};
+    return send_frame(socket, header, out);
+}
+} // namespace
+
+RemoteServer::RemoteServer(const std::string& address, uint16_t port, std::string token)
+    : m_token{std::move(token)} {
+    m_listener = Socket::listen(address, port);
+}
+
+RemoteServer::~RemoteServer() {
+    stop();
+
+    std::scoped_lock _{m_mtx};
+
+    for (auto&& connection : m_connections) {
+        if (connection->thread.joinable()) {
+            connection->thread.join();
+        }
+    }
+}
+
+void RemoteServer::run() {
+    if (m_listener == nullptr) {
+        return;
+    }
+
+    while (!m_stopping) {
+        auto socket = m_listener->accept();
+
+        if (socket == nullptr) {
+            break;
+        }
+
+        reap();
+
+        std::scoped_lock _{m_mtx};
+
+        if (m_stopping) {
+            break;
+        }
+
+        auto peer = socket->peer();
+        auto connection = std::make_unique<Connection>();
+        auto c = connection.get();
+
+        spdlog::info("{} connected", peer);
+
+        c->socket = std::move(socket);
+        c->thread = std::thread{[this, c, peer] {
+            serve(*c->socket, m_token);
+            // The socket itself goes away with the next reap(), the client shouldn't have to wait for that.
+            c->socket->shutdown();
+            spdlog::info("{} disconnected", peer);
+            c->finished = true;
+        }};
+
+        m_connections.emplace_back(std::move(connection));
+    }
+}
+
+void RemoteServer::stop() {
+    m_stopping = true;
+
+    if (m_listener != nullptr) {
+        m_listener->shutdown();
+    }
+
+    std::scoped_lock _{m_mtx};
+
+    for (auto&& connection : m_connections) {
+        connection->socket->shutdown();
+    }
+}
+
+void RemoteServer::reap() {
+    std::scoped_lock _{m_mtx};
+
+    std::erase_if(m_connections, [](auto&& connection) {
+        if (!connection->finished) {
+            return false;
+        }
+
+        connection->thread.join();
+        return true;
+    });
+}
+
+void RemoteServer::serve(Socket& socket, const std::string& token) {
+    Session session{socket, token};
+    FrameHeader header{};
+
+    while (recv_frame(socket, header, session.payload)) {
+        Reader r{session.payload};
+
+        if (!session.handle(header, r)) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Socket.hpp"
+
+// The other end of RemoteProcess, run by regenny-remote on the machine the target lives on. Every connection gets its
+// own thread and opens its own Process through arch::open_process, so several ReGenny instances can look at the same
+// machine at once. Clients have to present the server's token in HELLO before anything else is answered.
+class RemoteServer {
+public:
+    // Listens on address:port. Port 0 picks a free one, see port(). Only clients that know token get served.
+    RemoteServer(const std::string& address, uint16_t port, std::string token);
+    // Stops and waits for every connection to finish.
+    ~RemoteServer();
+
+    RemoteServer(const RemoteServer&) = delete;
+    RemoteServer& operator=(const RemoteServer&) = delete;
+
+    bool ok() const { return m_listener != nullptr; }
+    uint16_t port() const { return m_listener != nullptr ? m_listener->port() : 0; }
+
+    // Accepts connections until stop() is called.
+    void run();
+    // Safe to call from any thread. Drops every connection.
+    void stop();
+
+private:
+    struct Connection {
+        std::unique_ptr<Socket> socket{};
+        std::thread thread{};
+        std::atomic<bool> finished{};
+    };
+
+    std::unique_ptr<Socket> m_listener{};
+    std::string m_token{};
+    std::atomic<bool> m_stopping{};
+    std::mutex m_mtx{};
+    std::vector<std::unique_ptr<Connection>> m_connections{};
+
+    static void serve(Socket& socket, const std::string& token);
+    // Joins the threads of connections that already closed.
+    void reap();
+};
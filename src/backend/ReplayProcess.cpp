@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+#include "ReplayProcess.hpp"
+
+ReplayProcess::ReplayProcess(const std::filesystem::path& path) : Process{} {
+    auto trace = trace::load(path);
+
+    if (!trace) {
+        spdlog::error("Couldn't load trace {}", path.string());
+        return;
+    }
+
+    m_trace = std::move(*trace);
+    m_loaded = true;
+
+    for (size_t i = 0; i < m_trace.reads.size(); ++i) {
+        auto&& r = m_trace.reads[i];
+
+        m_occurrences[{r.address, r.size}].reads.emplace_back(i);
+
+        if (!r.ok) {
+            continue;
+        }
+
+        // Later reads overwrite earlier ones, the image ends up holding the newest bytes we saw.
+        for (size_t offset = 0; offset < r.size;) {
+            auto address = r.address + offset;
+            auto page_address = address & ~(PAGE_SIZE - 1);
+            auto page_offset = address - page_address;
+            auto n = std::min(PAGE_SIZE - page_offset, r.size - offset);
+            auto&& page = m_image[page_address];
+
+            memcpy(page.data.data() + page_offset, m_trace.data.data() + r.data_offset + offset, n);
+
+            for (size_t j = page_offset; j < page_offset + n; ++j) {
+                page.valid.set(j);
+            }
+
+            offset += n;
+        }
+    }
+
+    m_modules = m_trace.map.modules;
+    m_allocations = m_trace.map.allocations;
+    rebuild_region_index();
+
+    spdlog::info("Loaded trace {} ({} reads, {} modules, {} allocations)", path.string(), m_trace.reads.size(),
+        m_modules.size(), m_allocations.size());
+}
+
+ReplayProcess::Stats ReplayProcess::stats() {
+    std::scoped_lock _{m_mtx};
+    return m_stats;
+}
+
+bool ReplayProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    const trace::Read* recorded{};
+
+    {
+        std::scoped_lock _{m_mtx};
+
+        if (auto search = m_occurrences.find({address, size}); search != m_occurrences.end()) {
+            auto&& occurrences = search->second;
+
+            recorded = &m_trace.reads[occurrences.reads[occurrences.next]];
+
+            // Past the last recorded occurrence we keep returning the last one.
+            if (occurrences.next + 1 < occurrences.reads.size()) {
+                ++occurrences.next;
+            }
+
+            ++m_stats.exact;
+        } else if (read_image(address, buffer, size)) {
+            ++m_stats.image;
+            return true;
+        } else {
+            ++m_stats.misses;
+            return false;
+        }
+    }
+
+    if (m_replay_latency) {
+        std::this_thread::sleep_for(recorded->latency);
+    }
+
+    if (recorded->ok) {
+        memcpy(buffer, m_trace.data.data() + recorded->data_offset, size);
+    }
+
+    return recorded->ok;
+}
+
+bool ReplayProcess::read_image(uintptr_t address, void* buffer, size_t size) {
+    auto out = (std::byte*)buffer;
+
+    for (size_t offset = 0; offset < size;) {
+        auto page_address = (address + offset) & ~(PAGE_SIZE - 1);
+        auto page_offset = address + offset - page_address;
+        auto n = std::min(PAGE_SIZE - page_offset, size - offset);
+        auto search = m_image.find(page_address);
+
+        if (search == m_image.end()) {
+            return false;
+        }
+
+        for (size_t j = page_offset; j < page_offset + n; ++j) {
+            if (!search->second.valid.test(j)) {
+                return false;
+            }
+        }
+
+        memcpy(out + offset, search->second.data.data() + page_offset, n);
+        offset += n;
+    }
+
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Process.hpp"
+#include "Trace.hpp"
+
+// Serves reads from a trace written by RecordingProcess, no target process needed. A read that matches a recorded
+// one (same address and size) gets the recorded results in the order they were recorded, so memory that changed while
+// recording changes the same way on replay. Anything else is served from the latest bytes recorded at that address.
+class ReplayProcess : public Process {
+public:
+    struct Stats {
+        size_t exact{};
+        size_t image{};
+        size_t misses{};
+    };
+
+    explicit ReplayProcess(const std::filesystem::path& path);
+
+    uint32_t process_id() override { return m_loaded ? std::max<uint32_t>(m_trace.process_id, 1) : 0; }
+    bool ok() override { return m_loaded; }
+
+    // Sleep for as long as the recorded read took before returning it.
+    void replay_latency(bool replay_latency) { m_replay_latency = replay_latency; }
+    bool replay_latency() const { return m_replay_latency; }
+
+    Stats stats();
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override { return false; }
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+
+private:
+    static constexpr size_t PAGE_SIZE = 0x1000;
+
+    struct Key {
+        uintptr_t address{};
+        size_t size{};
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const { return std::hash<uintptr_t>{}(k.address) ^ (k.size * 0x9E3779B97F4A7C15ull); }
+    };
+
+    struct Occurrences {
+        std::vector<size_t> reads{};
+        size_t next{};
+    };
+
+    struct ImagePage {
+        std::array<std::byte, PAGE_SIZE> data{};
+        std::bitset<PAGE_SIZE> valid{};
+    };
+
+    trace::Trace m_trace{};
+    bool m_loaded{};
+    bool m_replay_latency{};
+
+    std::mutex m_mtx{};
+    std::unordered_map<Key, Occurrences, KeyHash> m_occurrences{};
+    std::unordered_map<uintptr_t, ImagePage> m_image{};
+    Stats m_stats{};
+
+    bool read_image(uintptr_t address, void* buffer, size_t size);
+};
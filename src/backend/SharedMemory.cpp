@@ -0,0 +1,177 @@
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include "SharedMemory.hpp"
+
+#ifdef _WIN32
+namespace {
+std::wstring widen(const std::string& s) {
+    return std::wstring{s.begin(), s.end()};
+}
+} // namespace
+
+SharedMemory::SharedMemory(const std::string& name, Mode mode, size_t size) : m_name{name} {
+    // Names look like POSIX ones ("/regenny-agent-1234"), Windows doesn't allow the slash.
+    auto wname = widen("Local\\" + (name.starts_with('/') ? name.substr(1) : name));
+
+    if (mode == Mode::CREATE) {
+        m_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32),
+            (DWORD)size, wname.c_str());
+        m_owner = true;
+    } else {
+        m_mapping = OpenFileMappingW(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, wname.c_str());
+    }
+
+    if (m_mapping == nullptr) {
+        return;
+    }
+
+    auto data = MapViewOfFile(m_mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0);
+
+    if (data == nullptr) {
+        return;
+    }
+
+    MEMORY_BASIC_INFORMATION mbi{};
+    VirtualQuery(data, &mbi, sizeof(mbi));
+
+    m_data = (std::byte*)data;
+    m_size = mode == Mode::CREATE ? size : (size_t)mbi.RegionSize;
+}
+
+SharedMemory::~SharedMemory() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+}
+
+// The mapping goes away with its last handle.
+void SharedMemory::unlink() {
+}
+
+void SharedMemory::wait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout) {
+    // WaitOnAddress doesn't work across processes.
+    if (word.load() == expected) {
+        Sleep(1);
+    }
+}
+
+void SharedMemory::wake(std::atomic<uint32_t>& word) {
+}
+
+bool SharedMemory::process_alive(uint32_t process_id) {
+    auto process = OpenProcess(SYNCHRONIZE, FALSE, process_id);
+
+    if (process == nullptr) {
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    }
+
+    auto alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+}
+#else
+SharedMemory::SharedMemory(const std::string& name, Mode mode, size_t size) : m_name{name} {
+    int fd{-1};
+
+    if (mode == Mode::CREATE) {
+        // Left behind by a previous instance that crashed.
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+
+        if (fd != -1 && ftruncate(fd, (off_t)size) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            return;
+        }
+
+        m_owner = fd != -1;
+    } else {
+        fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+
+        struct stat st {};
+
+        if (fd != -1 && fstat(fd, &st) == 0) {
+            size = (size_t)st.st_size;
+        }
+    }
+
+    if (fd == -1) {
+        return;
+    }
+
+    if (size > 0) {
+        auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (data != MAP_FAILED) {
+            m_data = (std::byte*)data;
+            m_size = size;
+        }
+    }
+
+    // The mapping keeps the region alive.
+    close(fd);
+}
+
+SharedMemory::~SharedMemory() {
+    if (m_data != nullptr) {
+        munmap(m_data, m_size);
+    }
+
+    unlink();
+}
+
+void SharedMemory::unlink() {
+    if (m_owner) {
+        shm_unlink(m_name.c_str());
+        m_owner = false;
+    }
+}
+
+void SharedMemory::wait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout) {
+#ifdef __linux__
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+    timespec ts{};
+    ts.tv_sec = (time_t)(timeout.count() / 1000);
+    ts.tv_nsec = (long)(timeout.count() % 1000) * 1000000;
+
+    // Not FUTEX_PRIVATE_FLAG, the other side is another process.
+    syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+    if (word.load() == expected) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+#endif
+}
+
+void SharedMemory::wake(std::atomic<uint32_t>& word) {
+#ifdef __linux__
+    syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+bool SharedMemory::process_alive(uint32_t process_id) {
+    // EPERM still means the process exists, we just aren't allowed to signal it.
+    return kill((pid_t)process_id, 0) == 0 || errno == EPERM;
+}
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Named shared memory (shm_open on POSIX, a named file mapping on Windows). Shared by the in-target agent and
+// SharedMemoryProcess, so it doesn't depend on anything else in ReGenny.
+class SharedMemory {
+public:
+    enum class Mode { CREATE, OPEN };
+
+    // CREATE replaces any stale region with the same name. OPEN maps the whole existing region and ignores size.
+    SharedMemory(const std::string& name, Mode mode, size_t size = 0);
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    bool ok() const { return m_data != nullptr; }
+    std::byte* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    // Removes the name so nobody else can open the region. Existing mappings stay valid.
+    void unlink();
+
+    // Sleeps until word no longer holds expected, wake() is called on it or timeout passes. Works across processes on
+    // Linux (futex); elsewhere it just sleeps for a bit.
+    static void wait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout);
+    static void wake(std::atomic<uint32_t>& word);
+
+    static bool process_alive(uint32_t process_id);
+
+private:
+    std::string m_name{};
+    std::byte* m_data{};
+    size_t m_size{};
+    bool m_owner{};
+
+#ifdef _WIN32
+    void* m_mapping{};
+#endif
+};
@@ -0,0 +1,353 @@
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+#include "LocalProcess.hpp"
+
+#include "SharedMemoryProcess.hpp"
+
+namespace {
+// How long the agent can go without completing anything before we give up on it.
+constexpr auto AGENT_TIMEOUT = std::chrono::seconds{1};
+} // namespace
+
+SharedMemoryProcess::SharedMemoryProcess(std::unique_ptr<Process> inner, std::unique_ptr<SharedMemory> region)
+    : Process{}, m_inner{std::move(inner)}, m_region{std::move(region)} {
+    m_modules = m_inner->modules();
+    m_allocations = m_inner->allocations();
+    m_region_index = m_inner->region_index();
+
+    m_header = (agent::Header*)m_region->data();
+    m_slots = agent::slots(m_region->data());
+    m_arena = agent::arena(m_region->data());
+    m_in_flight.resize(agent::SLOTS);
+
+    // A previous client may have left requests behind when it went away, let the agent finish them before we start
+    // counting.
+    if (!wait_completed(m_header->submitted.load(std::memory_order_acquire))) {
+        return;
+    }
+
+    m_submitted = m_completed = m_header->completed.load(std::memory_order_acquire);
+}
+
+SharedMemoryProcess::~SharedMemoryProcess() {
+    auto client = LocalProcess::current_process_id();
+    m_header->client.compare_exchange_strong(client, 0);
+}
+
+std::unique_ptr<SharedMemory> SharedMemoryProcess::open_agent(uint32_t process_id) {
+    auto region = std::make_unique<SharedMemory>(agent::shm_name(process_id), SharedMemory::Mode::OPEN);
+
+    if (!region->ok() || region->size() < agent::region_size()) {
+        return nullptr;
+    }
+
+    auto header = (agent::Header*)region->data();
+
+    if (header->magic != agent::MAGIC || header->version != agent::VERSION || header->pid != process_id ||
+        header->slots != agent::SLOTS || header->arena_size != agent::ARENA_SIZE ||
+        header->state.load() != agent::State::RUNNING) {
+        spdlog::warn("Ignoring agent region for {}: incompatible or not running", process_id);
+        return nullptr;
+    }
+
+    // Take over from a client that died without letting go. One that's us is another SharedMemoryProcess still alive
+    // in this process (say the old attachment while reattaching), sharing the ring with it would mix up both sides'
+    // counts.
+    auto us = LocalProcess::current_process_id();
+    auto client = header->client.load();
+
+    for (;;) {
+        if (client == us || (client != 0 && SharedMemory::process_alive(client))) {
+            spdlog::warn("Agent in {} is already in use by {}", process_id, client);
+            return nullptr;
+        }
+
+        if (header->client.compare_exchange_weak(client, us)) {
+            break;
+        }
+    }
+
+    return region;
+}
+
+void SharedMemoryProcess::apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) {
+    m_inner->apply_map(snapshot, events);
+    Process::apply_map(std::move(snapshot), events);
+}
+
+void SharedMemoryProcess::mark_dead(const char* reason) {
+    if (!m_dead.exchange(true)) {
+        spdlog::error("Agent in {} {}, falling back to the regular backend", m_header->pid, reason);
+    }
+}
+
+bool SharedMemoryProcess::wait_completed(uint64_t count) {
+    auto&& completed = m_header->completed;
+
+    if (completed.load(std::memory_order_acquire) >= count) {
+        return true;
+    }
+
+    // Pairs with the agent setting sleeping before its last look at submitted: either it sees our requests or we see
+    // it asleep and ring.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_header->sleeping.load(std::memory_order_relaxed) != 0) {
+        m_header->doorbell.fetch_add(1);
+        SharedMemory::wake(m_header->doorbell);
+    }
+
+    // Small reads come back within a few hundred nanoseconds, spin before involving the scheduler.
+    for (size_t i = 0; i < 2000; ++i) {
+        if (completed.load(std::memory_order_acquire) >= count) {
+            return true;
+        }
+    }
+
+    auto last = completed.load(std::memory_order_acquire);
+    auto deadline = std::chrono::steady_clock::now() + AGENT_TIMEOUT;
+
+    while (last < count) {
+        std::this_thread::yield();
+
+        if (auto now = completed.load(std::memory_order_acquire); now != last) {
+            last = now;
+            deadline = std::chrono::steady_clock::now() + AGENT_TIMEOUT;
+            continue;
+        }
+
+        if (m_header->state.load() != agent::State::RUNNING) {
+            mark_dead("stopped");
+            return false;
+        }
+
+        if (std::chrono::steady_clock::now() > deadline) {
+            mark_dead("stopped answering");
+            return false;
+        }
+
+        // Missed the doorbell window above (the agent went to sleep after we looked), ring again.
+        if (m_header->sleeping.load() != 0) {
+            m_header->doorbell.fetch_add(1);
+            SharedMemory::wake(m_header->doorbell);
+        }
+    }
+
+    return true;
+}
+
+bool SharedMemoryProcess::complete_one(const DoneFn& done) {
+    if (!wait_completed(m_completed + 1)) {
+        return false;
+    }
+
+    auto&& slot = m_slots[m_completed % agent::SLOTS];
+    auto&& in_flight = m_in_flight[m_completed % agent::SLOTS];
+    // The slot lives in memory the target can write. Only its status is taken from it, where the data is comes from
+    // what we assigned.
+    auto ok = slot.status == agent::Status::OK && slot.size == in_flight.size;
+
+    done(in_flight.index, ok ? m_arena + in_flight.arena_pos % agent::ARENA_SIZE : nullptr);
+    ++m_completed;
+
+    return true;
+}
+
+size_t SharedMemoryProcess::transfer(std::span<const Transfer> transfers, const DoneFn& done) {
+    if (m_dead) {
+        return 0;
+    }
+
+    // Everything from the previous call was completed, so the arena starts out empty.
+    uint64_t arena_head{};
+    size_t n{};
+
+    for (size_t i = 0; i < transfers.size(); ++i) {
+        auto&& t = transfers[i];
+        auto pos = arena_head;
+
+        // Never split an entry across the end of the arena, skip to the start instead.
+        if (pos % agent::ARENA_SIZE + t.size > agent::ARENA_SIZE) {
+            pos += agent::ARENA_SIZE - pos % agent::ARENA_SIZE;
+        }
+
+        // Space is reclaimed oldest first, which is also the order the agent finishes in.
+        auto full = [&] {
+            if (m_submitted - m_completed == agent::SLOTS) {
+                return true;
+            }
+
+            auto tail = m_submitted != m_completed ? m_in_flight[m_completed % agent::SLOTS].arena_pos : pos;
+            return pos + t.size - tail > agent::ARENA_SIZE;
+        };
+
+        while (full()) {
+            if (!complete_one(done)) {
+                return n;
+            }
+
+            ++n;
+        }
+
+        auto offset = pos % agent::ARENA_SIZE;
+        auto&& slot = m_slots[m_submitted % agent::SLOTS];
+
+        slot.address = t.address;
+        slot.arena_offset = offset;
+        slot.size = t.size;
+        slot.op = t.op;
+        slot.status = agent::Status::PENDING;
+
+        if (t.op == agent::Op::WRITE) {
+            memcpy(m_arena + offset, t.data, t.size);
+        }
+
+        m_in_flight[m_submitted % agent::SLOTS] = {i, pos, t.size};
+        arena_head = pos + t.size;
+
+        // Publishes the slot (and write data). The agent picks it up while we keep filling the ring.
+        m_header->submitted.store(++m_submitted, std::memory_order_release);
+    }
+
+    while (m_completed != m_submitted) {
+        if (!complete_one(done)) {
+            return n;
+        }
+
+        ++n;
+    }
+
+    return n;
+}
+
+size_t SharedMemoryProcess::read_views(std::span<const ReadRequest> requests, const ViewFn& fn) {
+    std::vector<Transfer> transfers{};
+    transfers.reserve(requests.size());
+
+    for (auto&& r : requests) {
+        // Views have to be contiguous in the arena, anything bigger than one transfer fails without being sent.
+        transfers.emplace_back(agent::Op::READ, r.address, r.size <= agent::MAX_REQUEST_SIZE ? r.size : 0);
+    }
+
+    size_t ok{};
+    size_t done{};
+
+    {
+        std::scoped_lock _{m_mtx};
+
+        done = transfer(transfers, [&](size_t i, const std::byte* data) {
+            auto valid = data != nullptr && requests[i].size <= agent::MAX_REQUEST_SIZE;
+
+            fn(i, valid ? data : nullptr);
+            ok += valid ? 1 : 0;
+        });
+    }
+
+    // The agent went away part way through, the rest come from the regular backend.
+    std::vector<std::byte> buffer{};
+
+    for (auto i = done; i < requests.size(); ++i) {
+        auto&& r = requests[i];
+
+        buffer.resize(r.size);
+
+        if (m_inner->read(r.address, buffer.data(), r.size)) {
+            fn(i, buffer.data());
+            ++ok;
+        } else {
+            fn(i, nullptr);
+        }
+    }
+
+    return ok;
+}
+
+bool SharedMemoryProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    ReadRequest r{address, buffer, size};
+    handle_read_batch({&r, 1});
+    return r.ok;
+}
+
+void SharedMemoryProcess::handle_read_batch(std::span<ReadRequest> requests) {
+    std::vector<Transfer> transfers{};
+    // Which request each transfer belongs to.
+    std::vector<size_t> owners{};
+
+    transfers.reserve(requests.size());
+    owners.reserve(requests.size());
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto&& r = requests[i];
+
+        r.ok = true;
+
+        for (size_t offset = 0; offset < r.size; offset += agent::MAX_REQUEST_SIZE) {
+            transfers.emplace_back(
+                agent::Op::READ, r.address + offset, std::min(r.size - offset, agent::MAX_REQUEST_SIZE));
+            owners.emplace_back(i);
+        }
+    }
+
+    size_t done{};
+
+    {
+        std::scoped_lock _{m_mtx};
+
+        done = transfer(transfers, [&](size_t i, const std::byte* data) {
+            auto&& r = requests[owners[i]];
+
+            if (data == nullptr) {
+                r.ok = false;
+                return;
+            }
+
+            memcpy((std::byte*)r.buffer + (transfers[i].address - r.address), data, transfers[i].size);
+        });
+    }
+
+    if (done == transfers.size()) {
+        return;
+    }
+
+    // The agent went away part way through. Requests it never got to (even partially) are redone from scratch.
+    for (auto i = done < owners.size() ? owners[done] : requests.size(); i < requests.size(); ++i) {
+        auto&& r = requests[i];
+        r.ok = m_inner->read(r.address, r.buffer, r.size);
+    }
+}
+
+bool SharedMemoryProcess::handle_write(uintptr_t address, const void* buffer, size_t size) {
+    std::vector<Transfer> transfers{};
+
+    for (size_t offset = 0; offset < size; offset += agent::MAX_REQUEST_SIZE) {
+        transfers.emplace_back(agent::Op::WRITE, address + offset, std::min(size - offset, agent::MAX_REQUEST_SIZE),
+            (const std::byte*)buffer + offset);
+    }
+
+    auto ok = true;
+    size_t done{};
+
+    {
+        std::scoped_lock _{m_mtx};
+        done = transfer(transfers, [&](size_t, const std::byte* data) { ok = ok && data != nullptr; });
+    }
+
+    if (ok && done == transfers.size()) {
+        return true;
+    }
+
+    // Read-only memory (or no agent): the regular backend writes through the page protection.
+    return m_inner->write(address, buffer, size);
+}
+
+std::optional<uint64_t> SharedMemoryProcess::handle_protect(uintptr_t address, size_t size, uint64_t flags) {
+    return m_inner->protect(address, size, flags);
+}
+
+std::optional<uintptr_t> SharedMemoryProcess::handle_allocate(uintptr_t address, size_t size, uint64_t flags) {
+    return m_inner->allocate(address, size, flags);
+}
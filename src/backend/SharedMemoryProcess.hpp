@@ -0,0 +1,94 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AgentProtocol.hpp"
+#include "Process.hpp"
+#include "SharedMemory.hpp"
+
+// Reads and writes through an agent running inside the target (agent/Agent.cpp), over the shared memory ring described
+// in AgentProtocol.hpp. Requests are pipelined: a batch keeps up to agent::SLOTS of them in flight while the agent
+// serves them, so many small reads cost about as much as one memcpy each instead of a syscall each. RTTI is walked over
+// those same reads. The memory map, protect and allocate still go through the regular backend, which also takes over
+// if the agent goes away.
+class SharedMemoryProcess : public Process {
+public:
+    SharedMemoryProcess(std::unique_ptr<Process> inner, std::unique_ptr<SharedMemory> region);
+    virtual ~SharedMemoryProcess();
+
+    // The region of a running agent in process_id that no other client (including another SharedMemoryProcess of ours)
+    // is using, nullptr if there isn't one.
+    static std::unique_ptr<SharedMemory> open_agent(uint32_t process_id);
+
+    // Called with a pointer into the shared arena holding the result of requests[index], nullptr if it couldn't be read.
+    // The pointer is only valid during the call.
+    using ViewFn = std::function<void(size_t index, const std::byte* data)>;
+
+    // Zero-copy read_batch: results are handed out where the agent wrote them instead of being copied into buffers
+    // first. Only the address and size of each request are used. Bypasses the page caches. Returns the number of
+    // requests that succeeded.
+    size_t read_views(std::span<const ReadRequest> requests, const ViewFn& fn);
+
+    auto&& inner() const { return m_inner; }
+
+    // False once the agent stopped answering, everything goes through the inner process from then on.
+    bool agent_ok() const { return !m_dead; }
+
+    uint32_t process_id() override { return m_inner->process_id(); }
+    bool ok() override { return m_inner->ok(); }
+
+    std::optional<MapSnapshot> snapshot_map() override { return m_inner->snapshot_map(); }
+    void apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) override;
+
+    // The agent answering our reads runs inside the target, stopping the target would stop it too.
+    bool suspend() override { return false; }
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override;
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+    void handle_read_batch(std::span<ReadRequest> requests) override;
+    std::optional<uint64_t> handle_protect(uintptr_t address, size_t size, uint64_t flags) override;
+    std::optional<uintptr_t> handle_allocate(uintptr_t address, size_t size, uint64_t flags) override;
+
+private:
+    // One slot's worth of work. size is at most agent::MAX_REQUEST_SIZE.
+    struct Transfer {
+        agent::Op op{};
+        uintptr_t address{};
+        size_t size{};
+        // WRITE only.
+        const void* data{};
+    };
+
+    using DoneFn = std::function<void(size_t index, const std::byte* data)>;
+
+    struct InFlight {
+        size_t index{};
+        uint64_t arena_pos{};
+        size_t size{};
+    };
+
+    std::unique_ptr<Process> m_inner{};
+    std::unique_ptr<SharedMemory> m_region{};
+    agent::Header* m_header{};
+    agent::Slot* m_slots{};
+    std::byte* m_arena{};
+
+    // The client side of the ring is single-producer.
+    std::mutex m_mtx{};
+    uint64_t m_submitted{};
+    uint64_t m_completed{};
+    std::vector<InFlight> m_in_flight{};
+    std::atomic<bool> m_dead{};
+
+    // Runs transfers through the ring, calling done for each in order (data is nullptr if the agent faulted on it).
+    // Returns how many were done, fewer than transfers.size() only if the agent stopped answering.
+    size_t transfer(std::span<const Transfer> transfers, const DoneFn& done);
+    // Waits for the oldest request in flight and hands it to done.
+    bool complete_one(const DoneFn& done);
+    bool wait_completed(uint64_t count);
+    void mark_dead(const char* reason);
+};
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+#include <lz4.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include "Snapshot.hpp"
+
+namespace snapshot {
+namespace {
+struct Chunk {
+    uintptr_t address{};
+    uint32_t size{};
+};
+
+// Sequential writer shared by the capture threads. Chunks are appended in completion order.
+class ChunkWriter {
+public:
+    explicit ChunkWriter(const std::filesystem::path& path) : m_file{path, std::ios::binary | std::ios::trunc} {
+        Header header{};
+        m_file.write((const char*)&header, sizeof(header));
+        m_end = sizeof(header);
+    }
+
+    bool ok() {
+        std::scoped_lock _{m_mtx};
+        return m_file.good();
+    }
+
+    uint64_t append(const std::byte* prefix, size_t prefix_size, const std::byte* data, size_t size) {
+        std::scoped_lock _{m_mtx};
+        auto offset = m_end;
+
+        m_file.write((const char*)prefix, prefix_size);
+        m_file.write((const char*)data, size);
+        m_end += prefix_size + size;
+
+        return offset;
+    }
+
+    std::ofstream& file() { return m_file; }
+    uint64_t end() const { return m_end; }
+
+private:
+    std::mutex m_mtx{};
+    std::ofstream m_file;
+    uint64_t m_end{};
+};
+
+std::vector<CaptureOptions::Range> ranges_to_capture(Process& process, const CaptureOptions& options) {
+    std::vector<CaptureOptions::Range> ranges{};
+
+    if (options.ranges.empty()) {
+        for (auto&& a : process.allocations()) {
+            if (a.read) {
+                ranges.emplace_back(a.start, a.end);
+            }
+        }
+    } else {
+        ranges = options.ranges;
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](auto&& a, auto&& b) { return a.start < b.start; });
+
+    // Overlapping requests would give one address two chunks.
+    std::vector<CaptureOptions::Range> merged{};
+
+    for (auto&& r : ranges) {
+        if (r.end <= r.start) {
+            continue;
+        }
+
+        if (!merged.empty() && r.start <= merged.back().end) {
+            merged.back().end = std::max(merged.back().end, r.end);
+        } else {
+            merged.emplace_back(r);
+        }
+    }
+
+    return merged;
+}
+
+uint32_t protection_of(Process& process, uintptr_t address) {
+    auto a = process.get_allocation_within(address);
+
+    // Explicitly requested ranges outside any known allocation.
+    if (a == nullptr) {
+        return RegionIndex::READ | RegionIndex::WRITE;
+    }
+
+    return (a->read ? RegionIndex::READ : 0) | (a->write ? RegionIndex::WRITE : 0) |
+           (a->execute ? RegionIndex::EXECUTE : 0);
+}
+
+uint32_t effective_chunk_size(const CaptureOptions& options) {
+    return std::max<uint32_t>(options.chunk_size / PAGE_SIZE * PAGE_SIZE, PAGE_SIZE);
+}
+} // namespace
+
+Layout plan(Process& process, const CaptureOptions& options) {
+    Layout layout{};
+    auto chunk_size = effective_chunk_size(options);
+    uint64_t chunk_count{};
+
+    for (auto&& r : ranges_to_capture(process, options)) {
+        RegionEntry region{};
+
+        region.start = r.start;
+        region.end = r.end;
+        region.first_chunk = chunk_count;
+        region.protection = protection_of(process, r.start);
+        layout.regions.emplace_back(region);
+
+        chunk_count += (r.end - r.start + chunk_size - 1) / chunk_size;
+    }
+
+    layout.modules = process.modules();
+    layout.process_id = process.process_id();
+
+    return layout;
+}
+
+bool capture(Process& process, const Layout& layout, const std::filesystem::path& path, const CaptureOptions& options,
+    CaptureProgress* progress) {
+    CaptureProgress local_progress{};
+    auto&& p = progress != nullptr ? *progress : local_progress;
+    auto chunk_size = effective_chunk_size(options);
+    auto&& regions = layout.regions;
+    std::vector<Chunk> chunks{};
+
+    for (auto&& region : regions) {
+        for (auto address = (uintptr_t)region.start; address < region.end; address += chunk_size) {
+            chunks.emplace_back(address, (uint32_t)std::min<uintptr_t>(chunk_size, region.end - address));
+        }
+    }
+
+    p.chunks = chunks.size();
+
+    ChunkWriter writer{path};
+
+    if (!writer.ok()) {
+        spdlog::error("Couldn't create snapshot {}", path.string());
+        p.finished = true;
+        return false;
+    }
+
+    std::vector<ChunkEntry> entries(chunks.size());
+    std::atomic<size_t> next{};
+    auto thread_count = options.threads != 0 ? options.threads : std::max(std::thread::hardware_concurrency(), 1u);
+
+    thread_count = std::min(thread_count, std::max<size_t>(chunks.size(), 1));
+
+    auto worker = [&] {
+        std::vector<std::byte> data(chunk_size);
+        std::vector<std::byte> compressed(options.compress ? LZ4_compressBound((int)chunk_size) : 0);
+        std::vector<std::byte> bitmap(bitmap_size(chunk_size));
+
+        for (size_t i = next++; i < chunks.size() && !p.cancelled(); i = next++) {
+            auto&& chunk = chunks[i];
+            auto&& entry = entries[i];
+
+            entry.size = chunk.size;
+
+            // Most chunks read in one go; otherwise fall back to page by page and remember which pages were missing.
+            if (!process.read_direct(chunk.address, data.data(), chunk.size)) {
+                auto readable = 0;
+
+                std::fill(bitmap.begin(), bitmap.end(), std::byte{});
+
+                for (uint32_t offset = 0; offset < chunk.size; offset += PAGE_SIZE) {
+                    auto n = std::min<uint32_t>(PAGE_SIZE, chunk.size - offset);
+
+                    if (process.read_direct(chunk.address + offset, data.data() + offset, n)) {
+                        bitmap[offset / PAGE_SIZE / 8] |= std::byte(1 << (offset / PAGE_SIZE % 8));
+                        ++readable;
+                    } else {
+                        memset(data.data() + offset, 0, n);
+                    }
+                }
+
+                if (readable == 0) {
+                    entry.codec = Codec::MISSING;
+                    ++p.chunks_done;
+                    continue;
+                }
+
+                entry.flags |= PARTIAL;
+            }
+
+            p.bytes_read += chunk.size;
+
+            auto payload = data.data();
+            auto payload_size = (size_t)chunk.size;
+
+            entry.codec = Codec::RAW;
+
+            if (options.compress) {
+                auto n = LZ4_compress_default(
+                    (const char*)data.data(), (char*)compressed.data(), (int)chunk.size, (int)compressed.size());
+
+                // Incompressible data is stored as is so reading it back is a plain copy.
+                if (n > 0 && (size_t)n < chunk.size) {
+                    payload = compressed.data();
+                    payload_size = (size_t)n;
+                    entry.codec = Codec::LZ4;
+                }
+            }
+
+            auto prefix_size = (entry.flags & PARTIAL) != 0 ? bitmap.size() : 0;
+
+            entry.offset = writer.append(bitmap.data(), prefix_size, payload, payload_size);
+            entry.stored_size = (uint32_t)(prefix_size + payload_size);
+            p.bytes_written += entry.stored_size;
+            ++p.chunks_done;
+        }
+    };
+
+    std::vector<std::thread> threads{};
+
+    for (size_t i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto&& t : threads) {
+        t.join();
+    }
+
+    if (p.cancelled()) {
+        writer.file().close();
+        std::error_code ec{};
+        std::filesystem::remove(path, ec);
+        p.finished = true;
+        return false;
+    }
+
+    // Index.
+    std::vector<ModuleEntry> modules{};
+    std::string strings{};
+
+    for (auto&& m : layout.modules) {
+        modules.emplace_back(m.start, m.end, strings.size(), m.name.size());
+        strings += m.name;
+    }
+
+    auto metadata = nlohmann::json{{"process_id", layout.process_id}, {"process_name", options.process_name},
+        {"created", std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count()}}
+                        .dump();
+
+    IndexHeader index_header{modules.size(), regions.size(), entries.size(), strings.size(), metadata.size()};
+    Header header{};
+    auto&& file = writer.file();
+
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.chunk_size = chunk_size;
+    header.index_offset = writer.end();
+
+    file.write((const char*)&index_header, sizeof(index_header));
+    file.write((const char*)modules.data(), modules.size() * sizeof(ModuleEntry));
+    file.write((const char*)regions.data(), regions.size() * sizeof(RegionEntry));
+    file.write((const char*)entries.data(), entries.size() * sizeof(ChunkEntry));
+    file.write(strings.data(), strings.size());
+    file.write(metadata.data(), metadata.size());
+
+    header.index_size = (uint64_t)file.tellp() - header.index_offset;
+
+    // The header goes in last so a capture that died half way isn't mistaken for a snapshot.
+    file.seekp(0);
+    file.write((const char*)&header, sizeof(header));
+    file.close();
+
+    auto elapsed = std::chrono::duration<float>{std::chrono::steady_clock::now() - p.start_time};
+
+    spdlog::info("Captured {} ({} regions, {:.1f} MB read, {:.1f} MB written) in {:.2f}s", path.string(),
+        regions.size(), p.bytes_read / (1024.0f * 1024.0f), p.bytes_written / (1024.0f * 1024.0f), elapsed.count());
+
+    p.ok = !file.fail();
+    p.finished = true;
+
+    return p.ok;
+}
+
+CaptureJob::CaptureJob(Process& process, std::filesystem::path path, CaptureOptions options)
+    : m_path{std::move(path)} {
+    auto layout = plan(process, options);
+
+    m_thread = std::thread{[this, &process, layout = std::move(layout), options = std::move(options)] {
+        capture(process, layout, m_path, options, m_progress.get());
+    }};
+}
+
+CaptureJob::~CaptureJob() {
+    cancel();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+} // namespace snapshot
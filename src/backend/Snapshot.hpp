@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Process.hpp"
+
+// Snapshot files: a frozen copy of some or all of a process's memory that SnapshotProcess can open later.
+//
+// Layout: Header, then the chunks in whatever order the capture threads finished them, then the index. The index is
+// IndexHeader, ModuleEntry[module_count], RegionEntry[region_count], ChunkEntry[chunk_count], the module name strings
+// and finally the metadata (JSON). Regions are split into chunk_size sized chunks (the last one may be short) and a
+// region's chunks are consecutive in the chunk table. Everything is little endian.
+namespace snapshot {
+constexpr char MAGIC[8] = {'R', 'G', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t PAGE_SIZE = 0x1000;
+
+struct Header {
+    char magic[8]{};
+    uint32_t version{};
+    uint32_t chunk_size{};
+    uint64_t index_offset{};
+    uint64_t index_size{};
+};
+
+struct IndexHeader {
+    uint64_t module_count{};
+    uint64_t region_count{};
+    uint64_t chunk_count{};
+    uint64_t strings_size{};
+    uint64_t metadata_size{};
+};
+
+struct ModuleEntry {
+    uint64_t start{};
+    uint64_t end{};
+    uint64_t name_offset{};
+    uint64_t name_size{};
+};
+
+struct RegionEntry {
+    uint64_t start{};
+    uint64_t end{};
+    uint64_t first_chunk{};
+    // RegionIndex::Protection bits.
+    uint32_t protection{};
+    uint32_t reserved{};
+};
+
+enum class Codec : uint32_t {
+    RAW = 0,
+    LZ4 = 1,
+    // Nothing in the chunk could be read.
+    MISSING = 2,
+};
+
+enum ChunkFlags : uint32_t {
+    // Some pages couldn't be read. The stored data starts with a bitmap of readable pages (bit i = page i) followed by
+    // the (possibly compressed) chunk, unreadable pages zeroed.
+    PARTIAL = 1 << 0,
+};
+
+struct ChunkEntry {
+    uint64_t offset{};
+    uint32_t stored_size{};
+    uint32_t size{};
+    Codec codec{};
+    uint32_t flags{};
+};
+
+static_assert(sizeof(Header) == 32 && sizeof(IndexHeader) == 40 && sizeof(ModuleEntry) == 32);
+static_assert(sizeof(RegionEntry) == 32 && sizeof(ChunkEntry) == 24);
+
+constexpr size_t bitmap_size(uint32_t chunk_size) {
+    return ((chunk_size + PAGE_SIZE - 1) / PAGE_SIZE + 7) / 8;
+}
+
+struct CaptureOptions {
+    struct Range {
+        uintptr_t start{};
+        uintptr_t end{};
+    };
+
+    // Empty captures every readable allocation.
+    std::vector<Range> ranges{};
+    uint32_t chunk_size{256 * 1024};
+    bool compress{true};
+    // 0 uses one per core.
+    size_t threads{};
+    std::string process_name{};
+};
+
+struct CaptureProgress {
+    std::atomic<size_t> chunks{};
+    std::atomic<size_t> chunks_done{};
+    std::atomic<size_t> bytes_read{};
+    std::atomic<size_t> bytes_written{};
+    std::atomic<bool> cancel_requested{};
+    std::atomic<bool> finished{};
+    std::atomic<bool> ok{};
+    std::chrono::steady_clock::time_point start_time{std::chrono::steady_clock::now()};
+
+    void cancel() { cancel_requested = true; }
+    bool cancelled() const { return cancel_requested.load(std::memory_order_relaxed); }
+};
+
+// What a capture writes besides memory. Taken from the process up front, on the thread that owns its map, so the
+// capture itself only reads memory.
+struct Layout {
+    std::vector<RegionEntry> regions{};
+    std::vector<Process::Module> modules{};
+    uint32_t process_id{};
+};
+
+Layout plan(Process& process, const CaptureOptions& options);
+
+// Blocks until the snapshot is written. Reads through Process::read_direct so it's safe to run next to other readers.
+bool capture(Process& process, const Layout& layout, const std::filesystem::path& path, const CaptureOptions& options,
+    CaptureProgress* progress = nullptr);
+inline bool capture(Process& process, const std::filesystem::path& path, const CaptureOptions& options,
+    CaptureProgress* progress = nullptr) {
+    return capture(process, plan(process, options), path, options, progress);
+}
+
+// Runs capture() on a background thread. Construct it on the thread that owns the process's map. The process must
+// outlive the job; destroying the job cancels it.
+class CaptureJob {
+public:
+    CaptureJob(Process& process, std::filesystem::path path, CaptureOptions options);
+    ~CaptureJob();
+
+    CaptureJob(const CaptureJob&) = delete;
+    CaptureJob& operator=(const CaptureJob&) = delete;
+
+    auto&& progress() const { return m_progress; }
+    auto&& path() const { return m_path; }
+    bool finished() const { return m_progress->finished; }
+    void cancel() { m_progress->cancel(); }
+
+private:
+    std::filesystem::path m_path{};
+    std::shared_ptr<CaptureProgress> m_progress{std::make_shared<CaptureProgress>()};
+    std::thread m_thread{};
+};
+} // namespace snapshot
@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <cstring>
+
+#include <lz4.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include "SnapshotProcess.hpp"
+
+bool SnapshotProcess::is_snapshot(const MappedFile& file) {
+    snapshot::Header header{};
+
+    return file.read(0, header) && memcmp(header.magic, snapshot::MAGIC, sizeof(snapshot::MAGIC)) == 0;
+}
+
+SnapshotProcess::SnapshotProcess(const std::filesystem::path& path) : MappedProcess{path} {
+    using namespace snapshot;
+
+    Header header{};
+    IndexHeader index{};
+
+    if (!m_file.read(0, header) || memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.chunk_size == 0 || !m_file.read(header.index_offset, index)) {
+        spdlog::error("{} isn't a snapshot", path.string());
+        return;
+    }
+
+    // Counts straight from the file; past what the file could hold they'd overflow the offset math below.
+    auto file_size = m_file.size();
+
+    if (index.module_count > file_size / sizeof(ModuleEntry) || index.region_count > file_size / sizeof(RegionEntry) ||
+        index.chunk_count > file_size / sizeof(ChunkEntry) || index.strings_size > file_size ||
+        index.metadata_size > file_size) {
+        spdlog::error("{} has a corrupt index", path.string());
+        return;
+    }
+
+    auto modules_offset = header.index_offset + sizeof(index);
+    auto regions_offset = modules_offset + index.module_count * sizeof(ModuleEntry);
+    auto chunks_offset = regions_offset + index.region_count * sizeof(RegionEntry);
+    auto strings_offset = chunks_offset + index.chunk_count * sizeof(ChunkEntry);
+    auto metadata_offset = strings_offset + index.strings_size;
+    auto modules = m_file.at(modules_offset, index.module_count * sizeof(ModuleEntry));
+    auto regions = m_file.at(regions_offset, index.region_count * sizeof(RegionEntry));
+    auto chunks = m_file.at(chunks_offset, index.chunk_count * sizeof(ChunkEntry));
+    auto strings = (const char*)m_file.at(strings_offset, index.strings_size);
+    auto metadata = (const char*)m_file.at(metadata_offset, index.metadata_size);
+
+    if (modules == nullptr || regions == nullptr || chunks == nullptr || strings == nullptr || metadata == nullptr) {
+        spdlog::error("{} has a truncated index", path.string());
+        return;
+    }
+
+    m_chunk_size = header.chunk_size;
+    m_regions.resize(index.region_count);
+    m_chunks.resize(index.chunk_count);
+    memcpy(m_regions.data(), regions, m_regions.size() * sizeof(RegionEntry));
+    memcpy(m_chunks.data(), chunks, m_chunks.size() * sizeof(ChunkEntry));
+    m_metadata.assign(metadata, index.metadata_size);
+
+    for (uint64_t i = 0; i < index.module_count; ++i) {
+        ModuleEntry entry{};
+        Module m{};
+
+        memcpy(&entry, modules + i * sizeof(entry), sizeof(entry));
+
+        if (entry.name_offset <= index.strings_size && entry.name_size <= index.strings_size - entry.name_offset) {
+            m.name.assign(strings + entry.name_offset, entry.name_size);
+        }
+
+        m.start = (uintptr_t)entry.start;
+        m.end = (uintptr_t)entry.end;
+        m.size = m.end - m.start;
+        m_modules.emplace_back(std::move(m));
+    }
+
+    for (auto&& r : m_regions) {
+        auto region_size = r.end - r.start;
+        auto chunk_count = region_size / m_chunk_size + (region_size % m_chunk_size != 0 ? 1 : 0);
+
+        // A region pointing past the chunk table would index out of bounds later.
+        if (r.end < r.start || r.first_chunk > m_chunks.size() || chunk_count > m_chunks.size() - r.first_chunk) {
+            spdlog::error("{} has a corrupt region table", path.string());
+            m_regions.clear();
+            return;
+        }
+
+        // Reads assume every chunk covers exactly its part of the region, a shorter one would never make progress.
+        for (uint64_t i = 0; i < chunk_count; ++i) {
+            auto expected = std::min<uint64_t>(m_chunk_size, region_size - i * m_chunk_size);
+
+            if (m_chunks[r.first_chunk + i].size != expected) {
+                spdlog::error("{} has a corrupt chunk table", path.string());
+                m_regions.clear();
+                return;
+            }
+        }
+
+        Allocation a{};
+
+        a.start = (uintptr_t)r.start;
+        a.end = (uintptr_t)r.end;
+        a.size = a.end - a.start;
+        a.read = (r.protection & RegionIndex::READ) != 0;
+        a.write = (r.protection & RegionIndex::WRITE) != 0;
+        a.execute = (r.protection & RegionIndex::EXECUTE) != 0;
+        m_allocations.emplace_back(std::move(a));
+    }
+
+    std::sort(m_regions.begin(), m_regions.end(), [](auto&& a, auto&& b) { return a.start < b.start; });
+
+    try {
+        auto j = nlohmann::json::parse(m_metadata);
+
+        m_process_id = j.value("process_id", 0u);
+        m_description = fmt::format("snapshot of {}, {} regions", j.value("process_name", std::string{"?"}),
+            m_regions.size());
+    } catch (const nlohmann::json::exception&) {
+        m_description = fmt::format("snapshot, {} regions", m_regions.size());
+    }
+
+    rebuild_region_index();
+    m_loaded = true;
+
+    spdlog::info("Opened {} ({})", path.string(), m_description);
+}
+
+const snapshot::RegionEntry* SnapshotProcess::find_region(uintptr_t address) const {
+    auto it = std::upper_bound(
+        m_regions.begin(), m_regions.end(), address, [](uintptr_t addr, auto&& r) { return addr < r.start; });
+
+    if (it == m_regions.begin()) {
+        return nullptr;
+    }
+
+    --it;
+
+    return address < it->end ? &*it : nullptr;
+}
+
+bool SnapshotProcess::page_readable(size_t index, size_t offset) const {
+    auto&& chunk = m_chunks[index];
+
+    if ((chunk.flags & snapshot::PARTIAL) == 0) {
+        return true;
+    }
+
+    auto page = offset / snapshot::PAGE_SIZE;
+    auto bitmap = m_file.data() + chunk.offset;
+
+    return (bitmap[page / 8] & std::byte(1 << (page % 8))) != std::byte{};
+}
+
+const std::byte* SnapshotProcess::chunk_data(size_t index) {
+    using namespace snapshot;
+
+    auto&& chunk = m_chunks[index];
+    auto prefix_size = (chunk.flags & PARTIAL) != 0 ? bitmap_size(m_chunk_size) : 0;
+    auto stored = m_file.at(chunk.offset, chunk.stored_size);
+
+    if (chunk.codec == Codec::MISSING || stored == nullptr || chunk.stored_size < prefix_size) {
+        return nullptr;
+    }
+
+    if (chunk.codec == Codec::RAW) {
+        return chunk.stored_size - prefix_size >= chunk.size ? stored + prefix_size : nullptr;
+    }
+
+    if (auto search = m_cache.find(index); search != m_cache.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, search->second.lru);
+        return search->second.data.data();
+    }
+
+    std::vector<std::byte> data(chunk.size);
+    auto n = LZ4_decompress_safe((const char*)stored + prefix_size, (char*)data.data(),
+        (int)(chunk.stored_size - prefix_size), (int)chunk.size);
+
+    if (n != (int)chunk.size) {
+        return nullptr;
+    }
+
+    if (m_cache.size() >= MAX_CACHED_CHUNKS) {
+        m_cache.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+
+    m_lru.push_front(index);
+
+    auto&& cached = m_cache[index];
+
+    cached.data = std::move(data);
+    cached.lru = m_lru.begin();
+
+    return cached.data.data();
+}
+
+const std::byte* SnapshotProcess::view(uintptr_t address, size_t size) {
+    auto region = find_region(address);
+
+    if (region == nullptr || size > region->end - address) {
+        return nullptr;
+    }
+
+    auto offset = address - region->start;
+    auto index = region->first_chunk + offset / m_chunk_size;
+    auto chunk_offset = offset % m_chunk_size;
+    auto&& chunk = m_chunks[index];
+
+    // Only stored chunks are stable, decompressed ones can be evicted at any time.
+    if (chunk.codec != snapshot::Codec::RAW || (chunk.flags & snapshot::PARTIAL) != 0 ||
+        size > chunk.size - chunk_offset) {
+        return nullptr;
+    }
+
+    std::scoped_lock _{m_cache_mtx};
+    auto data = chunk_data(index);
+
+    return data != nullptr ? data + chunk_offset : nullptr;
+}
+
+bool SnapshotProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    auto out = (std::byte*)buffer;
+
+    std::scoped_lock _{m_cache_mtx};
+
+    while (size > 0) {
+        auto region = find_region(address);
+
+        if (region == nullptr) {
+            return false;
+        }
+
+        auto offset = address - region->start;
+        auto index = region->first_chunk + offset / m_chunk_size;
+        auto chunk_offset = offset % m_chunk_size;
+        auto n = std::min<size_t>(size, m_chunks[index].size - chunk_offset);
+        auto data = chunk_data(index);
+
+        if (data == nullptr) {
+            return false;
+        }
+
+        for (auto page = chunk_offset & ~(snapshot::PAGE_SIZE - 1); page < chunk_offset + n;
+             page += snapshot::PAGE_SIZE) {
+            if (!page_readable(index, page)) {
+                return false;
+            }
+        }
+
+        memcpy(out, data + chunk_offset, n);
+        out += n;
+        address += n;
+        size -= n;
+    }
+
+    return true;
+}
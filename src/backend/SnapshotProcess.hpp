@@ -0,0 +1,53 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedProcess.hpp"
+#include "Snapshot.hpp"
+
+// Opens a snapshot written by snapshot::capture. Only the index is read up front; chunks are decompressed the first
+// time something reads from them and a handful are kept around. Uncompressed chunks are read in place.
+class SnapshotProcess : public MappedProcess {
+public:
+    explicit SnapshotProcess(const std::filesystem::path& path);
+
+    // True if the file has a complete snapshot header.
+    static bool is_snapshot(const MappedFile& file);
+
+    bool ok() override { return m_loaded; }
+    const std::byte* view(uintptr_t address, size_t size) override;
+
+    auto&& metadata() const { return m_metadata; }
+
+protected:
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+
+private:
+    // Decompressed chunks kept around, a few MB with the default chunk size.
+    static constexpr size_t MAX_CACHED_CHUNKS = 64;
+
+    struct CachedChunk {
+        std::vector<std::byte> data{};
+        std::list<size_t>::iterator lru{};
+    };
+
+    bool m_loaded{};
+    uint32_t m_chunk_size{};
+    std::vector<snapshot::RegionEntry> m_regions{};
+    std::vector<snapshot::ChunkEntry> m_chunks{};
+    std::string m_metadata{};
+
+    std::mutex m_cache_mtx{};
+    std::unordered_map<size_t, CachedChunk> m_cache{};
+    std::list<size_t> m_lru{};
+
+    const snapshot::RegionEntry* find_region(uintptr_t address) const;
+    // Decompressed (or in place) contents of a chunk. nullptr if it's missing or corrupt. Call with m_cache_mtx held,
+    // the pointer is good until the next call.
+    const std::byte* chunk_data(size_t index);
+    // Whether the page at offset into a chunk was captured.
+    bool page_readable(size_t index, size_t offset) const;
+};
@@ -0,0 +1,287 @@
+#ifdef _WIN32
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#else
+#include <cerrno>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <climits>
+#include <mutex>
+
+#include "Socket.hpp"
+
+namespace {
+#ifdef _WIN32
+using socklen_t = int;
+
+void init_sockets() {
+    static std::once_flag once{};
+
+    std::call_once(once, [] {
+        WSADATA wsa{};
+        WSAStartup(MAKEWORD(2, 2), &wsa);
+    });
+}
+
+void close_socket(uintptr_t fd) {
+    closesocket((SOCKET)fd);
+}
+
+bool in_progress() {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+void set_blocking(uintptr_t fd, bool blocking) {
+    u_long nonblocking = blocking ? 0 : 1;
+    ioctlsocket((SOCKET)fd, FIONBIO, &nonblocking);
+}
+
+int poll_socket(pollfd* fds, int timeout_ms) {
+    return WSAPoll(fds, 1, timeout_ms);
+}
+#else
+void init_sockets() {
+}
+
+void close_socket(int fd) {
+    close(fd);
+}
+
+bool in_progress() {
+    return errno == EINPROGRESS;
+}
+
+void set_blocking(int fd, bool blocking) {
+    auto flags = fcntl(fd, F_GETFL);
+    fcntl(fd, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+}
+
+int poll_socket(pollfd* fds, int timeout_ms) {
+    return poll(fds, 1, timeout_ms);
+}
+#endif
+
+std::string format_address(const sockaddr_storage& addr) {
+    char host[NI_MAXHOST]{};
+    char port[NI_MAXSERV]{};
+
+    if (getnameinfo((const sockaddr*)&addr, sizeof(addr), host, sizeof(host), port, sizeof(port),
+            NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+        return "?";
+    }
+
+    return std::string{host} + ":" + port;
+}
+} // namespace
+
+Socket::~Socket() {
+    if (m_fd != INVALID) {
+        close_socket(m_fd);
+    }
+}
+
+std::unique_ptr<Socket> Socket::connect(const std::string& host, uint16_t port, std::chrono::milliseconds timeout) {
+    init_sockets();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* results{};
+
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &results) != 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Socket> socket{};
+
+    for (auto ai = results; ai != nullptr && socket == nullptr; ai = ai->ai_next) {
+        auto fd = (Handle)::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+
+        if (fd == INVALID) {
+            continue;
+        }
+
+        // Non-blocking connect so an unreachable host fails after timeout instead of the OS default.
+        set_blocking(fd, false);
+
+        auto connected = ::connect(fd, ai->ai_addr, (socklen_t)ai->ai_addrlen) == 0;
+
+        if (!connected && in_progress()) {
+            pollfd pfd{};
+            pfd.fd = fd;
+            pfd.events = POLLOUT;
+
+            int error{};
+            socklen_t len = sizeof(error);
+
+            connected = poll_socket(&pfd, (int)timeout.count()) == 1 &&
+                        getsockopt(fd, SOL_SOCKET, SO_ERROR, (char*)&error, &len) == 0 && error == 0;
+        }
+
+        if (!connected) {
+            close_socket(fd);
+            continue;
+        }
+
+        set_blocking(fd, true);
+        socket.reset(new Socket{fd});
+        socket->tune();
+    }
+
+    freeaddrinfo(results);
+
+    return socket;
+}
+
+std::unique_ptr<Socket> Socket::listen(const std::string& address, uint16_t port) {
+    init_sockets();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    addrinfo* results{};
+
+    if (getaddrinfo(address.empty() ? nullptr : address.c_str(), std::to_string(port).c_str(), &hints, &results) !=
+        0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Socket> socket{};
+
+    for (auto ai = results; ai != nullptr && socket == nullptr; ai = ai->ai_next) {
+        auto fd = (Handle)::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+
+        if (fd == INVALID) {
+            continue;
+        }
+
+        int reuse{1};
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+        if (bind(fd, ai->ai_addr, (socklen_t)ai->ai_addrlen) != 0 || ::listen(fd, 4) != 0) {
+            close_socket(fd);
+            continue;
+        }
+
+        socket.reset(new Socket{fd});
+    }
+
+    freeaddrinfo(results);
+
+    return socket;
+}
+
+std::unique_ptr<Socket> Socket::accept() {
+    auto fd = (Handle)::accept(m_fd, nullptr, nullptr);
+
+    if (fd == INVALID) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Socket> socket{new Socket{fd}};
+    socket->tune();
+
+    return socket;
+}
+
+void Socket::tune() {
+    int nodelay{1};
+    int buffer_size{1024 * 1024};
+
+    setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+    setsockopt(m_fd, SOL_SOCKET, SO_SNDBUF, (const char*)&buffer_size, sizeof(buffer_size));
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, (const char*)&buffer_size, sizeof(buffer_size));
+}
+
+bool Socket::send_all(const void* data, size_t size) {
+    auto p = (const char*)data;
+
+    while (size > 0) {
+#ifdef _WIN32
+        auto n = ::send(m_fd, p, (int)std::min<size_t>(size, INT_MAX), 0);
+#else
+        // A peer that went away shouldn't kill us with SIGPIPE.
+        auto n = ::send(m_fd, p, size, MSG_NOSIGNAL);
+#endif
+
+        if (n <= 0) {
+            return false;
+        }
+
+        p += n;
+        size -= (size_t)n;
+    }
+
+    return true;
+}
+
+bool Socket::recv_all(void* data, size_t size) {
+    auto p = (char*)data;
+
+    while (size > 0) {
+#ifdef _WIN32
+        auto n = ::recv(m_fd, p, (int)std::min<size_t>(size, INT_MAX), 0);
+#else
+        auto n = ::recv(m_fd, p, size, 0);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+
+        if (n <= 0) {
+            return false;
+        }
+
+        p += n;
+        size -= (size_t)n;
+    }
+
+    return true;
+}
+
+void Socket::shutdown() {
+#ifdef _WIN32
+    ::shutdown(m_fd, SD_BOTH);
+#else
+    ::shutdown(m_fd, SHUT_RDWR);
+#endif
+}
+
+uint16_t Socket::port() const {
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+
+    if (getsockname(m_fd, (sockaddr*)&addr, &len) != 0) {
+        return 0;
+    }
+
+    if (addr.ss_family == AF_INET6) {
+        return ntohs(((const sockaddr_in6*)&addr)->sin6_port);
+    }
+
+    return ntohs(((const sockaddr_in*)&addr)->sin_port);
+}
+
+std::string Socket::peer() const {
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+
+    if (getpeername(m_fd, (sockaddr*)&addr, &len) != 0) {
+        return "?";
+    }
+
+    return format_address(addr);
+}
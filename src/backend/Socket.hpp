@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Blocking TCP socket. Only what the remote backend needs: connect, listen/accept and sending or receiving whole
+// buffers.
+class Socket {
+public:
+    Socket() = default;
+    ~Socket();
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    // nullptr if host:port can't be reached within timeout.
+    static std::unique_ptr<Socket> connect(const std::string& host, uint16_t port, std::chrono::milliseconds timeout);
+    // Listens on address:port ("0.0.0.0" for every interface). Port 0 picks a free one, see port().
+    static std::unique_ptr<Socket> listen(const std::string& address, uint16_t port);
+
+    // Blocks until a client connects. nullptr once the listening socket is closed.
+    std::unique_ptr<Socket> accept();
+
+    bool send_all(const void* data, size_t size);
+    bool recv_all(void* data, size_t size);
+
+    // Unblocks anyone waiting in accept or recv_all on another thread.
+    void shutdown();
+
+    bool ok() const { return m_fd != INVALID; }
+    uint16_t port() const;
+    // "host:port" of the other side.
+    std::string peer() const;
+
+private:
+#ifdef _WIN32
+    using Handle = uintptr_t;
+    static constexpr Handle INVALID = ~(Handle)0;
+#else
+    using Handle = int;
+    static constexpr Handle INVALID = -1;
+#endif
+
+    Handle m_fd{INVALID};
+
+    explicit Socket(Handle fd) : m_fd{fd} {}
+
+    // Small requests go out immediately and big responses don't stall on the default buffer sizes.
+    void tune();
+};
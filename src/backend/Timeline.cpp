@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "Timeline.hpp"
+
+uint64_t Timeline::hash_page(const std::byte* page) {
+    // Four independent multiply/xorshift lanes, combined at the end. Only needs to be fast and spread well; equal
+    // hashes are confirmed with memcmp before pages are shared.
+    constexpr uint64_t K = 0x9E3779B97F4A7C15ull;
+    uint64_t lanes[4]{1, 2, 3, 4};
+
+    for (size_t i = 0; i < PAGE_SIZE; i += sizeof(lanes)) {
+        for (size_t j = 0; j < 4; ++j) {
+            uint64_t word{};
+
+            memcpy(&word, page + i + j * sizeof(uint64_t), sizeof(word));
+            lanes[j] = (lanes[j] ^ word) * K;
+            lanes[j] ^= lanes[j] >> 29;
+        }
+    }
+
+    auto h = lanes[0];
+
+    for (size_t j = 1; j < 4; ++j) {
+        h = (h ^ lanes[j]) * K;
+        h ^= h >> 32;
+    }
+
+    return h;
+}
+
+uint32_t Timeline::intern(const std::byte* page, uint64_t hash, bool& added) {
+    added = false;
+
+    auto search = m_by_hash.find(hash);
+
+    if (search != m_by_hash.end() && memcmp(m_pages[search->second]->data(), page, PAGE_SIZE) == 0) {
+        ++m_refs[search->second];
+        return search->second;
+    }
+
+    uint32_t id{};
+
+    if (!m_free.empty()) {
+        id = m_free.back();
+        m_free.pop_back();
+    } else {
+        id = (uint32_t)m_pages.size();
+        m_pages.emplace_back();
+        m_hashes.emplace_back();
+        m_refs.emplace_back();
+    }
+
+    m_pages[id] = std::make_unique<Page>();
+    memcpy(m_pages[id]->data(), page, PAGE_SIZE);
+    m_hashes[id] = hash;
+    m_refs[id] = 1;
+    added = true;
+
+    // On a genuine collision the older page keeps the slot and this one just isn't shared.
+    if (search == m_by_hash.end()) {
+        m_by_hash.emplace(hash, id);
+    }
+
+    return id;
+}
+
+void Timeline::release(uint32_t id) {
+    if (id == NO_PAGE || --m_refs[id] != 0) {
+        return;
+    }
+
+    if (auto search = m_by_hash.find(m_hashes[id]); search != m_by_hash.end() && search->second == id) {
+        m_by_hash.erase(search);
+    }
+
+    m_pages[id].reset();
+    m_free.emplace_back(id);
+}
+
+void Timeline::drop_oldest() {
+    for (auto id : m_points.front().pages) {
+        release(id);
+    }
+
+    m_points.erase(m_points.begin());
+}
+
+const Timeline::Point* Timeline::find(uint64_t id) const {
+    auto it = std::lower_bound(
+        m_points.begin(), m_points.end(), id, [](auto&& p, uint64_t id) { return p.info.id < id; });
+
+    return it != m_points.end() && it->info.id == id ? &*it : nullptr;
+}
+
+uint64_t Timeline::capture(Process& process, std::vector<Range> ranges, size_t threads) {
+    constexpr size_t BATCH_PAGES = 64;
+
+    auto start_time = std::chrono::steady_clock::now();
+    Point point{};
+
+    point.info.time = std::chrono::system_clock::now();
+
+    for (auto&& r : ranges) {
+        r.start &= ~(PAGE_SIZE - 1);
+        r.end = (r.end + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](auto&& a, auto&& b) { return a.start < b.start; });
+
+    for (auto&& r : ranges) {
+        if (r.end <= r.start) {
+            continue;
+        }
+
+        if (!point.ranges.empty() && r.start <= point.ranges.back().end) {
+            point.ranges.back().end = std::max(point.ranges.back().end, r.end);
+        } else {
+            point.ranges.emplace_back(r);
+        }
+    }
+
+    // Batches never cross ranges so each one is a single contiguous read.
+    struct Batch {
+        uintptr_t address{};
+        size_t pages{};
+        size_t first_page{};
+    };
+
+    std::vector<Batch> batches{};
+    size_t page_count{};
+
+    for (auto&& r : point.ranges) {
+        point.first_page.emplace_back(page_count);
+
+        for (auto address = r.start; address < r.end; address += BATCH_PAGES * PAGE_SIZE) {
+            auto pages = std::min<size_t>(BATCH_PAGES, (r.end - address) / PAGE_SIZE);
+
+            batches.emplace_back(address, pages, page_count);
+            page_count += pages;
+        }
+    }
+
+    point.pages.resize(page_count, NO_PAGE);
+
+    std::atomic<size_t> next{};
+    std::atomic<size_t> new_pages{};
+    auto thread_count = threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+
+    thread_count = std::min(thread_count, std::max<size_t>(batches.size(), 1));
+
+    auto worker = [&] {
+        std::vector<std::byte> data(BATCH_PAGES * PAGE_SIZE);
+        std::vector<uint64_t> hashes(BATCH_PAGES);
+        std::vector<bool> readable(BATCH_PAGES);
+
+        for (auto i = next++; i < batches.size(); i = next++) {
+            auto&& batch = batches[i];
+            auto all = process.read_direct(batch.address, data.data(), batch.pages * PAGE_SIZE);
+
+            // Reading and hashing happens outside the lock, only interning the pages needs it.
+            for (size_t j = 0; j < batch.pages; ++j) {
+                auto page = data.data() + j * PAGE_SIZE;
+
+                readable[j] = all || process.read_direct(batch.address + j * PAGE_SIZE, page, PAGE_SIZE);
+                hashes[j] = readable[j] ? hash_page(page) : 0;
+            }
+
+            std::unique_lock _{m_mtx};
+
+            for (size_t j = 0; j < batch.pages; ++j) {
+                if (!readable[j]) {
+                    continue;
+                }
+
+                auto added = false;
+
+                point.pages[batch.first_page + j] = intern(data.data() + j * PAGE_SIZE, hashes[j], added);
+                new_pages += added ? 1 : 0;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers{};
+
+    for (size_t i = 1; i < thread_count; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto&& t : workers) {
+        t.join();
+    }
+
+    point.info.pages = page_count;
+    point.info.new_pages = new_pages;
+    point.info.duration = std::chrono::steady_clock::now() - start_time;
+
+    std::unique_lock _{m_mtx};
+
+    auto id = point.info.id = m_next_id++;
+
+    m_points.emplace_back(std::move(point));
+
+    while (m_max_points != 0 && m_points.size() > m_max_points) {
+        drop_oldest();
+    }
+
+    return id;
+}
+
+Timeline::ReadResult Timeline::read(uint64_t point_id, uintptr_t address, void* buffer, size_t size) const {
+    std::shared_lock _{m_mtx};
+
+    auto p = find(point_id);
+
+    if (p == nullptr) {
+        return ReadResult::NO_POINT;
+    }
+
+    if (size == 0) {
+        return ReadResult::NOT_CAPTURED;
+    }
+
+    auto&& point = *p;
+    auto out = (std::byte*)buffer;
+
+    while (size > 0) {
+        auto it = std::upper_bound(point.ranges.begin(), point.ranges.end(), address,
+            [](uintptr_t addr, auto&& r) { return addr < r.start; });
+
+        if (it == point.ranges.begin() || address >= (it - 1)->end) {
+            return ReadResult::NOT_CAPTURED;
+        }
+
+        auto&& range = *(it - 1);
+        auto page_offset = (address - range.start) / PAGE_SIZE;
+        auto offset = address & (PAGE_SIZE - 1);
+        auto n = std::min(size, PAGE_SIZE - offset);
+        auto id = point.pages[point.first_page[it - 1 - point.ranges.begin()] + page_offset];
+
+        if (id == NO_PAGE) {
+            return ReadResult::UNREADABLE;
+        }
+
+        memcpy(out, m_pages[id]->data() + offset, n);
+        out += n;
+        address += n;
+        size -= n;
+    }
+
+    return ReadResult::OK;
+}
+
+std::optional<uint32_t> Timeline::page_id(uint64_t point_id, uintptr_t page_address) const {
+    std::shared_lock _{m_mtx};
+
+    auto p = find(point_id);
+
+    if (p == nullptr) {
+        return std::nullopt;
+    }
+
+    auto&& point = *p;
+    auto it = std::upper_bound(point.ranges.begin(), point.ranges.end(), page_address,
+        [](uintptr_t addr, auto&& r) { return addr < r.start; });
+
+    if (it == point.ranges.begin() || page_address >= (it - 1)->end) {
+        return std::nullopt;
+    }
+
+    auto index = it - 1 - point.ranges.begin();
+
+    return point.pages[point.first_page[index] + (page_address - point.ranges[index].start) / PAGE_SIZE];
+}
+
+bool Timeline::contains(uint64_t point) const {
+    std::shared_lock _{m_mtx};
+    return find(point) != nullptr;
+}
+
+size_t Timeline::size() const {
+    std::shared_lock _{m_mtx};
+    return m_points.size();
+}
+
+std::vector<Timeline::PointInfo> Timeline::points() const {
+    std::shared_lock _{m_mtx};
+    std::vector<PointInfo> points{};
+
+    for (auto&& p : m_points) {
+        points.emplace_back(p.info);
+    }
+
+    return points;
+}
+
+Timeline::Stats Timeline::stats() const {
+    std::shared_lock _{m_mtx};
+    Stats stats{};
+
+    stats.points = m_points.size();
+    stats.unique_pages = m_pages.size() - m_free.size();
+
+    for (auto&& p : m_points) {
+        stats.logical_pages += p.pages.size();
+    }
+
+    return stats;
+}
+
+void Timeline::max_points(size_t max_points) {
+    std::unique_lock _{m_mtx};
+
+    m_max_points = max_points;
+
+    while (m_max_points != 0 && m_points.size() > m_max_points) {
+        drop_oldest();
+    }
+}
+
+void Timeline::clear() {
+    std::unique_lock _{m_mtx};
+
+    m_points.clear();
+    m_pages.clear();
+    m_hashes.clear();
+    m_refs.clear();
+    m_free.clear();
+    m_by_hash.clear();
+}
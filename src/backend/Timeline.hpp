@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Process.hpp"
+
+// A series of memory captures ("points") that share storage. Every page is hashed and stored once no matter how many
+// points contain it, so capturing a mostly static process over and over costs little more than capturing it once.
+class Timeline {
+public:
+    static constexpr size_t PAGE_SIZE = 0x1000;
+    // Page id of pages that couldn't be read.
+    static constexpr uint32_t NO_PAGE = ~0u;
+
+    struct Range {
+        uintptr_t start{};
+        uintptr_t end{};
+    };
+
+    struct PointInfo {
+        // Never reused, and unaffected by older points being dropped. What read() and page_id() take.
+        uint64_t id{};
+        std::chrono::system_clock::time_point time{};
+        size_t pages{};
+        // Pages whose contents no earlier (still stored) point had.
+        size_t new_pages{};
+        std::chrono::nanoseconds duration{};
+    };
+
+    struct Stats {
+        size_t points{};
+        size_t unique_pages{};
+        // Pages across all points, what storing them without deduplication would take.
+        size_t logical_pages{};
+    };
+
+    enum class ReadResult {
+        OK,
+        // The point covers the range but some of it couldn't be read when it was captured.
+        UNREADABLE,
+        // The point didn't capture (all of) the range.
+        NOT_CAPTURED,
+        // There's no such point (any more).
+        NO_POINT,
+    };
+
+    explicit Timeline(size_t max_points = 256) : m_max_points{max_points} {}
+
+    // Captures the ranges (page aligned outwards) as a new point and returns its id. Oldest points are dropped past
+    // max_points. Safe to call while other threads read older points.
+    uint64_t capture(Process& process, std::vector<Range> ranges, size_t threads = 0);
+
+    ReadResult read(uint64_t point, uintptr_t address, void* buffer, size_t size) const;
+    // Storage id of the page at a page aligned address, nullopt if the point didn't capture it. Pages are stored once,
+    // so two points hold the same contents at an address exactly when their ids match.
+    std::optional<uint32_t> page_id(uint64_t point, uintptr_t page_address) const;
+
+    // Whether the point with this id is still stored.
+    bool contains(uint64_t point) const;
+    size_t size() const;
+    std::vector<PointInfo> points() const;
+    Stats stats() const;
+
+    void max_points(size_t max_points);
+    size_t max_points() const { return m_max_points; }
+    void clear();
+
+private:
+    using Page = std::array<std::byte, PAGE_SIZE>;
+
+    struct Point {
+        PointInfo info{};
+        // Sorted, non-overlapping, page aligned. Page ids for each range are consecutive in pages, starting at
+        // first_page.
+        std::vector<Range> ranges{};
+        std::vector<size_t> first_page{};
+        std::vector<uint32_t> pages{};
+    };
+
+    mutable std::shared_mutex m_mtx{};
+    size_t m_max_points{};
+    // Oldest first, so ids are ascending.
+    std::vector<Point> m_points{};
+    uint64_t m_next_id{};
+
+    // Content addressed page store. Ids index every vector below; freed ids are reused.
+    std::vector<std::unique_ptr<Page>> m_pages{};
+    std::vector<uint64_t> m_hashes{};
+    std::vector<uint32_t> m_refs{};
+    std::vector<uint32_t> m_free{};
+    std::unordered_map<uint64_t, uint32_t> m_by_hash{};
+
+    static uint64_t hash_page(const std::byte* page);
+
+    // nullptr if the point was dropped (or never existed). Call with m_mtx held.
+    const Point* find(uint64_t id) const;
+
+    // Returns the id of a page with these contents, storing it if it's new. Call with m_mtx held exclusively.
+    uint32_t intern(const std::byte* page, uint64_t hash, bool& added);
+    void release(uint32_t id);
+    void drop_oldest();
+};
@@ -0,0 +1,136 @@
+#include "TimelineProcess.hpp"
+
+TimelineProcess::TimelineProcess(
+    std::unique_ptr<Process> inner, std::chrono::milliseconds interval, size_t max_points)
+    : Process{}, m_inner{std::move(inner)}, m_timeline{max_points}, m_interval{interval} {
+    m_modules = m_inner->modules();
+    m_allocations = m_inner->allocations();
+    rebuild_region_index();
+
+    // The wrapped process keeps its own page caches for live reads; caching timeline reads out here would serve stale
+    // points after scrubbing.
+    m_mapped = true;
+
+    update_ranges(m_allocations);
+    m_thread = std::thread{&TimelineProcess::capture_loop, this};
+}
+
+TimelineProcess::~TimelineProcess() {
+    stop();
+}
+
+std::unique_ptr<Process> TimelineProcess::release() {
+    stop();
+    return std::move(m_inner);
+}
+
+void TimelineProcess::stop() {
+    {
+        std::scoped_lock _{m_mtx};
+        m_stop = true;
+    }
+
+    m_cv.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void TimelineProcess::request_capture() {
+    {
+        std::scoped_lock _{m_mtx};
+        m_capture_requested = true;
+    }
+
+    m_cv.notify_all();
+}
+
+void TimelineProcess::interval(std::chrono::milliseconds interval) {
+    {
+        std::scoped_lock _{m_mtx};
+        m_interval = interval;
+    }
+
+    m_cv.notify_all();
+}
+
+void TimelineProcess::capture_loop() {
+    std::unique_lock lk{m_mtx};
+
+    // Captures once right away so there's always a point to scrub back to. Only read_direct is used on the wrapped
+    // process so this never touches its map while the main thread is applying a new one.
+    while (!m_stop) {
+        m_capture_requested = false;
+        lk.unlock();
+
+        std::vector<Timeline::Range> ranges{};
+
+        {
+            std::scoped_lock _{m_ranges_mtx};
+            ranges = m_ranges;
+        }
+
+        m_timeline.capture(*m_inner, std::move(ranges));
+
+        lk.lock();
+
+        auto wake = [this] { return m_stop || m_capture_requested; };
+
+        if (m_interval.count() > 0) {
+            m_cv.wait_for(lk, m_interval, wake);
+        } else {
+            m_cv.wait(lk, wake);
+        }
+    }
+}
+
+void TimelineProcess::update_ranges(const std::vector<Allocation>& allocations) {
+    std::vector<Timeline::Range> ranges{};
+
+    // Read-only memory doesn't change between points, the live process serves it.
+    for (auto&& a : allocations) {
+        if (a.read && a.write) {
+            ranges.emplace_back(a.start, a.end);
+        }
+    }
+
+    std::scoped_lock _{m_ranges_mtx};
+    m_ranges = std::move(ranges);
+}
+
+void TimelineProcess::apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) {
+    m_inner->apply_map(snapshot, events);
+    update_ranges(snapshot.allocations);
+    Process::apply_map(std::move(snapshot), events);
+}
+
+bool TimelineProcess::handle_write(uintptr_t address, const void* buffer, size_t size) {
+    return m_inner->write(address, buffer, size);
+}
+
+bool TimelineProcess::handle_read(uintptr_t address, void* buffer, size_t size) {
+    auto point = m_point.load();
+
+    if (point != LIVE) {
+        switch (m_timeline.read(point, address, buffer, size)) {
+        case Timeline::ReadResult::OK:
+            return true;
+        case Timeline::ReadResult::UNREADABLE:
+        case Timeline::ReadResult::NO_POINT:
+            return false;
+        case Timeline::ReadResult::NOT_CAPTURED:
+            break;
+        }
+    }
+
+    return m_inner->read(address, buffer, size);
+}
+
+std::optional<uint64_t> TimelineProcess::handle_protect(uintptr_t address, size_t size, uint64_t flags) {
+    return m_inner->protect(address, size, flags);
+}
+
+std::optional<uintptr_t> TimelineProcess::handle_allocate(uintptr_t address, size_t size, uint64_t flags) {
+    return m_inner->allocate(address, size, flags);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Process.hpp"
+#include "Timeline.hpp"
+
+// Wraps another process and captures its writable memory into a Timeline every interval. Reads come from the live
+// process until a point is selected, then from that point (falling back to the live process for anything the point
+// didn't capture, like read-only memory).
+class TimelineProcess : public Process {
+public:
+    static constexpr auto LIVE = ~uint64_t{};
+
+    TimelineProcess(std::unique_ptr<Process> inner, std::chrono::milliseconds interval, size_t max_points);
+    ~TimelineProcess() override;
+
+    auto&& inner() const { return m_inner; }
+    auto&& timeline() { return m_timeline; }
+    auto&& timeline() const { return m_timeline; }
+
+    // Stops capturing and hands back the wrapped process.
+    std::unique_ptr<Process> release();
+
+    // Id of the timeline point reads are served from, LIVE for the process itself. Once the point is dropped reads fail
+    // rather than quietly showing another one.
+    uint64_t point() const { return m_point; }
+    void point(uint64_t point) { m_point = point; }
+
+    // Wakes the capture thread for a capture now rather than at the next interval.
+    void request_capture();
+    // 0 only captures on request.
+    void interval(std::chrono::milliseconds interval);
+
+    uint32_t process_id() override { return m_inner != nullptr ? m_inner->process_id() : 0; }
+    bool ok() override { return m_inner != nullptr && m_inner->ok(); }
+
+    std::optional<MapSnapshot> snapshot_map() override { return m_inner->snapshot_map(); }
+    void apply_map(MapSnapshot snapshot, const std::vector<MapEvent>& events) override;
+
+    // A captured point can't tear, only the live process needs stopping.
+    bool suspend() override { return m_point == LIVE && m_inner->suspend(); }
+    void resume() override { m_inner->resume(); }
+
+protected:
+    bool handle_write(uintptr_t address, const void* buffer, size_t size) override;
+    bool handle_read(uintptr_t address, void* buffer, size_t size) override;
+    std::optional<uint64_t> handle_protect(uintptr_t address, size_t size, uint64_t flags) override;
+    std::optional<uintptr_t> handle_allocate(uintptr_t address, size_t size, uint64_t flags) override;
+
+private:
+    std::unique_ptr<Process> m_inner{};
+    Timeline m_timeline;
+    std::atomic<uint64_t> m_point{LIVE};
+
+    // What gets captured: the readable, writable allocations. Updated with the map, read by the capture thread.
+    std::mutex m_ranges_mtx{};
+    std::vector<Timeline::Range> m_ranges{};
+
+    std::mutex m_mtx{};
+    std::condition_variable m_cv{};
+    std::chrono::milliseconds m_interval{};
+    bool m_capture_requested{};
+    bool m_stop{};
+    std::thread m_thread{};
+
+    void update_ranges(const std::vector<Allocation>& allocations);
+    void stop();
+    void capture_loop();
+};
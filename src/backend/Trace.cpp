@@ -0,0 +1,233 @@
+#include <cstring>
+
+#include "Trace.hpp"
+
+namespace trace {
+Writer::Writer(const std::filesystem::path& path) : m_file{path, std::ios::binary | std::ios::trunc} {
+    m_ok = m_file.good();
+
+    bytes(MAGIC, sizeof(MAGIC));
+    varint(VERSION);
+    write_buffer();
+}
+
+void Writer::process(uint32_t process_id) {
+    std::scoped_lock _{m_mtx};
+
+    m_buffer.push_back((uint8_t)Tag::PROCESS);
+    varint(process_id);
+    write_buffer();
+}
+
+void Writer::map(const std::vector<Process::Module>& modules, const std::vector<Process::Allocation>& allocations) {
+    std::scoped_lock _{m_mtx};
+
+    m_buffer.push_back((uint8_t)Tag::MAP);
+    varint(modules.size());
+    varint(allocations.size());
+
+    for (auto&& m : modules) {
+        varint(m.start);
+        varint(m.end);
+        varint(m.name.size());
+        bytes(m.name.data(), m.name.size());
+    }
+
+    for (auto&& a : allocations) {
+        varint(a.start);
+        varint(a.end);
+        varint((a.read ? 1 : 0) | (a.write ? 2 : 0) | (a.execute ? 4 : 0));
+    }
+
+    write_buffer();
+}
+
+void Writer::read(uintptr_t address, const void* buffer, size_t size, std::chrono::nanoseconds latency, bool ok) {
+    auto timestamp = std::chrono::steady_clock::now() - m_start;
+
+    std::scoped_lock _{m_mtx};
+
+    m_buffer.push_back((uint8_t)Tag::READ);
+    varint(address);
+    varint(size);
+    varint((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp).count());
+    varint((uint64_t)latency.count());
+    m_buffer.push_back(ok ? 1 : 0);
+
+    if (ok) {
+        bytes(buffer, size);
+    }
+
+    // Reads are small and frequent, let them pile up a bit before touching the stream.
+    if (m_buffer.size() >= 0x10000) {
+        write_buffer();
+    }
+}
+
+void Writer::flush() {
+    std::scoped_lock _{m_mtx};
+    write_buffer();
+    m_file.flush();
+}
+
+void Writer::varint(uint64_t value) {
+    while (value >= 0x80) {
+        m_buffer.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+
+    m_buffer.push_back((uint8_t)value);
+}
+
+void Writer::bytes(const void* data, size_t size) {
+    auto p = (const uint8_t*)data;
+    m_buffer.insert(m_buffer.end(), p, p + size);
+}
+
+void Writer::write_buffer() {
+    m_file.write((const char*)m_buffer.data(), m_buffer.size());
+    m_buffer.clear();
+    m_ok = m_ok && m_file.good();
+}
+
+std::optional<Trace> load(const std::filesystem::path& path) {
+    std::ifstream f{path, std::ios::binary};
+
+    if (!f) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> file{std::istreambuf_iterator<char>{f}, {}};
+    auto p = file.data();
+    auto end = file.data() + file.size();
+
+    auto varint = [&](uint64_t& out) {
+        out = 0;
+
+        for (auto shift = 0; p < end && shift < 64; shift += 7) {
+            auto b = *p++;
+            out |= (uint64_t)(b & 0x7F) << shift;
+
+            if ((b & 0x80) == 0) {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    if (file.size() < sizeof(MAGIC) || memcmp(p, MAGIC, sizeof(MAGIC)) != 0) {
+        return std::nullopt;
+    }
+
+    p += sizeof(MAGIC);
+
+    uint64_t version{};
+
+    if (!varint(version) || version != VERSION) {
+        return std::nullopt;
+    }
+
+    Trace trace{};
+
+    auto next_record = [&] {
+        auto tag = (Tag)*p++;
+        uint64_t a{}, b{}, c{}, d{};
+
+        switch (tag) {
+        case Tag::PROCESS:
+            if (!varint(a)) {
+                return false;
+            }
+
+            trace.process_id = (uint32_t)a;
+            break;
+
+        case Tag::MAP: {
+            if (!varint(a) || !varint(b)) {
+                return false;
+            }
+
+            Process::MapSnapshot map{};
+
+            for (uint64_t i = 0; i < a; ++i) {
+                Process::Module m{};
+
+                if (!varint(c) || !varint(d)) {
+                    return false;
+                }
+
+                m.start = (uintptr_t)c;
+                m.end = (uintptr_t)d;
+                m.size = m.end - m.start;
+
+                if (!varint(c) || c > (uint64_t)(end - p)) {
+                    return false;
+                }
+
+                m.name.assign((const char*)p, c);
+                p += c;
+                map.modules.emplace_back(std::move(m));
+            }
+
+            for (uint64_t i = 0; i < b; ++i) {
+                Process::Allocation alloc{};
+                uint64_t prot{};
+
+                if (!varint(c) || !varint(d) || !varint(prot)) {
+                    return false;
+                }
+
+                alloc.start = (uintptr_t)c;
+                alloc.end = (uintptr_t)d;
+                alloc.size = alloc.end - alloc.start;
+                alloc.read = prot & 1;
+                alloc.write = prot & 2;
+                alloc.execute = prot & 4;
+                map.allocations.emplace_back(alloc);
+            }
+
+            trace.map = std::move(map);
+        } break;
+
+        case Tag::READ: {
+            Read r{};
+            uint64_t timestamp{}, latency{};
+
+            if (!varint(a) || !varint(b) || !varint(timestamp) || !varint(latency) || p >= end) {
+                return false;
+            }
+
+            r.address = (uintptr_t)a;
+            r.size = (uint32_t)b;
+            r.timestamp = std::chrono::nanoseconds{timestamp};
+            r.latency = std::chrono::nanoseconds{latency};
+            r.ok = *p++ != 0;
+
+            if (r.ok) {
+                if (r.size > (uint64_t)(end - p)) {
+                    return false;
+                }
+
+                r.data_offset = trace.data.size();
+                trace.data.insert(trace.data.end(), (const std::byte*)p, (const std::byte*)p + r.size);
+                p += r.size;
+            }
+
+            trace.reads.emplace_back(r);
+        } break;
+
+        default:
+            return false;
+        }
+
+        return true;
+    };
+
+    // A trace cut short (the recorder crashed, the disk filled up) is still good up to the last complete record.
+    while (p < end && next_record()) {
+    }
+
+    return trace;
+}
+} // namespace trace
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Process.hpp"
+
+// Trace files written by RecordingProcess and played back by ReplayProcess.
+//
+// Layout: the 8 byte magic and a varint version, followed by records. Each record is a one byte tag followed by
+// varint encoded fields:
+//   PROCESS     process_id
+//   MAP         module count, allocation count, then each module (start, end, name length, name) and each
+//               allocation (start, end, protection bits). A MAP replaces the previous one.
+//   READ        address, size, timestamp (ns since the trace started), latency (ns), ok, then size bytes if ok.
+namespace trace {
+constexpr char MAGIC[8] = {'R', 'G', 'T', 'R', 'A', 'C', 'E', '\0'};
+constexpr uint64_t VERSION = 1;
+
+enum class Tag : uint8_t {
+    PROCESS = 1,
+    MAP = 2,
+    READ = 3,
+};
+
+struct Read {
+    uintptr_t address{};
+    uint32_t size{};
+    std::chrono::nanoseconds timestamp{};
+    std::chrono::nanoseconds latency{};
+    bool ok{};
+    // Offset of the data in Trace::data.
+    size_t data_offset{};
+};
+
+struct Trace {
+    uint32_t process_id{};
+    Process::MapSnapshot map{};
+    std::vector<Read> reads{};
+    std::vector<std::byte> data{};
+};
+
+class Writer {
+public:
+    explicit Writer(const std::filesystem::path& path);
+
+    bool ok() const { return m_ok; }
+
+    void process(uint32_t process_id);
+    void map(const std::vector<Process::Module>& modules, const std::vector<Process::Allocation>& allocations);
+    void read(uintptr_t address, const void* buffer, size_t size, std::chrono::nanoseconds latency, bool ok);
+    void flush();
+
+private:
+    std::mutex m_mtx{};
+    std::ofstream m_file{};
+    std::chrono::steady_clock::time_point m_start{std::chrono::steady_clock::now()};
+    std::vector<uint8_t> m_buffer{};
+    bool m_ok{};
+
+    void varint(uint64_t value);
+    void bytes(const void* data, size_t size);
+    void write_buffer();
+};
+
+// Reads the whole trace. Only the last MAP record is kept. nullopt if the file is missing or not a trace.
+std::optional<Trace> load(const std::filesystem::path& path);
+} // namespace trace
@@ -93,6 +93,16 @@ void Array::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
     }
 }
 
+void Array::collect_reads(std::vector<std::pair<uintptr_t, size_t>>& ranges) {
+    if (is_collapsed()) {
+        return;
+    }
+
+    for (auto&& element : m_elements) {
+        element->collect_reads(ranges);
+    }
+}
+
 void Array::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     Base::update(address, offset, mem);
     m_value_str.clear();
@@ -9,6 +9,8 @@
 
 namespace node {
 int Base::indentation_level = -1;
+std::shared_ptr<const diff::Result> Base::changes{};
+std::optional<bool> Base::refresh_now{};
 
 Base::Base(Config& cfg, Process& process, Property& props) : m_cfg{cfg}, m_process{process}, m_props{props} {
 }
@@ -79,7 +81,12 @@ void Base::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
 }
 
 void Base::display_address_offset(uintptr_t address, uintptr_t offset) {
-    ImGui::PushStyleColor(ImGuiCol_Text, {0.6f, 0.6f, 0.6f, 1.0f});
+    if (changes != nullptr && changes->changed(address, address + size())) {
+        ImGui::PushStyleColor(ImGuiCol_Text, {1.0f, 0.6f, 0.2f, 1.0f});
+    } else {
+        ImGui::PushStyleColor(ImGuiCol_Text, {0.6f, 0.6f, 0.6f, 1.0f});
+    }
+
     ImGui::TextUnformatted(m_preamble_str.c_str());
     ImGui::PopStyleColor();
 
@@ -2,10 +2,15 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../Config.hpp"
 #include "../Process.hpp"
+#include "../backend/Diff.hpp"
 #include "Property.hpp"
 
 namespace node {
@@ -16,9 +21,18 @@ public:
     virtual void display(uintptr_t address, uintptr_t offset, std::byte* mem) = 0;
     virtual size_t size() = 0;
     virtual void update(uintptr_t address, uintptr_t offset, std::byte* mem);
+    // The (address, size) of every read the visible part of this node's subtree made on its last refresh.
+    virtual void collect_reads(std::vector<std::pair<uintptr_t, size_t>>& ranges) {}
 
     auto& props() { return m_props; }
 
+    // Result of the last diff. Nodes overlapping a changed range are highlighted.
+    static std::shared_ptr<const diff::Result> changes;
+
+    // Set by MemoryUi in consistent read mode: true for the frame every visible pointer re-reads its memory (from the
+    // frozen copy), false for the frames in between. nullopt otherwise, each pointer then refreshes on its own timer.
+    static std::optional<bool> refresh_now;
+
 protected:
     static int indentation_level;
     Config& m_cfg;
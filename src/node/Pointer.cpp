@@ -206,21 +206,33 @@ void Pointer::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
         fmt::format_to(std::back_inserter(m_address_str), "obj*:{:s} ", *tn);
     }
 
-    for (auto&& mod : m_process.modules()) {
-        if (mod.start <= addr && addr <= mod.end) {
-            fmt::format_to(std::back_inserter(m_address_str), "<{}>+0x{:X}", mod.name, addr - mod.start);
-            // Bail here so we don't try previewing this pointer as something else.
-            return;
-        }
+    auto region = m_process.get_region_within(addr);
+
+    if (!region) {
+        return;
     }
 
-    for (auto&& allocation : m_process.allocations()) {
-        if (allocation.start <= addr && addr <= allocation.end) {
-            fmt::format_to(std::back_inserter(m_address_str), "0x{:X}", addr);
-            // Bail here so we don't try previewing this pointer as something else.
-            return;
-        }
+    if (region->module != RegionIndex::npos) {
+        auto&& mod = m_process.modules()[region->module];
+        fmt::format_to(std::back_inserter(m_address_str), "<{}>+0x{:X}", mod.name, addr - mod.start);
+        // Bail here so we don't try previewing this pointer as something else.
+        return;
+    }
+
+    if (region->allocation != RegionIndex::npos) {
+        fmt::format_to(std::back_inserter(m_address_str), "0x{:X}", addr);
+        // Bail here so we don't try previewing this pointer as something else.
+        return;
+    }
+}
+
+void Pointer::collect_reads(std::vector<std::pair<uintptr_t, size_t>>& ranges) {
+    if ((is_collapsed() && !m_is_hovered) || m_ptr_node == nullptr || m_mem.empty()) {
+        return;
     }
+
+    ranges.emplace_back(m_address, m_mem.size());
+    m_ptr_node->collect_reads(ranges);
 }
 
 void Pointer::refresh_memory() {
@@ -228,11 +240,16 @@ void Pointer::refresh_memory() {
         return;
     }
 
-    if (auto now = std::chrono::steady_clock::now(); now >= m_mem_refresh_time) {
+    auto now = std::chrono::steady_clock::now();
+    auto size = m_ptr->to()->size() * array_count();
+    // A pointer that was just expanded (or resized) reads straight away, consistent mode or not.
+    auto due = (refresh_now ? *refresh_now : now >= m_mem_refresh_time) || m_mem.size() != size;
+
+    if (due) {
         m_mem_refresh_time = now + std::chrono::milliseconds(m_cfg.refresh_rate);
 
         // Make sure our memory buffer is large enough (since the first refresh it wont be).
-        m_mem.resize(m_ptr->to()->size() * array_count());
+        m_mem.resize(size);
         m_process.read(m_address, m_mem.data(), m_mem.size());
         m_ptr_node->update(m_address, 0, &m_mem[0]);
     }
@@ -12,6 +12,7 @@ public:
 
     void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
     void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void collect_reads(std::vector<std::pair<uintptr_t, size_t>>& ranges) override;
 
     auto is_collapsed(bool is_collapsed) {
         m_props["__collapsed"].set(is_collapsed);
@@ -195,6 +195,16 @@ void Struct::display(uintptr_t address, uintptr_t offset, std::byte* mem) {
     }
 }
 
+void Struct::collect_reads(std::vector<std::pair<uintptr_t, size_t>>& ranges) {
+    if (m_display_self && is_collapsed() && !m_is_hovered) {
+        return;
+    }
+
+    for (auto&& [_, node] : m_nodes) {
+        node->collect_reads(ranges);
+    }
+}
+
 void Struct::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
     Base::update(address, offset, mem);
     m_display_str.clear();
@@ -208,11 +218,49 @@ void Struct::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
         return;
     }
 
+    prefetch(mem);
+
     for (auto&& [node_offset, node] : m_nodes) {
         node->update(address + node_offset, offset + node_offset, &mem[node_offset]);
     }
 }
 
+void Struct::prefetch(std::byte* mem) {
+    // Undefined pointer-sized slots that point into mapped memory get their vtable and string preview read during
+    // update. Pull everything they point at in with one batched read first so those end up as page cache hits.
+    constexpr size_t PREFETCH_SIZE = 256;
+
+    std::vector<std::byte> scratch{};
+    std::vector<Process::ReadRequest> requests{};
+
+    for (auto&& [node_offset, node] : m_nodes) {
+        if (node->size() != sizeof(uintptr_t) || dynamic_cast<Undefined*>(node.get()) == nullptr) {
+            continue;
+        }
+
+        auto ptr = *(uintptr_t*)&mem[node_offset];
+        auto region = m_process.get_region_within(ptr);
+
+        if (!region || !region->read) {
+            continue;
+        }
+
+        requests.emplace_back(ptr, nullptr, std::min<size_t>(PREFETCH_SIZE, region->end - ptr));
+    }
+
+    if (requests.size() < 2) {
+        return;
+    }
+
+    scratch.resize(requests.size() * PREFETCH_SIZE);
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].buffer = &scratch[i * PREFETCH_SIZE];
+    }
+
+    m_process.read_batch(requests);
+}
+
 void Struct::fill_space(uintptr_t last_offset, int delta) {
     auto add_undefined = [this](int offset, int size) {
         // Delete nodes that are will be overwritten by the undefined node we are going to add.
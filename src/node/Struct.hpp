@@ -11,6 +11,7 @@ public:
 
     void display(uintptr_t address, uintptr_t offset, std::byte* mem) override;
     void update(uintptr_t address, uintptr_t offset, std::byte* mem) override;
+    void collect_reads(std::vector<std::pair<uintptr_t, size_t>>& ranges) override;
 
     auto is_collapsed(bool is_collapsed) {
         m_props["__collapsed"].set(is_collapsed);
@@ -32,6 +33,7 @@ private:
     std::string m_display_str{};
 
     void fill_space(uintptr_t last_offset, int delta);
+    void prefetch(std::byte* mem);
 };
 
 } // namespace node
\ No newline at end of file
@@ -170,18 +170,17 @@ void Undefined::update(uintptr_t address, uintptr_t offset, std::byte* mem) {
             fmt::format_to(std::back_inserter(m_preview_str), "obj*:{:s} ", *tn);
         }
 
-        for (auto&& mod : m_process.modules()) {
-            if (mod.start <= addr && addr <= mod.end) {
+        if (auto region = m_process.get_region_within(addr)) {
+            if (region->module != RegionIndex::npos) {
+                auto&& mod = m_process.modules()[region->module];
                 fmt::format_to(std::back_inserter(m_preview_str), "<{}>+0x{:X} ", mod.name, addr - mod.start);
-                m_is_pointer = true;
             }
-        }
 
-        for (auto&& allocation : m_process.allocations()) {
-            if (allocation.start <= addr && addr <= allocation.end) {
+            if (region->allocation != RegionIndex::npos) {
                 fmt::format_to(std::back_inserter(m_preview_str), "heap:0x{:X} ", addr);
-                m_is_pointer = true;
             }
+
+            m_is_pointer = true;
         }
 
         if (m_is_pointer) {
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+#include "Catalog.hpp"
+
+namespace rtti {
+void ModuleCatalog::build_index() {
+    vtable_classes.clear();
+    decorated_classes.clear();
+
+    for (uint32_t i = 0; i < (uint32_t)classes.size(); ++i) {
+        auto&& c = classes[i];
+
+        decorated_classes.emplace(c.decorated, i);
+
+        for (auto&& vtable : c.vtables) {
+            vtable_classes.emplace(vtable.rva, i);
+        }
+    }
+}
+
+const ModuleCatalog::Class* ModuleCatalog::find_vtable(uint32_t rva) const {
+    auto search = vtable_classes.find(rva);
+    return search != vtable_classes.end() ? &classes[search->second] : nullptr;
+}
+
+const ModuleCatalog::Class* ModuleCatalog::find_class(const std::string& decorated) const {
+    auto search = decorated_classes.find(decorated);
+    return search != decorated_classes.end() ? &classes[search->second] : nullptr;
+}
+
+void Catalog::add(uintptr_t start, uintptr_t end, std::shared_ptr<const ModuleCatalog> catalog) {
+    std::unique_lock _{m_mtx};
+
+    std::erase_if(m_entries, [start, end](auto&& e) { return e.start < end && e.end > start; });
+
+    auto pos = std::upper_bound(
+        m_entries.begin(), m_entries.end(), start, [](uintptr_t addr, auto&& e) { return addr < e.start; });
+
+    m_entries.insert(pos, Entry{start, end, std::move(catalog)});
+    m_count = m_entries.size();
+}
+
+void Catalog::remove(uintptr_t start, uintptr_t end) {
+    if (empty()) {
+        return;
+    }
+
+    std::unique_lock _{m_mtx};
+
+    std::erase_if(m_entries, [start, end](auto&& e) { return e.start < end && e.end > start; });
+    m_count = m_entries.size();
+}
+
+void Catalog::clear() {
+    std::unique_lock _{m_mtx};
+    m_entries.clear();
+    m_count = 0;
+}
+
+const Catalog::Entry* Catalog::find_entry(uintptr_t address) const {
+    auto it = std::upper_bound(
+        m_entries.begin(), m_entries.end(), address, [](uintptr_t addr, auto&& e) { return addr < e.start; });
+
+    if (it == m_entries.begin()) {
+        return nullptr;
+    }
+
+    --it;
+    return address < it->end ? &*it : nullptr;
+}
+
+std::optional<std::optional<std::string>> Catalog::find_name(uintptr_t vtable) {
+    if (empty()) {
+        return std::nullopt;
+    }
+
+    std::shared_lock _{m_mtx};
+    auto entry = find_entry(vtable);
+
+    if (entry == nullptr) {
+        return std::nullopt;
+    }
+
+    if (auto c = entry->catalog->find_vtable((uint32_t)(vtable - entry->start))) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return c->name;
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return std::optional<std::string>{};
+}
+
+std::optional<Catalog::Entry> Catalog::find(uintptr_t address) const {
+    std::shared_lock _{m_mtx};
+
+    if (auto entry = find_entry(address)) {
+        return *entry;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<Catalog::Entry> Catalog::find(std::string_view module) const {
+    auto filename = module_filename(module);
+    std::shared_lock _{m_mtx};
+
+    for (auto&& e : m_entries) {
+        if (module_filename(e.catalog->module) == filename) {
+            return e;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<Catalog::Entry> Catalog::entries() const {
+    std::shared_lock _{m_mtx};
+    return m_entries;
+}
+
+Catalog::Stats Catalog::stats() const {
+    Stats stats{};
+
+    {
+        std::shared_lock _{m_mtx};
+
+        for (auto&& e : m_entries) {
+            ++stats.modules;
+            stats.classes += e.catalog->classes.size();
+            stats.vtables += e.catalog->vtable_count();
+        }
+    }
+
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Catalog::reset_stats() {
+    m_hits = 0;
+    m_misses = 0;
+}
+
+std::string module_filename(std::string_view path) {
+    if (auto slash = path.find_last_of("/\\"); slash != std::string_view::npos) {
+        path.remove_prefix(slash + 1);
+    }
+
+    std::string filename{path};
+
+    std::transform(filename.begin(), filename.end(), filename.begin(), [](unsigned char c) { return std::tolower(c); });
+    return filename;
+}
+} // namespace rtti
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace rtti {
+// Every polymorphic class of one module, found by scanning its image once. Everything is relative to the image base so
+// a catalog stays valid across ASLR and can be saved and reused for the same build of the module.
+struct ModuleCatalog {
+    struct Vtable {
+        uint32_t rva{};
+        // Where the subobject this vtable belongs to sits within the complete object.
+        uint32_t offset{};
+    };
+
+    struct Class {
+        // Undecorated ("class ns::Foo").
+        std::string name{};
+        // As stored in the type descriptor (".?AVFoo@ns@@"). Unique within a module.
+        std::string decorated{};
+        // Decorated names of the class and everything it derives from, in class hierarchy descriptor order (the class
+        // itself comes first).
+        std::vector<std::string> bases{};
+        // Class hierarchy descriptor attributes: 1 multiple inheritance, 2 virtual inheritance.
+        uint32_t attributes{};
+        std::vector<Vtable> vtables{};
+    };
+
+    std::string module{};
+    uint64_t hash{};
+    std::vector<Class> classes{};
+    // False if some of the module's data couldn't be read during the scan, classes whose RTTI sits there are missing.
+    // Such a catalog is only good for this session, it's never saved so the next one scans the module again.
+    bool complete{true};
+
+    // Derived from classes by build_index().
+    std::unordered_map<uint32_t, uint32_t> vtable_classes{};
+    std::unordered_map<std::string, uint32_t> decorated_classes{};
+
+    void build_index();
+
+    const Class* find_vtable(uint32_t rva) const;
+    const Class* find_class(const std::string& decorated) const;
+    size_t vtable_count() const { return vtable_classes.size(); }
+};
+
+// The catalogs of every module scanned so far, by where the module is loaded. A vtable inside a cataloged module is
+// answered from the catalog without touching the target, and anything else in that module is known not to be one.
+class Catalog {
+public:
+    struct Entry {
+        uintptr_t start{};
+        uintptr_t end{};
+        std::shared_ptr<const ModuleCatalog> catalog{};
+    };
+
+    struct Stats {
+        size_t modules{};
+        size_t classes{};
+        size_t vtables{};
+        size_t hits{};
+        // Looked up inside a cataloged module but not a vtable.
+        size_t misses{};
+    };
+
+    // Replaces whatever was cataloged for an overlapping range.
+    void add(uintptr_t start, uintptr_t end, std::shared_ptr<const ModuleCatalog> catalog);
+    // Drops every catalog overlapping [start, end).
+    void remove(uintptr_t start, uintptr_t end);
+    void clear();
+
+    // nullopt if no catalog covers vtable, otherwise the definitive answer (which is nullopt if it isn't a vtable).
+    std::optional<std::optional<std::string>> find_name(uintptr_t vtable);
+    // The catalog covering address.
+    std::optional<Entry> find(uintptr_t address) const;
+    // The first catalog of a module with this filename (case insensitive, directories are ignored).
+    std::optional<Entry> find(std::string_view module) const;
+    std::vector<Entry> entries() const;
+
+    bool empty() const { return m_count.load(std::memory_order_relaxed) == 0; }
+
+    Stats stats() const;
+    void reset_stats();
+
+private:
+    mutable std::shared_mutex m_mtx{};
+    // Sorted by start, non-overlapping.
+    std::vector<Entry> m_entries{};
+    // Lets lookups skip the lock while nothing is cataloged.
+    std::atomic<size_t> m_count{};
+
+    std::atomic<size_t> m_hits{};
+    std::atomic<size_t> m_misses{};
+
+    const Entry* find_entry(uintptr_t address) const;
+};
+
+// Lowercased filename of a module path. Module names are full paths on some backends and bare filenames on others.
+std::string module_filename(std::string_view path);
+} // namespace rtti
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <fstream>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include "Msvc.hpp"
+
+#include "CatalogJob.hpp"
+
+namespace rtti {
+namespace {
+// Bumped whenever what a scan finds changes, older catalogs are rescanned.
+constexpr int CATALOG_VERSION = 1;
+// Modules at least this big are scanned one at a time with every thread, everything else one module per thread.
+constexpr size_t LARGE_MODULE_SIZE = 16 * 1024 * 1024;
+
+std::filesystem::path catalog_path(const std::filesystem::path& directory, std::string_view module, uint64_t hash) {
+    return directory / fmt::format("{}-{:016x}.json", module_filename(module), hash);
+}
+} // namespace
+
+void to_json(nlohmann::json& j, const ModuleCatalog::Class& c) {
+    auto vtables = nlohmann::json::array();
+
+    for (auto&& v : c.vtables) {
+        vtables.push_back({v.rva, v.offset});
+    }
+
+    j["name"] = c.name;
+    j["decorated"] = c.decorated;
+    j["bases"] = c.bases;
+    j["attributes"] = c.attributes;
+    j["vtables"] = std::move(vtables);
+}
+
+void from_json(const nlohmann::json& j, ModuleCatalog::Class& c) {
+    c.name = j.value("name", std::string{});
+    c.decorated = j.value("decorated", std::string{});
+    c.bases = j.value("bases", std::vector<std::string>{});
+    c.attributes = j.value("attributes", uint32_t{});
+
+    for (auto&& v : j.value("vtables", nlohmann::json::array())) {
+        c.vtables.emplace_back(ModuleCatalog::Vtable{v.at(0).get<uint32_t>(), v.at(1).get<uint32_t>()});
+    }
+}
+
+std::optional<ModuleCatalog> load_catalog(
+    const std::filesystem::path& directory, std::string_view module, uint64_t hash) {
+    auto path = catalog_path(directory, module, hash);
+    std::ifstream f{path};
+
+    if (!f) {
+        return std::nullopt;
+    }
+
+    try {
+        nlohmann::json j{};
+
+        f >> j;
+
+        if (j.value("version", 0) != CATALOG_VERSION ||
+            j.value("hash", std::string{}) != fmt::format("{:016x}", hash)) {
+            return std::nullopt;
+        }
+
+        ModuleCatalog catalog{};
+
+        catalog.module = j.value("module", std::string{module});
+        catalog.hash = hash;
+        catalog.classes = j.value("classes", std::vector<ModuleCatalog::Class>{});
+        catalog.build_index();
+
+        return catalog;
+    } catch (const nlohmann::json::exception& e) {
+        spdlog::warn("Ignoring RTTI catalog {}: {}", path.string(), e.what());
+        return std::nullopt;
+    }
+}
+
+bool save_catalog(const std::filesystem::path& directory, const ModuleCatalog& catalog) {
+    // Whatever was missed would stay missed for as long as the module's build is around.
+    if (!catalog.complete) {
+        return false;
+    }
+
+    std::error_code ec{};
+
+    std::filesystem::create_directories(directory, ec);
+
+    auto path = catalog_path(directory, catalog.module, catalog.hash);
+    std::ofstream f{path};
+
+    if (!f) {
+        spdlog::warn("Couldn't save RTTI catalog {}", path.string());
+        return false;
+    }
+
+    nlohmann::json j{};
+
+    j["version"] = CATALOG_VERSION;
+    j["module"] = catalog.module;
+    j["hash"] = fmt::format("{:016x}", catalog.hash);
+    j["classes"] = catalog.classes;
+
+    // Not indented, these get big.
+    f << j;
+    return (bool)f;
+}
+
+CatalogJob::CatalogJob(Process& process, std::filesystem::path directory) {
+    std::vector<Process::Module> modules{};
+
+    for (auto&& m : process.modules()) {
+        if (!process.rtti_catalog().find(m.start)) {
+            modules.emplace_back(m);
+        }
+    }
+
+    std::sort(modules.begin(), modules.end(), [](auto&& a, auto&& b) { return a.size > b.size; });
+    m_progress->modules = modules.size();
+
+    m_thread = std::thread{[this, &process, modules = std::move(modules), directory = std::move(directory)] {
+        auto&& p = *m_progress;
+        auto threads = (size_t)std::max(std::thread::hardware_concurrency(), 1u);
+
+        auto catalog_module = [&](const Process::Module& m, size_t scan_threads) {
+            auto hash = msvc::module_hash(process, m);
+
+            // Not a PE image.
+            if (!hash) {
+                ++p.modules_done;
+                return;
+            }
+
+            auto catalog = !directory.empty() ? load_catalog(directory, m.name, *hash) : std::nullopt;
+
+            if (catalog) {
+                ++p.modules_loaded;
+            } else {
+                catalog = msvc::scan_module(process, m, scan_threads, &p.cancel_requested);
+
+                if (!catalog) {
+                    ++p.modules_done;
+                    return;
+                }
+
+                if (!catalog->complete) {
+                    spdlog::warn("RTTI catalog of {} is incomplete, parts of it couldn't be read", m.name);
+                    ++p.partial;
+                } else if (!directory.empty()) {
+                    save_catalog(directory, *catalog);
+                }
+            }
+
+            ++p.catalogs;
+            p.classes += catalog->classes.size();
+            process.rtti_catalog().add(m.start, m.end, std::make_shared<const ModuleCatalog>(std::move(*catalog)));
+            ++p.modules_done;
+        };
+
+        // The big ones (usually the executable itself) get every thread, one section chunk each.
+        auto small = std::find_if(modules.begin(), modules.end(), [](auto&& m) { return m.size < LARGE_MODULE_SIZE; });
+
+        for (auto it = modules.begin(); it != small && !p.cancelled(); ++it) {
+            catalog_module(*it, threads);
+        }
+
+        std::atomic<size_t> next{(size_t)(small - modules.begin())};
+
+        auto worker = [&] {
+            for (size_t i = next++; i < modules.size() && !p.cancelled(); i = next++) {
+                catalog_module(modules[i], 1);
+            }
+        };
+
+        std::vector<std::thread> workers{};
+
+        for (size_t i = 1; i < std::min(threads, (size_t)(modules.end() - small)); ++i) {
+            workers.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto&& t : workers) {
+            t.join();
+        }
+
+        auto elapsed = std::chrono::duration<float>{std::chrono::steady_clock::now() - p.start_time};
+
+        if (!p.cancelled()) {
+            spdlog::info("RTTI catalog: {} classes in {} modules ({} loaded from disk) in {:.1f}s", p.classes.load(),
+                p.catalogs.load(), p.modules_loaded.load(), elapsed.count());
+        }
+
+        p.finished = true;
+    }};
+}
+
+CatalogJob::~CatalogJob() {
+    cancel();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+} // namespace rtti
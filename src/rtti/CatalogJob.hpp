@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Catalog.hpp"
+#include "Process.hpp"
+
+namespace rtti {
+struct CatalogProgress {
+    std::atomic<size_t> modules{};
+    std::atomic<size_t> modules_done{};
+    // How many of modules_done came from a saved catalog instead of a scan.
+    std::atomic<size_t> modules_loaded{};
+    // Modules that turned out to be PE images and got a catalog.
+    std::atomic<size_t> catalogs{};
+    // How many of catalogs are missing parts of their module (see ModuleCatalog::complete).
+    std::atomic<size_t> partial{};
+    std::atomic<size_t> classes{};
+    std::atomic<bool> cancel_requested{};
+    std::atomic<bool> finished{};
+    std::chrono::steady_clock::time_point start_time{std::chrono::steady_clock::now()};
+
+    void cancel() { cancel_requested = true; }
+    bool cancelled() const { return cancel_requested.load(std::memory_order_relaxed); }
+};
+
+// Saved catalogs are directory/<module filename>-<module hash>.json. Incomplete catalogs aren't saved.
+std::optional<ModuleCatalog> load_catalog(
+    const std::filesystem::path& directory, std::string_view module, uint64_t hash);
+bool save_catalog(const std::filesystem::path& directory, const ModuleCatalog& catalog);
+
+// Catalogs every module the process's rtti_catalog() doesn't cover yet on a background thread, publishing each one as
+// soon as it's done. Saved catalogs in directory (if not empty) are used instead of scanning, and new ones are saved
+// there. Construct it on the thread that owns the process's map. The job's threads only ever read through
+// Process::read_direct, never the page caches or the published map, so the map can be replaced while it runs. The
+// process must outlive the job; destroying the job cancels it.
+class CatalogJob {
+public:
+    CatalogJob(Process& process, std::filesystem::path directory);
+    ~CatalogJob();
+
+    CatalogJob(const CatalogJob&) = delete;
+    CatalogJob& operator=(const CatalogJob&) = delete;
+
+    auto&& progress() const { return m_progress; }
+    bool finished() const { return m_progress->finished; }
+    void cancel() { m_progress->cancel(); }
+
+private:
+    std::shared_ptr<CatalogProgress> m_progress{std::make_shared<CatalogProgress>()};
+    std::thread m_thread{};
+};
+} // namespace rtti
@@ -0,0 +1,75 @@
+#include <mutex>
+
+#include "Hierarchy.hpp"
+
+namespace rtti {
+ClassId Hierarchy::intern(std::string_view name) {
+    {
+        std::shared_lock _{m_mtx};
+
+        if (auto search = m_ids.find(name); search != m_ids.end()) {
+            return search->second;
+        }
+    }
+
+    std::unique_lock _{m_mtx};
+    return intern_locked(name);
+}
+
+ClassId Hierarchy::intern_locked(std::string_view name) {
+    if (auto search = m_ids.find(name); search != m_ids.end()) {
+        return search->second;
+    }
+
+    auto id = (ClassId)m_ids.size();
+
+    m_ids.emplace(std::string{name}, id);
+    return id;
+}
+
+std::shared_ptr<const ClassSet> Hierarchy::find(uintptr_t vtable) const {
+    std::shared_lock _{m_mtx};
+
+    if (auto search = m_sets.find(vtable); search != m_sets.end()) {
+        return search->second;
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<const ClassSet> Hierarchy::insert(uintptr_t vtable, const std::vector<std::string>& names) {
+    auto set = std::make_shared<ClassSet>();
+    std::unique_lock _{m_mtx};
+
+    for (auto&& name : names) {
+        set->insert(intern_locked(name));
+    }
+
+    if (m_sets.size() >= MAX_VTABLES) {
+        m_sets.clear();
+    }
+
+    m_sets[vtable] = set;
+    return set;
+}
+
+void Hierarchy::invalidate(uintptr_t start, uintptr_t end) {
+    std::unique_lock _{m_mtx};
+    std::erase_if(m_sets, [start, end](auto&& kv) { return kv.first >= start && kv.first < end; });
+}
+
+void Hierarchy::clear() {
+    std::unique_lock _{m_mtx};
+    m_sets.clear();
+}
+
+size_t Hierarchy::class_count() const {
+    std::shared_lock _{m_mtx};
+    return m_ids.size();
+}
+
+size_t Hierarchy::vtable_count() const {
+    std::shared_lock _{m_mtx};
+    return m_sets.size();
+}
+} // namespace rtti
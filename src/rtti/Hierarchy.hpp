@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace rtti {
+// Dense, process-lifetime ids for class names, small ones for the classes seen first.
+using ClassId = uint32_t;
+
+// The classes a vtable's class is or derives from, one bit per ClassId.
+class ClassSet {
+public:
+    bool contains(ClassId id) const {
+        auto word = id / 64;
+        return word < m_words.size() && ((m_words[word] >> (id % 64)) & 1) != 0;
+    }
+
+    void insert(ClassId id) {
+        if (id / 64 >= m_words.size()) {
+            m_words.resize(id / 64 + 1);
+        }
+
+        m_words[id / 64] |= (uint64_t)1 << (id % 64);
+    }
+
+    bool empty() const { return m_words.empty(); }
+
+private:
+    std::vector<uint64_t> m_words{};
+};
+
+// Interned class names plus a ClassSet per vtable, so once a vtable has been seen asking whether an object derives from
+// a class costs reading its vtable pointer and a bit test.
+class Hierarchy {
+public:
+    ClassId intern(std::string_view name);
+    // nullptr if vtable hasn't been inserted (or got invalidated since).
+    std::shared_ptr<const ClassSet> find(uintptr_t vtable) const;
+    // Keeps the set of names (the class and its bases) for vtable.
+    std::shared_ptr<const ClassSet> insert(uintptr_t vtable, const std::vector<std::string>& names);
+
+    // Drops the sets of vtables in [start, end) (a module that went away). Ids are kept, names don't change meaning.
+    void invalidate(uintptr_t start, uintptr_t end);
+    // Drops every set, ids stay valid.
+    void clear();
+
+    size_t class_count() const;
+    size_t vtable_count() const;
+
+private:
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    // Past this many vtables the sets start over.
+    static constexpr size_t MAX_VTABLES = 1 << 16;
+
+    mutable std::shared_mutex m_mtx{};
+    std::unordered_map<std::string, ClassId, NameHash, std::equal_to<>> m_ids{};
+    std::unordered_map<uintptr_t, std::shared_ptr<const ClassSet>> m_sets{};
+
+    ClassId intern_locked(std::string_view name);
+};
+} // namespace rtti
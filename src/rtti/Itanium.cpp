@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define REGENNY_HAS_CXXABI 1
+#endif
+
+#include "Process.hpp"
+#include "Read.hpp"
+
+#include "Itanium.hpp"
+
+namespace rtti::itanium {
+namespace {
+constexpr size_t POINTER_SIZE = sizeof(uintptr_t);
+// Anything past these is a cycle or garbage.
+constexpr size_t MAX_CLASSES = 256;
+constexpr uint32_t MAX_BASE_COUNT = 256;
+// A secondary vtable's offset-to-top is minus the subobject's offset, nothing is this big.
+constexpr intptr_t MAX_OFFSET_TO_TOP = 1 << 24;
+// Past this many distinct type_info vtables the kind cache starts over. Real processes have a few dozen.
+constexpr size_t MAX_KINDS = 4096;
+
+// Name pointers can have the top bit set (non-unique RTTI on arm64 Apple platforms).
+uintptr_t name_address(uintptr_t name) {
+    if constexpr (sizeof(uintptr_t) == 8) {
+        return name & ~((uintptr_t)1 << 63);
+    } else {
+        return name;
+    }
+}
+
+// Class type names are a source name ("3Foo"), a nested name ("N2ns3FooE"), std:: ("St9exception") or local ("Z...").
+bool plausible_name(std::string_view name) {
+    if (name.empty() || !(std::isdigit((unsigned char)name[0]) || name[0] == 'N' || name[0] == 'S' || name[0] == 'Z')) {
+        return false;
+    }
+
+    return std::all_of(name.begin(), name.end(), [](unsigned char c) { return c > ' ' && c < 0x7f; });
+}
+
+std::optional<std::string_view> source_name(std::string_view& mangled) {
+    size_t length{};
+    size_t digits{};
+
+    while (digits < mangled.size() && std::isdigit((unsigned char)mangled[digits])) {
+        length = length * 10 + (mangled[digits++] - '0');
+    }
+
+    if (digits == 0 || length == 0 || digits + length > mangled.size()) {
+        return std::nullopt;
+    }
+
+    auto name = mangled.substr(digits, length);
+
+    mangled.remove_prefix(digits + length);
+    return name;
+}
+
+// Plain (nested) names only, for hosts without a runtime demangler. Templates and substitutions stay mangled.
+std::optional<std::string> demangle_simple(std::string_view mangled) {
+    std::string out{};
+    auto nested = mangled.starts_with('N');
+
+    if (nested) {
+        mangled.remove_prefix(1);
+    }
+
+    if (mangled.starts_with("St")) {
+        out = "std";
+        mangled.remove_prefix(2);
+    }
+
+    while (!mangled.empty() && std::isdigit((unsigned char)mangled.front())) {
+        auto name = source_name(mangled);
+
+        if (!name) {
+            return std::nullopt;
+        }
+
+        if (!out.empty()) {
+            out += "::";
+        }
+
+        out += *name;
+
+        if (!nested) {
+            break;
+        }
+    }
+
+    if (nested) {
+        if (mangled != "E") {
+            return std::nullopt;
+        }
+    } else if (!mangled.empty()) {
+        return std::nullopt;
+    }
+
+    return out.empty() ? std::nullopt : std::optional{out};
+}
+} // namespace
+
+std::string demangle(std::string_view mangled) {
+#ifdef REGENNY_HAS_CXXABI
+    std::string name{mangled};
+    auto status = 0;
+
+    if (auto demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status)) {
+        name = demangled;
+        free(demangled);
+        return name;
+    }
+#endif
+
+    return demangle_simple(mangled).value_or(std::string{mangled});
+}
+
+Provider::Kind Provider::kind_of(Process& process, uintptr_t type_info_vtable) {
+    {
+        std::shared_lock _{m_mtx};
+
+        if (auto search = m_kinds.find(type_info_vtable); search != m_kinds.end()) {
+            return search->second;
+        }
+    }
+
+    // A type_info is an object like any other: its vtable[-1] is the type_info of its own class.
+    auto kind = Kind::NONE;
+    auto meta = process.read<uintptr_t>(type_info_vtable - POINTER_SIZE);
+    auto meta_name = meta && *meta != 0 ? process.read<uintptr_t>(*meta + POINTER_SIZE) : std::nullopt;
+    auto name = meta_name ? read_name(process, name_address(*meta_name)) : std::nullopt;
+
+    if (name == "N10__cxxabiv117__class_type_infoE") {
+        kind = Kind::CLASS;
+    } else if (name == "N10__cxxabiv120__si_class_type_infoE") {
+        kind = Kind::SI_CLASS;
+    } else if (name == "N10__cxxabiv121__vmi_class_type_infoE") {
+        kind = Kind::VMI_CLASS;
+    }
+
+    std::unique_lock _{m_mtx};
+
+    if (m_kinds.size() >= MAX_KINDS) {
+        m_kinds.clear();
+    }
+
+    m_kinds[type_info_vtable] = kind;
+    return kind;
+}
+
+std::optional<Provider::TypeInfo> Provider::read_type_info(Process& process, uintptr_t type_info) {
+    uintptr_t header[2]{};
+
+    if (type_info == 0 || !process.read(type_info, header, sizeof(header)) || header[0] == 0) {
+        return std::nullopt;
+    }
+
+    auto kind = kind_of(process, header[0]);
+    auto name = kind != Kind::NONE ? read_name(process, name_address(header[1])) : std::nullopt;
+
+    if (!name || !plausible_name(*name)) {
+        return std::nullopt;
+    }
+
+    return TypeInfo{kind, std::move(*name)};
+}
+
+std::optional<uintptr_t> Provider::type_info_of(Process& process, uintptr_t vtable) {
+    // offset-to-top, then the type_info pointer, right before the first virtual function.
+    intptr_t prefix[2]{};
+
+    if (vtable < sizeof(prefix) || !process.read(vtable - sizeof(prefix), prefix, sizeof(prefix)) ||
+        prefix[0] > 0 || prefix[0] < -MAX_OFFSET_TO_TOP || prefix[1] == 0) {
+        return std::nullopt;
+    }
+
+    return (uintptr_t)prefix[1];
+}
+
+std::optional<std::string> Provider::type_name(Process& process, uintptr_t vtable) {
+    auto type_info = type_info_of(process, vtable);
+    auto info = type_info ? read_type_info(process, *type_info) : std::nullopt;
+
+    if (!info) {
+        return std::nullopt;
+    }
+
+    return demangle(info->name);
+}
+
+std::shared_ptr<const std::vector<std::string>> Provider::bases(Process& process, uintptr_t vtable) {
+    {
+        std::shared_lock _{m_mtx};
+
+        if (auto search = m_bases.find(vtable); search != m_bases.end()) {
+            return search->second;
+        }
+    }
+
+    auto names = std::make_shared<std::vector<std::string>>();
+    std::deque<uintptr_t> queue{};
+    std::unordered_set<uintptr_t> seen{};
+
+    if (auto type_info = type_info_of(process, vtable)) {
+        queue.emplace_back(*type_info);
+    }
+
+    while (!queue.empty() && seen.size() < MAX_CLASSES) {
+        auto type_info = queue.front();
+
+        queue.pop_front();
+
+        if (!seen.emplace(type_info).second) {
+            continue;
+        }
+
+        auto info = read_type_info(process, type_info);
+
+        if (!info) {
+            continue;
+        }
+
+        names->emplace_back(demangle(info->name));
+
+        if (info->kind == Kind::SI_CLASS) {
+            if (auto base = process.read<uintptr_t>(type_info + 2 * POINTER_SIZE)) {
+                queue.emplace_back(*base);
+            }
+        } else if (info->kind == Kind::VMI_CLASS) {
+            // __flags and __base_count, then __base_count of {base type_info, offset and flags (a long)}.
+            uint32_t counts[2]{};
+
+            if (!process.read(type_info + 2 * POINTER_SIZE, counts, sizeof(counts)) || counts[1] > MAX_BASE_COUNT) {
+                continue;
+            }
+
+            std::vector<uintptr_t> base_info(counts[1] * 2);
+
+            if (!base_info.empty() && process.read(type_info + 2 * POINTER_SIZE + sizeof(counts), base_info.data(),
+                                          base_info.size() * sizeof(uintptr_t))) {
+                for (size_t i = 0; i < base_info.size(); i += 2) {
+                    queue.emplace_back(base_info[i]);
+                }
+            }
+        }
+    }
+
+    std::unique_lock _{m_mtx};
+
+    if (m_bases.size() >= MAX_BASES) {
+        m_bases.clear();
+    }
+
+    m_bases[vtable] = names;
+    return names;
+}
+
+void Provider::invalidate(uintptr_t start, uintptr_t end) {
+    std::unique_lock _{m_mtx};
+
+    std::erase_if(m_kinds, [start, end](auto&& kv) { return kv.first >= start && kv.first < end; });
+    std::erase_if(m_bases, [start, end](auto&& kv) { return kv.first >= start && kv.first < end; });
+}
+
+void Provider::clear() {
+    std::unique_lock _{m_mtx};
+    m_kinds.clear();
+    m_bases.clear();
+}
+} // namespace rtti::itanium
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Process;
+
+// Itanium C++ ABI RTTI (GCC, and Clang outside of MSVC mode): vtable[-1] points at the class's type_info, which is a
+// __cxxabiv1::__class_type_info, __si_class_type_info (single, public, non-virtual base) or __vmi_class_type_info
+// (anything else). Everything is read through Process::read so it works on any backend.
+namespace rtti::itanium {
+class Provider {
+public:
+    // Demangled name of the class vtable belongs to (the complete object's class for secondary vtables too). nullopt
+    // if vtable[-1] doesn't lead to a class type_info.
+    std::optional<std::string> type_name(Process& process, uintptr_t vtable);
+    // Demangled names of the class and every class it derives from, breadth first with the class itself first. Empty if
+    // vtable isn't one. Kept per vtable until invalidate() covers it.
+    std::shared_ptr<const std::vector<std::string>> bases(Process& process, uintptr_t vtable);
+
+    // Drops everything read from [start, end) (a module that went away).
+    void invalidate(uintptr_t start, uintptr_t end);
+    void clear();
+
+private:
+    enum class Kind : uint8_t { NONE, CLASS, SI_CLASS, VMI_CLASS };
+
+    struct TypeInfo {
+        Kind kind{};
+        std::string name{};
+    };
+
+    // Past this many vtables the bases cache starts over.
+    static constexpr size_t MAX_BASES = 1 << 16;
+
+    mutable std::shared_mutex m_mtx{};
+    // type_info vtable -> which __cxxabiv1 class it belongs to. There's only a handful of these per process.
+    std::unordered_map<uintptr_t, Kind> m_kinds{};
+    std::unordered_map<uintptr_t, std::shared_ptr<const std::vector<std::string>>> m_bases{};
+
+    Kind kind_of(Process& process, uintptr_t type_info_vtable);
+    std::optional<TypeInfo> read_type_info(Process& process, uintptr_t type_info);
+    std::optional<uintptr_t> type_info_of(Process& process, uintptr_t vtable);
+};
+
+// "N4game7DerivedE" -> "game::Derived". Type names in type_info have no _Z prefix.
+std::string demangle(std::string_view mangled);
+} // namespace rtti::itanium
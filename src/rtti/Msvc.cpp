@@ -0,0 +1,520 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Msvc.hpp"
+
+namespace rtti::msvc {
+namespace {
+// Layouts from winnt.h, only the fields we use.
+constexpr uint16_t IMAGE_DOS_SIGNATURE = 0x5a4d;    // "MZ"
+constexpr uint32_t IMAGE_NT_SIGNATURE = 0x00004550; // "PE\0\0"
+constexpr uint16_t IMAGE_NT_OPTIONAL_HDR32_MAGIC = 0x10b;
+constexpr uint16_t IMAGE_NT_OPTIONAL_HDR64_MAGIC = 0x20b;
+constexpr uint32_t IMAGE_SCN_MEM_EXECUTE = 0x20000000;
+constexpr uint32_t IMAGE_SCN_MEM_READ = 0x40000000;
+constexpr uint32_t IMAGE_SCN_MEM_WRITE = 0x80000000;
+// Same offsets in IMAGE_OPTIONAL_HEADER32 and IMAGE_OPTIONAL_HEADER64.
+constexpr size_t OPTIONAL_HEADER_SIZE_OF_IMAGE = 56;
+constexpr size_t OPTIONAL_HEADER_CHECKSUM = 64;
+
+struct IMAGE_FILE_HEADER {
+    uint16_t Machine;
+    uint16_t NumberOfSections;
+    uint32_t TimeDateStamp;
+    uint32_t PointerToSymbolTable;
+    uint32_t NumberOfSymbols;
+    uint16_t SizeOfOptionalHeader;
+    uint16_t Characteristics;
+};
+
+struct IMAGE_SECTION_HEADER {
+    char Name[8];
+    uint32_t VirtualSize;
+    uint32_t VirtualAddress;
+    uint32_t SizeOfRawData;
+    uint32_t PointerToRawData;
+    uint32_t PointerToRelocations;
+    uint32_t PointerToLinenumbers;
+    uint16_t NumberOfRelocations;
+    uint16_t NumberOfLinenumbers;
+    uint32_t Characteristics;
+};
+
+static_assert(sizeof(IMAGE_FILE_HEADER) == 20);
+static_assert(sizeof(IMAGE_SECTION_HEADER) == 40);
+
+constexpr size_t PAGE_SIZE = 0x1000;
+// Sections are read and scanned in pieces this big, which is also how often a scan checks for cancellation.
+constexpr size_t CHUNK_SIZE = 1024 * 1024;
+// Anything past this is garbage that happened to pass the other checks.
+constexpr size_t MAX_NAME_LENGTH = 4096;
+
+struct Section {
+    uint32_t rva{};
+    uint32_t size{};
+    uint32_t characteristics{};
+
+    bool data() const {
+        return (characteristics & IMAGE_SCN_MEM_READ) != 0 && (characteristics & IMAGE_SCN_MEM_EXECUTE) == 0;
+    }
+    bool read_only_data() const { return data() && (characteristics & IMAGE_SCN_MEM_WRITE) == 0; }
+    bool code() const { return (characteristics & IMAGE_SCN_MEM_EXECUTE) != 0; }
+};
+
+struct Headers {
+    bool is64{};
+    uint32_t time_date_stamp{};
+    uint32_t size_of_image{};
+    uint32_t checksum{};
+    std::vector<Section> sections{};
+};
+
+std::optional<Headers> read_headers(Process& process, uintptr_t base) {
+    uint16_t dos_signature{};
+    uint32_t e_lfanew{};
+    uint32_t nt_signature{};
+    IMAGE_FILE_HEADER file_header{};
+    uint16_t magic{};
+    // Never through the page caches: scans run on worker threads, and those would look at the published memory map
+    // while the main thread replaces it.
+    auto read = [&process](uintptr_t address, void* buffer, size_t size) {
+        return process.read_direct(address, buffer, size);
+    };
+
+    if (!read(base, &dos_signature, sizeof(dos_signature)) || dos_signature != IMAGE_DOS_SIGNATURE ||
+        !read(base + 0x3c, &e_lfanew, sizeof(e_lfanew)) || e_lfanew > PAGE_SIZE ||
+        !read(base + e_lfanew, &nt_signature, sizeof(nt_signature)) || nt_signature != IMAGE_NT_SIGNATURE ||
+        !read(base + e_lfanew + sizeof(nt_signature), &file_header, sizeof(file_header))) {
+        return std::nullopt;
+    }
+
+    auto optional_header = base + e_lfanew + sizeof(nt_signature) + sizeof(file_header);
+    Headers headers{};
+
+    if (!read(optional_header, &magic, sizeof(magic)) ||
+        (magic != IMAGE_NT_OPTIONAL_HDR32_MAGIC && magic != IMAGE_NT_OPTIONAL_HDR64_MAGIC) ||
+        !read(optional_header + OPTIONAL_HEADER_SIZE_OF_IMAGE, &headers.size_of_image, sizeof(uint32_t)) ||
+        !read(optional_header + OPTIONAL_HEADER_CHECKSUM, &headers.checksum, sizeof(uint32_t))) {
+        return std::nullopt;
+    }
+
+    headers.is64 = magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+    headers.time_date_stamp = file_header.TimeDateStamp;
+
+    std::vector<IMAGE_SECTION_HEADER> sections(file_header.NumberOfSections);
+
+    if (!sections.empty() && !read(optional_header + file_header.SizeOfOptionalHeader, sections.data(),
+                                 sections.size() * sizeof(IMAGE_SECTION_HEADER))) {
+        return std::nullopt;
+    }
+
+    for (auto&& s : sections) {
+        auto size = s.VirtualSize != 0 ? s.VirtualSize : s.SizeOfRawData;
+
+        if (size == 0 || s.VirtualAddress >= headers.size_of_image) {
+            continue;
+        }
+
+        size = std::min(size, headers.size_of_image - s.VirtualAddress);
+        headers.sections.emplace_back(Section{s.VirtualAddress, size, s.Characteristics});
+    }
+
+    return headers;
+}
+
+bool cancelled(const std::atomic<bool>* cancel) {
+    return cancel != nullptr && cancel->load(std::memory_order_relaxed);
+}
+
+// Runs fn(0..count) on up to threads threads, the calling one included.
+template <typename Fn> void parallel_for(size_t count, size_t threads, const std::atomic<bool>* cancel, Fn&& fn) {
+    std::atomic<size_t> next{};
+
+    auto worker = [&] {
+        for (size_t i = next++; i < count && !cancelled(cancel); i = next++) {
+            fn(i);
+        }
+    };
+
+    std::vector<std::thread> workers{};
+
+    for (size_t i = 1; i < std::min(threads, count); ++i) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto&& t : workers) {
+        t.join();
+    }
+}
+
+struct Chunk {
+    uint32_t rva{};
+    uint32_t size{};
+};
+
+std::vector<Chunk> chunks_of(const std::vector<Section>& sections, bool (Section::*filter)() const) {
+    std::vector<Chunk> chunks{};
+
+    for (auto&& s : sections) {
+        if (!(s.*filter)()) {
+            continue;
+        }
+
+        for (uint32_t offset = 0; offset < s.size; offset += CHUNK_SIZE) {
+            chunks.emplace_back(Chunk{s.rva + offset, (uint32_t)std::min<size_t>(CHUNK_SIZE, s.size - offset)});
+        }
+    }
+
+    return chunks;
+}
+
+// The module's data sections, copied out of the target once. Code is never read, we only need to know where it is.
+class Image {
+public:
+    Image(Process& process, uintptr_t base, Headers headers, size_t threads, const std::atomic<bool>* cancel)
+        : m_base{base}, m_headers{std::move(headers)},
+          m_bytes{std::make_unique_for_overwrite<std::byte[]>(m_headers.size_of_image)},
+          m_present((m_headers.size_of_image + PAGE_SIZE - 1) / PAGE_SIZE) {
+        auto chunks = chunks_of(m_headers.sections, &Section::data);
+
+        parallel_for(chunks.size(), threads, cancel, [&](size_t i) {
+            auto&& c = chunks[i];
+
+            if (process.read_direct(m_base + c.rva, &m_bytes[c.rva], c.size)) {
+                mark_present(c.rva, c.size);
+                return;
+            }
+
+            // Parts of a section can be decommitted or guarded, keep whatever pages we can get.
+            for (auto page = c.rva & ~(PAGE_SIZE - 1); page < c.rva + c.size; page += PAGE_SIZE) {
+                auto start = std::max<uint32_t>(page, c.rva);
+                auto end = std::min<uint32_t>(page + PAGE_SIZE, c.rva + c.size);
+
+                if (process.read_direct(m_base + start, &m_bytes[start], end - start)) {
+                    mark_present(start, end - start);
+                }
+            }
+        });
+    }
+
+    auto&& headers() const { return m_headers; }
+    uintptr_t base() const { return m_base; }
+    size_t pointer_size() const { return m_headers.is64 ? 8 : 4; }
+
+    // Whether every page of the data sections was read.
+    bool complete() const {
+        return std::all_of(m_headers.sections.begin(), m_headers.sections.end(),
+            [this](auto&& s) { return !s.data() || present(s.rva, s.size); });
+    }
+
+    bool present(uint32_t rva, size_t size) const {
+        if (size == 0 || (uint64_t)rva + size > m_headers.size_of_image) {
+            return false;
+        }
+
+        for (auto page = rva / PAGE_SIZE; page <= (rva + size - 1) / PAGE_SIZE; ++page) {
+            if (m_present[page] == 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename T> bool get(uint32_t rva, T& out) const {
+        if (!present(rva, sizeof(T))) {
+            return false;
+        }
+
+        memcpy(&out, &m_bytes[rva], sizeof(T));
+        return true;
+    }
+
+    // Pointer sized value at rva.
+    std::optional<uint64_t> pointer(uint32_t rva) const {
+        if (m_headers.is64) {
+            uint64_t value{};
+            return get(rva, value) ? std::optional{value} : std::nullopt;
+        }
+
+        uint32_t value{};
+        return get(rva, value) ? std::optional<uint64_t>{value} : std::nullopt;
+    }
+
+    // Null terminated string at rva, nullopt if it runs off the present bytes.
+    std::optional<std::string_view> string(uint32_t rva) const {
+        if (!present(rva, 1)) {
+            return std::nullopt;
+        }
+
+        auto begin = (const char*)&m_bytes[rva];
+        auto max = std::min<size_t>(MAX_NAME_LENGTH, m_headers.size_of_image - rva);
+
+        for (size_t n = 0; n < max; ++n) {
+            if ((n + rva) % PAGE_SIZE == 0 && !present(rva + (uint32_t)n, 1)) {
+                return std::nullopt;
+            }
+
+            if (begin[n] == '\0') {
+                return std::string_view{begin, n};
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // rva of an address stored in the image: absolute on x86, already image relative on x64.
+    std::optional<uint32_t> rva_of(uint64_t stored) const {
+        if (m_headers.is64) {
+            return stored < m_headers.size_of_image ? std::optional{(uint32_t)stored} : std::nullopt;
+        }
+
+        if (stored < m_base || stored - m_base >= m_headers.size_of_image) {
+            return std::nullopt;
+        }
+
+        return (uint32_t)(stored - m_base);
+    }
+
+    bool in_code(uint64_t address) const {
+        if (address < m_base || address - m_base >= m_headers.size_of_image) {
+            return false;
+        }
+
+        auto rva = (uint32_t)(address - m_base);
+
+        return std::any_of(m_headers.sections.begin(), m_headers.sections.end(),
+            [rva](auto&& s) { return s.code() && rva >= s.rva && rva - s.rva < s.size; });
+    }
+
+    // The decorated name in a type descriptor (type_info), which is two pointers in.
+    std::optional<std::string_view> type_name(uint32_t type_descriptor) const {
+        auto name = string(type_descriptor + (uint32_t)type_name_offset(pointer_size()));
+
+        if (!name || !name->starts_with(".?A")) {
+            return std::nullopt;
+        }
+
+        return name;
+    }
+
+private:
+    uintptr_t m_base{};
+    Headers m_headers{};
+    std::unique_ptr<std::byte[]> m_bytes{};
+    // One per page, set once that page has been read. Bytes instead of vector<bool> so threads can set neighbours.
+    std::vector<uint8_t> m_present{};
+
+    void mark_present(uint32_t rva, size_t size) {
+        for (auto page = rva / PAGE_SIZE; page <= (rva + size - 1) / PAGE_SIZE; ++page) {
+            m_present[page] = 1;
+        }
+    }
+};
+
+struct Locator {
+    uint32_t rva{};
+    uint32_t offset{};
+    uint32_t type_descriptor{};
+    uint32_t class_descriptor{};
+};
+
+// Whether rva holds a complete object locator whose type and class hierarchy descriptors are where they should be.
+std::optional<Locator> read_locator(const Image& image, uint32_t rva) {
+    CompleteObjectLocator col{};
+
+    if (!image.get(rva, col)) {
+        return std::nullopt;
+    }
+
+    if (image.headers().is64 ? col.signature != COL_SIG_REV1 || col.self != rva : col.signature != COL_SIG_REV0) {
+        return std::nullopt;
+    }
+
+    auto type_descriptor = image.rva_of(col.type_descriptor);
+    auto class_descriptor = image.rva_of(col.class_descriptor);
+    ClassHierarchyDescriptor chd{};
+
+    if (!type_descriptor || !class_descriptor || !image.get(*class_descriptor, chd) || chd.signature != 0 ||
+        chd.num_base_classes == 0 || chd.num_base_classes > MAX_BASE_CLASSES ||
+        !image.rva_of(chd.base_class_array) || !image.type_name(*type_descriptor)) {
+        return std::nullopt;
+    }
+
+    return Locator{rva, col.offset, *type_descriptor, *class_descriptor};
+}
+
+// Decorated names of the class described by class_descriptor and all of its bases, in base class array order.
+std::vector<std::string> read_bases(const Image& image, uint32_t class_descriptor) {
+    ClassHierarchyDescriptor chd{};
+    std::vector<std::string> bases{};
+
+    if (!image.get(class_descriptor, chd)) {
+        return bases;
+    }
+
+    auto array = image.rva_of(chd.base_class_array);
+
+    for (uint32_t i = 0; array && i < chd.num_base_classes; ++i) {
+        uint32_t entry{};
+        BaseClassDescriptor bcd{};
+
+        if (!image.get(*array + i * (uint32_t)sizeof(uint32_t), entry)) {
+            break;
+        }
+
+        auto descriptor = image.rva_of(entry);
+        auto type_descriptor = descriptor && image.get(*descriptor, bcd) ? image.rva_of(bcd.type_descriptor)
+                                                                          : std::nullopt;
+        auto name = type_descriptor ? image.type_name(*type_descriptor) : std::nullopt;
+
+        if (!name) {
+            break;
+        }
+
+        bases.emplace_back(*name);
+    }
+
+    return bases;
+}
+
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= ((const uint8_t*)data)[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+} // namespace
+
+std::optional<uint64_t> module_hash(Process& process, const Process::Module& module) {
+    auto headers = read_headers(process, module.start);
+
+    if (!headers) {
+        return std::nullopt;
+    }
+
+    auto filename = module_filename(module.name);
+    auto hash = 0xcbf29ce484222325ull;
+
+    hash = fnv1a(hash, &headers->time_date_stamp, sizeof(headers->time_date_stamp));
+    hash = fnv1a(hash, &headers->size_of_image, sizeof(headers->size_of_image));
+    hash = fnv1a(hash, &headers->checksum, sizeof(headers->checksum));
+    hash = fnv1a(hash, filename.data(), filename.size());
+
+    return hash;
+}
+
+std::optional<ModuleCatalog> scan_module(
+    Process& process, const Process::Module& module, size_t threads, const std::atomic<bool>* cancel) {
+    auto headers = read_headers(process, module.start);
+    auto hash = module_hash(process, module);
+
+    if (!headers || !hash) {
+        return std::nullopt;
+    }
+
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    Image image{process, module.start, std::move(*headers), threads, cancel};
+    auto chunks = chunks_of(image.headers().sections, &Section::read_only_data);
+
+    // Locators, vtables and the descriptors they point at all live in read only data (type descriptors don't, they're
+    // writable because of the undecorated name the runtime caches in them).
+    std::vector<std::vector<Locator>> chunk_locators(chunks.size());
+
+    parallel_for(chunks.size(), threads, cancel, [&](size_t i) {
+        auto&& c = chunks[i];
+
+        for (uint32_t rva = c.rva; rva + sizeof(CompleteObjectLocator) <= c.rva + c.size; rva += sizeof(uint32_t)) {
+            if (auto locator = read_locator(image, rva)) {
+                chunk_locators[i].emplace_back(*locator);
+            }
+        }
+    });
+
+    std::unordered_map<uint32_t, Locator> locators{};
+
+    for (auto&& cl : chunk_locators) {
+        for (auto&& l : cl) {
+            locators.emplace(l.rva, l);
+        }
+    }
+
+    // A vtable is preceded by a pointer to its locator and starts with a pointer to code.
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> chunk_vtables(chunks.size());
+    auto pointer_size = (uint32_t)image.pointer_size();
+
+    parallel_for(chunks.size(), threads, cancel, [&](size_t i) {
+        auto&& c = chunks[i];
+
+        for (auto rva = c.rva; rva + 2 * pointer_size <= c.rva + c.size; rva += pointer_size) {
+            auto value = image.pointer(rva);
+
+            if (!value || *value < module.start || *value - module.start >= image.headers().size_of_image) {
+                continue;
+            }
+
+            auto locator_rva = (uint32_t)(*value - module.start);
+
+            if (!locators.contains(locator_rva)) {
+                continue;
+            }
+
+            if (auto first = image.pointer(rva + pointer_size); first && image.in_code(*first)) {
+                chunk_vtables[i].emplace_back(rva + pointer_size, locator_rva);
+            }
+        }
+    });
+
+    if (cancelled(cancel)) {
+        return std::nullopt;
+    }
+
+    ModuleCatalog catalog{};
+    // Type descriptor -> class index.
+    std::unordered_map<uint32_t, uint32_t> classes{};
+
+    catalog.module = std::string{module.name.substr(module.name.find_last_of("/\\") + 1)};
+    catalog.hash = *hash;
+    catalog.complete = image.complete();
+
+    for (auto&& cv : chunk_vtables) {
+        for (auto&& [vtable, locator_rva] : cv) {
+            auto&& locator = locators[locator_rva];
+            auto [it, inserted] = classes.emplace(locator.type_descriptor, (uint32_t)catalog.classes.size());
+
+            if (inserted) {
+                ModuleCatalog::Class c{};
+                ClassHierarchyDescriptor chd{};
+
+                c.decorated = *image.type_name(locator.type_descriptor);
+                c.name = undecorate(c.decorated);
+                c.bases = read_bases(image, locator.class_descriptor);
+
+                if (image.get(locator.class_descriptor, chd)) {
+                    c.attributes = chd.attributes;
+                }
+
+                catalog.classes.emplace_back(std::move(c));
+            }
+
+            catalog.classes[it->second].vtables.emplace_back(ModuleCatalog::Vtable{vtable, locator.offset});
+        }
+    }
+
+    catalog.build_index();
+    return catalog;
+}
+} // namespace rtti::msvc
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Catalog.hpp"
+#include "MsvcDecoder.hpp"
+#include "Process.hpp"
+
+// MSVC RTTI straight from a PE module's image: complete object locators, the vtables pointing at them and the class
+// hierarchy descriptors behind them. The structures are read directly, so the scan works on any Process holding a
+// Windows module.
+namespace rtti::msvc {
+// Identifies one build of a module: its PE header's TimeDateStamp, SizeOfImage and CheckSum plus its filename. nullopt
+// if there's no PE image at the module's start.
+std::optional<uint64_t> module_hash(Process& process, const Process::Module& module);
+
+// Catalogs every polymorphic class in the module. The module's data sections are read once through
+// Process::read_direct and scanned section by section on up to threads threads (0 uses one per core). nullopt if
+// there's no PE image at the module's start or cancel got set. Pages that can't be read are skipped and the catalog is
+// marked incomplete.
+std::optional<ModuleCatalog> scan_module(
+    Process& process, const Process::Module& module, size_t threads = 0, const std::atomic<bool>* cancel = nullptr);
+} // namespace rtti::msvc
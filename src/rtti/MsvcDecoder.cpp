@@ -0,0 +1,543 @@
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include "Process.hpp"
+#include "Read.hpp"
+
+#include "MsvcDecoder.hpp"
+
+namespace rtti::msvc {
+namespace {
+// Name and template argument back references only ever go up to 9.
+constexpr size_t MAX_BACKREFS = 10;
+
+// Just enough of the Microsoft name decoration grammar for type descriptor names. Every parse function returns nullopt
+// on anything it doesn't understand, which makes undecorate() keep the decorated name.
+class Undecorator {
+public:
+    explicit Undecorator(std::string_view decorated) : m_in{decorated} {}
+
+    std::optional<std::string> type_name() {
+        // ".?A" then the type itself.
+        if (!consume(".?A")) {
+            return std::nullopt;
+        }
+
+        auto name = type();
+
+        if (!name || !m_in.empty()) {
+            return std::nullopt;
+        }
+
+        return name;
+    }
+
+private:
+    // Template arguments have their own back references.
+    struct Backrefs {
+        std::vector<std::string> names{};
+        std::vector<std::string> types{};
+    };
+
+    std::string_view m_in{};
+    Backrefs m_refs{};
+
+    bool consume(std::string_view s) {
+        if (!m_in.starts_with(s)) {
+            return false;
+        }
+
+        m_in.remove_prefix(s.size());
+        return true;
+    }
+
+    static void memorize(std::vector<std::string>& refs, const std::string& s) {
+        if (refs.size() < MAX_BACKREFS && std::find(refs.begin(), refs.end(), s) == refs.end()) {
+            refs.emplace_back(s);
+        }
+    }
+
+    // "Foo@"
+    std::optional<std::string> identifier() {
+        auto end = m_in.find('@');
+
+        if (end == 0 || end == std::string_view::npos) {
+            return std::nullopt;
+        }
+
+        std::string id{m_in.substr(0, end)};
+
+        m_in.remove_prefix(end + 1);
+        return id;
+    }
+
+    // Fragments innermost first up to a terminating '@': "Foo@ns@@" -> "ns::Foo".
+    std::optional<std::string> qualified_name() {
+        std::vector<std::string> fragments{};
+
+        while (!consume("@")) {
+            auto fragment = unqualified_name();
+
+            if (!fragment) {
+                return std::nullopt;
+            }
+
+            fragments.emplace_back(std::move(*fragment));
+        }
+
+        if (fragments.empty()) {
+            return std::nullopt;
+        }
+
+        std::string name{};
+
+        for (auto it = fragments.rbegin(); it != fragments.rend(); ++it) {
+            if (!name.empty()) {
+                name += "::";
+            }
+
+            name += *it;
+        }
+
+        return name;
+    }
+
+    std::optional<std::string> unqualified_name() {
+        if (m_in.empty()) {
+            return std::nullopt;
+        }
+
+        if (auto c = m_in.front(); c >= '0' && c <= '9') {
+            m_in.remove_prefix(1);
+
+            if ((size_t)(c - '0') >= m_refs.names.size()) {
+                return std::nullopt;
+            }
+
+            return m_refs.names[c - '0'];
+        }
+
+        if (consume("?$")) {
+            return template_name();
+        }
+
+        std::optional<std::string> name{};
+
+        if (consume("?A")) {
+            // "?A0x1234abcd@", or just "?A@" from older compilers.
+            if (!identifier() && !consume("@")) {
+                return std::nullopt;
+            }
+
+            name = "`anonymous namespace'";
+        } else if (m_in.front() == '?') {
+            return std::nullopt;
+        } else {
+            name = identifier();
+        }
+
+        if (name) {
+            memorize(m_refs.names, *name);
+        }
+
+        return name;
+    }
+
+    // "Foo@H@" -> "Foo<int>", remembered as a whole in the enclosing back references.
+    std::optional<std::string> template_name() {
+        auto outer = std::exchange(m_refs, Backrefs{});
+        auto name = identifier();
+
+        if (name) {
+            memorize(m_refs.names, *name);
+        }
+
+        auto args = name ? template_arguments() : std::nullopt;
+
+        m_refs = std::move(outer);
+
+        if (!args) {
+            return std::nullopt;
+        }
+
+        // The space keeps ">>" from reading as a shift, like the runtime does.
+        auto result = *name + "<" + *args + (args->ends_with('>') ? " >" : ">");
+
+        memorize(m_refs.names, result);
+        return result;
+    }
+
+    std::optional<std::string> template_arguments() {
+        std::string args{};
+
+        while (!consume("@")) {
+            std::optional<std::string> arg{};
+
+            if (consume("$$V") || consume("$$Z") || consume("$S")) {
+                // Empty parameter pack.
+                continue;
+            } else if (consume("$0")) {
+                arg = number();
+            } else if (!m_in.empty() && m_in.front() >= '0' && m_in.front() <= '9') {
+                auto i = (size_t)(m_in.front() - '0');
+
+                m_in.remove_prefix(1);
+
+                if (i < m_refs.types.size()) {
+                    arg = m_refs.types[i];
+                }
+            } else {
+                auto before = m_in.size();
+
+                arg = type();
+
+                // Single letter types aren't worth a back reference.
+                if (arg && before - m_in.size() > 1) {
+                    memorize(m_refs.types, *arg);
+                }
+            }
+
+            if (!arg) {
+                return std::nullopt;
+            }
+
+            if (!args.empty()) {
+                args += ",";
+            }
+
+            args += *arg;
+        }
+
+        return args;
+    }
+
+    // "0" to "9" are 1 to 10, anything else is hex digits A-P terminated by '@'. '?' negates.
+    std::optional<std::string> number() {
+        auto negative = consume("?");
+
+        if (m_in.empty()) {
+            return std::nullopt;
+        }
+
+        uint64_t value{};
+
+        if (auto c = m_in.front(); c >= '0' && c <= '9') {
+            value = c - '0' + 1;
+            m_in.remove_prefix(1);
+        } else {
+            while (!consume("@")) {
+                if (m_in.empty() || m_in.front() < 'A' || m_in.front() > 'P') {
+                    return std::nullopt;
+                }
+
+                value = value * 16 + (m_in.front() - 'A');
+                m_in.remove_prefix(1);
+            }
+        }
+
+        return negative ? "-" + std::to_string(value) : std::to_string(value);
+    }
+
+    // A, B, C or D.
+    std::optional<std::string_view> cv() {
+        static constexpr std::string_view qualifiers[]{"", " const", " volatile", " const volatile"};
+
+        if (m_in.empty() || m_in.front() < 'A' || m_in.front() > 'D') {
+            return std::nullopt;
+        }
+
+        auto q = qualifiers[m_in.front() - 'A'];
+
+        m_in.remove_prefix(1);
+        return q;
+    }
+
+    // What follows a pointer or reference: "[E][I]<cv><type>" -> "<type><cv> <op>[ __ptr64]".
+    std::optional<std::string> indirection(std::string_view op, std::string_view self_cv) {
+        auto ptr64 = consume("E");
+        auto restricted = consume("I");
+        auto pointee_cv = cv();
+
+        // Function pointers and member pointers aren't class names.
+        if (!pointee_cv || m_in.starts_with('6') || m_in.starts_with('8')) {
+            return std::nullopt;
+        }
+
+        auto pointee = type();
+
+        if (!pointee) {
+            return std::nullopt;
+        }
+
+        auto out = *pointee + std::string{*pointee_cv} + " " + std::string{op};
+
+        if (ptr64) {
+            out += " __ptr64";
+        }
+
+        if (restricted) {
+            out += " __restrict";
+        }
+
+        return out + std::string{self_cv};
+    }
+
+    std::optional<std::string> type() {
+        static constexpr std::pair<char, std::string_view> primitives[]{
+            {'C', "signed char"}, {'D', "char"}, {'E', "unsigned char"}, {'F', "short"}, {'G', "unsigned short"},
+            {'H', "int"}, {'I', "unsigned int"}, {'J', "long"}, {'K', "unsigned long"}, {'M', "float"},
+            {'N', "double"}, {'O', "long double"}, {'X', "void"},
+        };
+        static constexpr std::pair<char, std::string_view> extended[]{
+            {'D', "__int8"}, {'E', "unsigned __int8"}, {'F', "__int16"}, {'G', "unsigned __int16"},
+            {'H', "__int32"}, {'I', "unsigned __int32"}, {'J', "__int64"}, {'K', "unsigned __int64"},
+            {'L', "__int128"}, {'M', "unsigned __int128"}, {'N', "bool"}, {'Q', "char8_t"}, {'S', "char16_t"},
+            {'U', "char32_t"}, {'W', "wchar_t"},
+        };
+
+        auto lookup = [this](auto&& table) -> std::optional<std::string> {
+            for (auto&& [code, name] : table) {
+                if (consume(std::string_view{&code, 1})) {
+                    return std::string{name};
+                }
+            }
+
+            return std::nullopt;
+        };
+
+        auto named = [this](std::string_view kind) -> std::optional<std::string> {
+            auto name = qualified_name();
+            return name ? std::optional{std::string{kind} + *name} : std::nullopt;
+        };
+
+        if (consume("$$Q")) {
+            return indirection("&&", "");
+        }
+
+        if (consume("$$C")) {
+            auto q = cv();
+            auto t = q ? type() : std::nullopt;
+            return t ? std::optional{*t + std::string{*q}} : std::nullopt;
+        }
+
+        if (consume("_")) {
+            return lookup(extended);
+        }
+
+        if (consume("V")) {
+            return named("class ");
+        } else if (consume("U")) {
+            return named("struct ");
+        } else if (consume("T")) {
+            return named("union ");
+        } else if (consume("W4")) {
+            return named("enum ");
+        } else if (consume("P")) {
+            return indirection("*", "");
+        } else if (consume("Q")) {
+            return indirection("*", " const");
+        } else if (consume("R")) {
+            return indirection("*", " volatile");
+        } else if (consume("S")) {
+            return indirection("*", " const volatile");
+        } else if (consume("A")) {
+            return indirection("&", "");
+        } else if (consume("B")) {
+            return indirection("&", " volatile");
+        }
+
+        return lookup(primitives);
+    }
+};
+} // namespace
+
+size_t Provider::pointer_size(Process& process, uintptr_t vtable) {
+    constexpr uint16_t IMAGE_DOS_SIGNATURE = 0x5a4d;
+    constexpr uint32_t IMAGE_NT_SIGNATURE = 0x4550;
+    constexpr uint16_t IMAGE_NT_OPTIONAL_HDR32_MAGIC = 0x10b;
+
+    auto module = process.get_module_within(vtable);
+
+    if (module == nullptr) {
+        return sizeof(uintptr_t);
+    }
+
+    {
+        std::shared_lock _{m_mtx};
+
+        if (auto search = m_pointer_sizes.find(module->start); search != m_pointer_sizes.end()) {
+            return search->second;
+        }
+    }
+
+    // The optional header follows the 4 byte signature and the 20 byte file header.
+    auto dos_signature = process.read<uint16_t>(module->start);
+    auto e_lfanew = process.read<uint32_t>(module->start + 0x3c);
+    auto nt_signature = e_lfanew ? process.read<uint32_t>(module->start + *e_lfanew) : std::nullopt;
+    auto magic = e_lfanew ? process.read<uint16_t>(module->start + *e_lfanew + 24) : std::nullopt;
+    auto size = sizeof(uintptr_t);
+
+    if (dos_signature == IMAGE_DOS_SIGNATURE && nt_signature == IMAGE_NT_SIGNATURE && magic) {
+        size = *magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC ? 4 : 8;
+    }
+
+    std::unique_lock _{m_mtx};
+    m_pointer_sizes[module->start] = size;
+    return size;
+}
+
+std::optional<Provider::Locator> Provider::read_locator(Process& process, uintptr_t vtable) {
+    // vtable[-1] is a slot of the image's own size: 4 bytes in a PE32 even when we're a 64-bit build.
+    auto slot_size = pointer_size(process, vtable);
+    uint64_t slot{};
+    std::optional<uintptr_t> address{};
+
+    if (vtable > slot_size && process.read(vtable - slot_size, &slot, slot_size)) {
+        address = (uintptr_t)slot;
+    }
+
+    Locator locator{};
+
+    if (!address || *address == 0 || !process.read(*address, &locator.col, sizeof(locator.col)) ||
+        locator.col.type_descriptor == 0 || locator.col.class_descriptor == 0) {
+        return std::nullopt;
+    }
+
+    if (locator.col.signature == COL_SIG_REV1) {
+        if (locator.col.self == 0 || locator.col.self > *address) {
+            return std::nullopt;
+        }
+
+        locator.image_base = *address - locator.col.self;
+        locator.pointer_size = 8;
+    } else if (locator.col.signature == COL_SIG_REV0) {
+        locator.pointer_size = 4;
+    } else {
+        return std::nullopt;
+    }
+
+    return locator;
+}
+
+std::optional<std::string> Provider::name_of(Process& process, uintptr_t type_descriptor, size_t pointer_size) {
+    {
+        std::shared_lock _{m_mtx};
+
+        if (auto search = m_names.find(type_descriptor); search != m_names.end()) {
+            return search->second;
+        }
+    }
+
+    auto decorated = read_name(process, type_descriptor + type_name_offset(pointer_size));
+    std::optional<std::string> name{};
+
+    if (decorated && decorated->starts_with(".?A") && decorated->find('@') != std::string::npos) {
+        name = undecorate(*decorated);
+    }
+
+    std::unique_lock _{m_mtx};
+
+    if (m_names.size() >= MAX_NAMES) {
+        m_names.clear();
+    }
+
+    m_names[type_descriptor] = name;
+    return name;
+}
+
+std::optional<std::string> Provider::type_name(Process& process, uintptr_t vtable) {
+    auto locator = read_locator(process, vtable);
+
+    if (!locator) {
+        return std::nullopt;
+    }
+
+    return name_of(process, locator->resolve(locator->col.type_descriptor), locator->pointer_size);
+}
+
+std::shared_ptr<const std::vector<std::string>> Provider::bases(Process& process, uintptr_t vtable) {
+    {
+        std::shared_lock _{m_mtx};
+
+        if (auto search = m_bases.find(vtable); search != m_bases.end()) {
+            return search->second;
+        }
+    }
+
+    auto names = std::make_shared<std::vector<std::string>>();
+    auto locator = read_locator(process, vtable);
+    ClassHierarchyDescriptor chd{};
+
+    if (locator && process.read(locator->resolve(locator->col.class_descriptor), &chd, sizeof(chd)) &&
+        chd.signature == 0 && chd.num_base_classes != 0 && chd.num_base_classes <= MAX_BASE_CLASSES &&
+        chd.base_class_array != 0) {
+        // Both layouts use 32 bit entries: absolute pointers on x86, image relative offsets on x64.
+        std::vector<uint32_t> array(chd.num_base_classes);
+
+        if (process.read(locator->resolve(chd.base_class_array), array.data(), array.size() * sizeof(uint32_t))) {
+            // Only each descriptor's type descriptor is needed, so that's all that gets read.
+            std::vector<uint32_t> type_descriptors(array.size());
+            std::vector<Process::ReadRequest> requests{};
+
+            for (size_t i = 0; i < array.size(); ++i) {
+                if (array[i] != 0) {
+                    requests.emplace_back(locator->resolve(array[i]), &type_descriptors[i], sizeof(uint32_t));
+                }
+            }
+
+            process.read_batch(requests);
+
+            // Keep hierarchy order, dropping the ones we couldn't read.
+            for (auto&& r : requests) {
+                auto type_descriptor = *(const uint32_t*)r.buffer;
+                auto name = r.ok && type_descriptor != 0
+                    ? name_of(process, locator->resolve(type_descriptor), locator->pointer_size)
+                    : std::nullopt;
+
+                if (name) {
+                    names->emplace_back(std::move(*name));
+                }
+            }
+        }
+    }
+
+    std::unique_lock _{m_mtx};
+
+    if (m_bases.size() >= MAX_BASES) {
+        m_bases.clear();
+    }
+
+    m_bases[vtable] = names;
+    return names;
+}
+
+std::optional<uint32_t> Provider::object_offset(Process& process, uintptr_t vtable) {
+    auto locator = read_locator(process, vtable);
+
+    if (!locator) {
+        return std::nullopt;
+    }
+
+    return locator->col.offset;
+}
+
+void Provider::invalidate(uintptr_t start, uintptr_t end) {
+    std::unique_lock _{m_mtx};
+
+    std::erase_if(m_names, [start, end](auto&& kv) { return kv.first >= start && kv.first < end; });
+    std::erase_if(m_bases, [start, end](auto&& kv) { return kv.first >= start && kv.first < end; });
+    std::erase_if(m_pointer_sizes, [start, end](auto&& kv) { return kv.first >= start && kv.first < end; });
+}
+
+void Provider::clear() {
+    std::unique_lock _{m_mtx};
+    m_names.clear();
+    m_bases.clear();
+    m_pointer_sizes.clear();
+}
+
+std::string undecorate(std::string_view decorated) {
+    return Undecorator{decorated}.type_name().value_or(std::string{decorated});
+}
+} // namespace rtti::msvc
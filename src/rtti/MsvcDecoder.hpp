@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Process;
+
+// MSVC RTTI: vtable[-1] points at the class's complete object locator, which leads to its type descriptor (a
+// std::type_info holding the decorated name) and class hierarchy descriptor. The layouts are defined here rather than
+// taken from the runtime's rttidata.h, so decoding doesn't depend on the host and reads only the fields it uses.
+namespace rtti::msvc {
+// x86 (COL_SIG_REV0) locators hold absolute addresses, x64 (COL_SIG_REV1) ones image relative offsets plus the
+// locator's own offset, which is what makes them easy to tell apart from random data.
+constexpr uint32_t COL_SIG_REV0 = 0;
+constexpr uint32_t COL_SIG_REV1 = 1;
+
+struct CompleteObjectLocator {
+    uint32_t signature;
+    // Where the subobject using this vtable starts in the complete object.
+    uint32_t offset;
+    uint32_t cd_offset;
+    uint32_t type_descriptor;
+    uint32_t class_descriptor;
+    // COL_SIG_REV1 only.
+    uint32_t self;
+};
+
+struct ClassHierarchyDescriptor {
+    uint32_t signature;
+    uint32_t attributes;
+    uint32_t num_base_classes;
+    // Array of num_base_classes BaseClassDescriptor pointers, the class itself first.
+    uint32_t base_class_array;
+};
+
+struct BaseClassDescriptor {
+    uint32_t type_descriptor;
+    uint32_t num_contained_bases;
+    int32_t mdisp;
+    int32_t pdisp;
+    int32_t vdisp;
+    uint32_t attributes;
+};
+
+static_assert(sizeof(CompleteObjectLocator) == 24);
+static_assert(sizeof(ClassHierarchyDescriptor) == 16);
+static_assert(sizeof(BaseClassDescriptor) == 24);
+
+// A type descriptor's decorated name follows its vftable and spare pointers.
+constexpr size_t type_name_offset(size_t pointer_size) {
+    return 2 * pointer_size;
+}
+
+// Anything past this is garbage that happened to pass the other checks.
+constexpr uint32_t MAX_BASE_CLASSES = 4096;
+
+class Provider {
+public:
+    // Undecorated name of the class vtable belongs to ("class ns::Foo"), the complete object's class for secondary
+    // vtables too. nullopt if vtable[-1] doesn't lead to a complete object locator.
+    std::optional<std::string> type_name(Process& process, uintptr_t vtable);
+    // Undecorated names of the class and every class it derives from, in base class array order (the class itself
+    // first). Empty if vtable isn't one. Kept per vtable until invalidate() covers it.
+    std::shared_ptr<const std::vector<std::string>> bases(Process& process, uintptr_t vtable);
+    // The locator's offset: subtracting it from an object using vtable gives the complete object.
+    std::optional<uint32_t> object_offset(Process& process, uintptr_t vtable);
+
+    // Drops everything read from [start, end) (a module that went away).
+    void invalidate(uintptr_t start, uintptr_t end);
+    void clear();
+
+private:
+    struct Locator {
+        CompleteObjectLocator col{};
+        // 0 for absolute (x86) locators.
+        uintptr_t image_base{};
+        size_t pointer_size{};
+
+        uintptr_t resolve(uint32_t pointer) const { return image_base + pointer; }
+    };
+
+    // Past these many entries the caches start over.
+    static constexpr size_t MAX_NAMES = 1 << 16;
+    static constexpr size_t MAX_BASES = 1 << 16;
+
+    mutable std::shared_mutex m_mtx{};
+    // Type descriptor -> undecorated name, shared by every vtable and base class array mentioning it.
+    std::unordered_map<uintptr_t, std::optional<std::string>> m_names{};
+    std::unordered_map<uintptr_t, std::shared_ptr<const std::vector<std::string>>> m_bases{};
+    // Module start -> the size of its vtable slots, from its PE optional header.
+    std::unordered_map<uintptr_t, size_t> m_pointer_sizes{};
+
+    // Pointer size of the image vtable lives in. The host's if it isn't in a PE module.
+    size_t pointer_size(Process& process, uintptr_t vtable);
+    std::optional<Locator> read_locator(Process& process, uintptr_t vtable);
+    std::optional<std::string> name_of(Process& process, uintptr_t type_descriptor, size_t pointer_size);
+};
+
+// ".?AV?$vector@HV?$allocator@H@std@@@std@@" -> "class std::vector<int,class std::allocator<int> >", the same
+// names std::type_info::name() gives. Covers what RTTI type descriptors hold: classes, structs, unions and enums with
+// nested, templated and anonymous namespace names. Anything else keeps its decorated name.
+std::string undecorate(std::string_view decorated);
+} // namespace rtti::msvc
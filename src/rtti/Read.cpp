@@ -0,0 +1,37 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Process.hpp"
+
+#include "Read.hpp"
+
+namespace rtti {
+namespace {
+constexpr size_t PAGE_SIZE = 0x1000;
+constexpr size_t MAX_NAME_LENGTH = 4096;
+} // namespace
+
+std::optional<std::string> read_name(Process& process, uintptr_t address) {
+    std::string out{};
+    char chunk[128]{};
+
+    while (out.size() < MAX_NAME_LENGTH) {
+        // Never read past the page the string might end in.
+        auto n = std::min(sizeof(chunk), PAGE_SIZE - (address & (PAGE_SIZE - 1)));
+
+        if (!process.read(address, chunk, n)) {
+            return std::nullopt;
+        }
+
+        if (auto end = (const char*)memchr(chunk, '\0', n)) {
+            out.append(chunk, end - chunk);
+            return out;
+        }
+
+        out.append(chunk, n);
+        address += n;
+    }
+
+    return std::nullopt;
+}
+} // namespace rtti
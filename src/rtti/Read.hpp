@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+class Process;
+
+namespace rtti {
+// The NUL terminated name at address, read a page at a time at most so a name at the end of a mapping is still found.
+// nullopt if it can't be read or is implausibly long.
+std::optional<std::string> read_name(Process& process, uintptr_t address);
+} // namespace rtti
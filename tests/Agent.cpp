@@ -0,0 +1,283 @@
+// Forks a child that loads the agent library, then reads and writes the child's memory through SharedMemoryProcess:
+// single reads, faults, batches larger than the ring, reads split into chunks that wrap the arena, zero-copy views, and
+// the fallback to the regular backend once the agent stops answering or stops for good.
+//
+// Usage: regenny-agent-test <path to the regenny-agent library>
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "arch/Arch.hpp"
+#include "backend/AgentProtocol.hpp"
+#include "backend/SharedMemoryProcess.hpp"
+
+#include "Check.hpp"
+
+namespace {
+// Bigger than the arena, so a whole read wraps it.
+constexpr size_t COUNT = 3 * agent::ARENA_SIZE / 2 / sizeof(uint64_t);
+
+constexpr uint64_t value_at(size_t i) {
+    return i * 0x9E3779B97F4A7C15ull;
+}
+
+// Commands sent to the child, each acknowledged by echoing it back.
+constexpr char STOP_AGENT = 's';
+constexpr char QUIT = 'q';
+
+struct Child {
+    pid_t pid{};
+    int commands{};
+    int replies{};
+
+    bool wait_ready() {
+        char c{};
+        return read(replies, &c, 1) == 1;
+    }
+
+    bool send(char c) { return write(commands, &c, 1) == 1 && wait_ready(); }
+
+    void quit() {
+        char c{QUIT};
+        (void)!write(commands, &c, 1);
+        waitpid(pid, nullptr, 0);
+    }
+};
+
+// Anything the parent reads back has to come from the child: the data is filled in after the fork, so the parent's copy
+// of the mapping stays zeroed.
+Child spawn(const char* agent_path, uint64_t* data) {
+    int commands[2]{};
+    int replies[2]{};
+
+    if (pipe(commands) != 0 || pipe(replies) != 0) {
+        return {};
+    }
+
+    auto pid = fork();
+
+    if (pid != 0) {
+        close(commands[0]);
+        close(replies[1]);
+        return {pid, commands[1], replies[0]};
+    }
+
+    close(commands[1]);
+    close(replies[0]);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        data[i] = value_at(i);
+    }
+
+    auto agent = dlopen(agent_path, RTLD_NOW);
+
+    if (agent == nullptr) {
+        fmt::print(stderr, "dlopen: {}\n", dlerror());
+        _exit(1);
+    }
+
+    auto stop = (void (*)())dlsym(agent, "regenny_agent_stop");
+    char c{'r'};
+
+    (void)!write(replies[1], &c, 1);
+
+    while (read(commands[0], &c, 1) == 1 && c != QUIT) {
+        if (c == STOP_AGENT) {
+            stop();
+        }
+
+        (void)!write(replies[1], &c, 1);
+    }
+
+    _exit(0);
+}
+
+std::unique_ptr<Process> open(pid_t pid) {
+    auto process = arch::open_process((uint32_t)pid);
+
+    // Every read should reach the backend under test.
+    process->epoch_cache().enabled(false);
+    process->unreadable_cache().ttl(std::chrono::milliseconds{0});
+
+    return process;
+}
+
+void test_reads(Process& process, uint64_t* data) {
+    uint64_t value{};
+
+    CHECK(process.read((uintptr_t)&data[12345], &value, sizeof(value)));
+    CHECK(value == value_at(12345));
+    CHECK(!process.read(0, &value, sizeof(value)));
+}
+
+// Only the agent faults on PROT_NONE pages, the regular backend reads them through /proc/<pid>/mem.
+void test_fault(Process& process, uintptr_t hole) {
+    uint64_t value{};
+
+    CHECK(!process.read(hole, &value, sizeof(value)));
+}
+
+void test_chunked_read(Process& process, uint64_t* data) {
+    // Unaligned and not a multiple of MAX_REQUEST_SIZE, so the last chunk is a partial one.
+    constexpr size_t first = 3;
+    constexpr size_t count = COUNT - 7;
+    std::vector<uint64_t> values(count);
+
+    CHECK(count * sizeof(uint64_t) > agent::ARENA_SIZE);
+    CHECK(process.read((uintptr_t)&data[first], values.data(), count * sizeof(uint64_t)));
+
+    size_t bad{};
+
+    for (size_t i = 0; i < count; ++i) {
+        bad += values[i] != value_at(first + i);
+    }
+
+    CHECK(bad == 0);
+}
+
+void test_batch(Process& process, SharedMemoryProcess& shm, uint64_t* data, uintptr_t hole) {
+    // More requests than slots, so the ring wraps several times, with faults mixed in.
+    constexpr size_t count = 5 * agent::SLOTS;
+    std::mt19937_64 rng{1};
+    std::vector<uint64_t> values(count);
+    std::vector<size_t> indices(count);
+    std::vector<Process::ReadRequest> requests(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        indices[i] = rng() % COUNT;
+        requests[i] = {i % 97 == 0 ? hole : (uintptr_t)&data[indices[i]], &values[i], sizeof(uint64_t)};
+    }
+
+    size_t faults{};
+    size_t bad{};
+    auto ok = process.read_batch(requests);
+
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 97 == 0) {
+            faults += requests[i].ok ? 0 : 1;
+        } else {
+            bad += !requests[i].ok || values[i] != value_at(indices[i]) ? 1 : 0;
+        }
+    }
+
+    CHECK(bad == 0);
+    CHECK(faults == (count + 96) / 97);
+    CHECK(ok == count - faults);
+
+    // Same requests again without copying out of the arena.
+    size_t views_bad{};
+    size_t views_faults{};
+
+    ok = shm.read_views(requests, [&](size_t i, const std::byte* view) {
+        if (view == nullptr) {
+            views_faults += i % 97 == 0 ? 1 : 0;
+            views_bad += i % 97 == 0 ? 0 : 1;
+            return;
+        }
+
+        uint64_t value{};
+        memcpy(&value, view, sizeof(value));
+        views_bad += value != value_at(indices[i]) ? 1 : 0;
+    });
+
+    CHECK(views_bad == 0);
+    CHECK(views_faults == faults);
+    CHECK(ok == count - faults);
+}
+
+void test_write(Process& process, uint64_t* data) {
+    uint64_t value{0xABCDEF};
+    uint64_t back{};
+
+    CHECK(process.write((uintptr_t)&data[7], &value, sizeof(value)));
+    CHECK(process.read((uintptr_t)&data[7], &back, sizeof(back)));
+    CHECK(back == value);
+
+    value = value_at(7);
+    CHECK(process.write((uintptr_t)&data[7], &value, sizeof(value)));
+}
+
+// After the agent goes away everything still works, through the regular backend.
+void test_fallback(Process& process, SharedMemoryProcess& shm, uint64_t* data) {
+    test_reads(process, data);
+    test_chunked_read(process, data);
+    CHECK(!shm.agent_ok());
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fmt::print(stderr, "usage: {} <agent library>\n", argv[0]);
+        return 2;
+    }
+
+    auto data = (uint64_t*)mmap(
+        nullptr, COUNT * sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    auto hole = (uintptr_t)mmap(nullptr, 0x1000, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    auto child = spawn(argv[1], data);
+
+    if (child.pid <= 0 || !child.wait_ready()) {
+        fmt::print(stderr, "couldn't start the child\n");
+        return 1;
+    }
+
+    {
+        auto process = open(child.pid);
+        auto shm = dynamic_cast<SharedMemoryProcess*>(process.get());
+
+        CHECK(shm != nullptr);
+
+        if (shm != nullptr) {
+            CHECK(shm->agent_ok());
+            // Only one client per ring, even from the same process.
+            CHECK(SharedMemoryProcess::open_agent(child.pid) == nullptr);
+            test_reads(*process, data);
+            test_fault(*process, hole);
+            test_chunked_read(*process, data);
+            test_batch(*process, *shm, data, hole);
+            test_write(*process, data);
+            CHECK(shm->agent_ok());
+
+            // A stopped target stops answering: after the timeout the regular backend takes over.
+            kill(child.pid, SIGSTOP);
+            test_fallback(*process, *shm, data);
+            kill(child.pid, SIGCONT);
+        }
+    }
+
+    {
+        // The agent finishes whatever the previous client left behind and serves the next one.
+        auto process = open(child.pid);
+        auto shm = dynamic_cast<SharedMemoryProcess*>(process.get());
+
+        CHECK(shm != nullptr);
+
+        if (shm != nullptr) {
+            CHECK(shm->agent_ok());
+            test_reads(*process, data);
+            test_fault(*process, hole);
+
+            // An agent that shuts down is noticed right away.
+            CHECK(child.send(STOP_AGENT));
+            test_fallback(*process, *shm, data);
+        }
+    }
+
+    child.quit();
+
+    if (test::g_failures != 0) {
+        fmt::print(stderr, "{} checks failed\n", test::g_failures);
+        return 1;
+    }
+
+    fmt::print("ok\n");
+    return 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <fmt/format.h>
+
+// Minimal assertions for the test programs: a failed check is reported and counted, and main returns the count.
+namespace test {
+inline int g_failures{};
+} // namespace test
+
+#define CHECK(expr)                                                                                                    \
+    do {                                                                                                               \
+        if (!(expr)) {                                                                                                 \
+            fmt::print(stderr, "{}:{}: CHECK({}) failed\n", __FILE__, __LINE__, #expr);                                \
+            ++test::g_failures;                                                                                        \
+        }                                                                                                              \
+    } while (false)
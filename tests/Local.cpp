@@ -0,0 +1,134 @@
+// Opens this very process, which arch::open_process hands back as a LocalProcess, and reads objects it knows the
+// contents of: plain reads, RTTI names and bases walked through the local reads, and pointers into memory that was
+// never readable or went away after the memory map was taken, which have to fail the read instead of crashing.
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "arch/Arch.hpp"
+#include "backend/LocalProcess.hpp"
+
+#include "Check.hpp"
+
+namespace game {
+struct Base {
+    virtual ~Base() = default;
+    uint32_t health{100};
+};
+
+struct Named {
+    virtual ~Named() = default;
+};
+
+struct Derived : Base {
+    uint32_t armor{50};
+};
+
+// Two bases, so its type_info is a __vmi_class_type_info.
+struct Player : Derived, Named {
+    uint64_t id{0x1122334455667788};
+};
+} // namespace game
+
+namespace {
+void test_reads(Process& process) {
+    std::vector<uint64_t> data(4096);
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = i * 0x9E3779B97F4A7C15ull;
+    }
+
+    std::vector<uint64_t> values(data.size());
+
+    CHECK(process.read((uintptr_t)data.data(), values.data(), values.size() * sizeof(uint64_t)));
+    CHECK(values == data);
+
+    auto value = process.read<uint64_t>((uintptr_t)&data[1234]);
+
+    CHECK(value && *value == data[1234]);
+
+    uint64_t target{};
+
+    CHECK(process.write((uintptr_t)&target, &data[42], sizeof(target)));
+    CHECK(target == data[42]);
+}
+
+void test_rtti(Process& process) {
+    auto base = std::make_unique<game::Base>();
+    auto derived = std::make_unique<game::Derived>();
+    auto player = std::make_unique<game::Player>();
+    uint64_t not_an_object{};
+
+    CHECK(process.get_typename((uintptr_t)base.get()) == "game::Base");
+    CHECK(process.get_typename((uintptr_t)derived.get()) == "game::Derived");
+    CHECK(process.get_typename((uintptr_t)player.get()) == "game::Player");
+    // The secondary vtable still names the complete object.
+    CHECK(process.get_typename((uintptr_t)static_cast<game::Named*>(player.get())) == "game::Player");
+    CHECK(!process.get_typename((uintptr_t)&not_an_object));
+
+    CHECK((process.get_base_typenames((uintptr_t)derived.get()) ==
+           std::vector<std::string>{"game::Derived", "game::Base"}));
+    CHECK((process.get_base_typenames((uintptr_t)player.get()) ==
+           std::vector<std::string>{"game::Player", "game::Derived", "game::Named", "game::Base"}));
+    CHECK(process.get_base_typenames((uintptr_t)&not_an_object).empty());
+
+    auto health = process.read<uint32_t>((uintptr_t)&player->health);
+
+    CHECK(health && *health == 100);
+}
+
+// never_readable was PROT_NONE when the map was taken, gone was readable then and has been unmapped since, so only the
+// fault guard stands between a read of it and a crash.
+void test_bad_pointers(Process& process, uintptr_t never_readable, uintptr_t gone) {
+    uint64_t value{};
+
+    CHECK(!process.read(never_readable, &value, sizeof(value)));
+    CHECK(!process.read(gone, &value, sizeof(value)));
+    CHECK(!process.read(0, &value, sizeof(value)));
+    CHECK(!process.read(UINTPTR_MAX - 3, &value, sizeof(value)));
+
+    // An object whose vtable pointer leads into memory that isn't there.
+    uintptr_t fake_object[2]{gone + 16, 0};
+
+    CHECK(!process.get_typename((uintptr_t)fake_object));
+    CHECK(process.get_base_typenames((uintptr_t)fake_object).empty());
+    CHECK(!process.get_typename(gone));
+}
+} // namespace
+
+int main() {
+    auto page_size = (size_t)sysconf(_SC_PAGESIZE);
+    auto never_readable = mmap(nullptr, page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    auto gone = mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    CHECK(never_readable != MAP_FAILED);
+    CHECK(gone != MAP_FAILED);
+
+    auto process = arch::open_process((uint32_t)getpid());
+
+    CHECK(process != nullptr && process->ok());
+    CHECK(dynamic_cast<LocalProcess*>(process.get()) != nullptr);
+
+    if (process != nullptr && process->ok()) {
+        munmap(gone, page_size);
+
+        test_reads(*process);
+        test_rtti(*process);
+        test_bad_pointers(*process, (uintptr_t)never_readable, (uintptr_t)gone);
+    }
+
+    munmap(never_readable, page_size);
+
+    if (test::g_failures != 0) {
+        fmt::print(stderr, "{} checks failed\n", test::g_failures);
+        return 1;
+    }
+
+    fmt::print("ok\n");
+    return 0;
+}
@@ -0,0 +1,333 @@
+// Decodes MSVC RTTI out of two synthetic PE images, a PE32 (x86 locators: absolute addresses) and a PE32+ (x64
+// locators: image relative offsets), opened with PeImageProcess. Both hold the same hierarchy:
+//
+//   struct Other
+//   class game::Base
+//   class game::Derived : game::Base, Other (Other at offset 0x10, with its own vtable)
+//
+// plus vtables whose vtable[-1] doesn't lead to a valid locator. Then runs undecorate() over a table of decorated
+// names.
+//
+// Everything is laid out for the image's own bitness, vtable slots included: 4 bytes in the PE32 whatever the host.
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "backend/PeImageProcess.hpp"
+#include "rtti/MsvcDecoder.hpp"
+
+#include "Check.hpp"
+
+namespace {
+using namespace rtti::msvc;
+
+constexpr uint32_t IMAGE_SIZE = 0x5000;
+constexpr uint32_t HEADERS_SIZE = 0x400;
+
+// Sections, raw data at the same offsets as their RVAs so the file is laid out like the loaded image.
+constexpr uint32_t TEXT = 0x1000;
+constexpr uint32_t RDATA = 0x2000;
+constexpr uint32_t DATA = 0x4000;
+
+// Where everything lives, the same RVAs in both images.
+constexpr uint32_t TD_BASE = DATA + 0x000;
+constexpr uint32_t TD_DERIVED = DATA + 0x100;
+constexpr uint32_t TD_OTHER = DATA + 0x200;
+
+constexpr uint32_t BCD_BASE = RDATA + 0x000;
+constexpr uint32_t BCD_DERIVED = RDATA + 0x020;
+constexpr uint32_t BCD_OTHER = RDATA + 0x040;
+
+constexpr uint32_t BCA_BASE = RDATA + 0x100;
+constexpr uint32_t BCA_DERIVED = RDATA + 0x110;
+constexpr uint32_t BCA_OTHER = RDATA + 0x120;
+
+constexpr uint32_t CHD_BASE = RDATA + 0x200;
+constexpr uint32_t CHD_DERIVED = RDATA + 0x220;
+constexpr uint32_t CHD_OTHER = RDATA + 0x240;
+
+constexpr uint32_t COL_BASE = RDATA + 0x300;
+constexpr uint32_t COL_DERIVED = RDATA + 0x320;
+constexpr uint32_t COL_DERIVED_OTHER = RDATA + 0x340;
+constexpr uint32_t COL_OTHER = RDATA + 0x360;
+constexpr uint32_t COL_BAD_SIGNATURE = RDATA + 0x380;
+constexpr uint32_t COL_BAD_SELF = RDATA + 0x3a0;
+constexpr uint32_t ZEROS = RDATA + 0x3c0;
+
+// Each vtable starts one slot after these.
+constexpr uint32_t VT_BASE = RDATA + 0x1000;
+constexpr uint32_t VT_DERIVED = RDATA + 0x1100;
+constexpr uint32_t VT_DERIVED_OTHER = RDATA + 0x1200;
+constexpr uint32_t VT_OTHER = RDATA + 0x1300;
+constexpr uint32_t VT_BAD_SIGNATURE = RDATA + 0x1400;
+constexpr uint32_t VT_BAD_SELF = RDATA + 0x1500;
+constexpr uint32_t VT_ZEROS = RDATA + 0x1600;
+constexpr uint32_t VT_NULL = RDATA + 0x1700;
+
+constexpr uint32_t DERIVED_OTHER_OFFSET = 0x10;
+
+struct Layout {
+    const char* name{};
+    bool x64{};
+    uint64_t image_base{};
+};
+
+constexpr Layout X86{"x86", false, 0x400000};
+constexpr Layout X64{"x64", true, 0x140000000};
+
+class Image {
+public:
+    explicit Image(const Layout& layout) : m_layout{layout}, m_bytes(IMAGE_SIZE) {}
+
+    template <typename T> void put(uint32_t rva, T value) { memcpy(&m_bytes[rva], &value, sizeof(T)); }
+    void put_string(uint32_t rva, std::string_view s) { memcpy(&m_bytes[rva], s.data(), s.size()); }
+
+    // How locators refer to rva: absolute on x86, image relative on x64.
+    uint32_t ref(uint32_t rva) const { return m_layout.x64 ? rva : (uint32_t)(m_layout.image_base + rva); }
+    uintptr_t address(uint32_t rva) const { return (uintptr_t)(m_layout.image_base + rva); }
+    size_t pointer_size() const { return m_layout.x64 ? 8 : 4; }
+
+    bool write(const std::filesystem::path& path) const {
+        std::ofstream f{path, std::ios::binary};
+        f.write((const char*)m_bytes.data(), m_bytes.size());
+        return f.good();
+    }
+
+private:
+    Layout m_layout{};
+    std::vector<std::byte> m_bytes{};
+};
+
+void write_headers(Image& image, const Layout& layout) {
+    constexpr uint32_t nt = 0x80;
+    constexpr uint32_t file_header = nt + 4;
+    constexpr uint32_t optional_header = file_header + 20;
+
+    struct Section {
+        const char* name;
+        uint32_t rva;
+        uint32_t size;
+        uint32_t characteristics;
+    };
+
+    constexpr Section sections[]{
+        {".text", TEXT, RDATA - TEXT, 0x60000020},
+        {".rdata", RDATA, DATA - RDATA, 0x40000040},
+        {".data", DATA, IMAGE_SIZE - DATA, 0xc0000040},
+    };
+
+    uint16_t optional_header_size = layout.x64 ? 0xf0 : 0xe0;
+
+    image.put<uint16_t>(0, 0x5a4d);
+    image.put<uint32_t>(0x3c, nt);
+    image.put<uint32_t>(nt, 0x4550);
+
+    image.put<uint16_t>(file_header, layout.x64 ? 0x8664 : 0x14c);
+    image.put<uint16_t>(file_header + 2, (uint16_t)std::size(sections));
+    image.put<uint16_t>(file_header + 16, optional_header_size);
+
+    image.put<uint16_t>(optional_header, layout.x64 ? 0x20b : 0x10b);
+
+    if (layout.x64) {
+        image.put<uint64_t>(optional_header + 24, layout.image_base);
+    } else {
+        image.put<uint32_t>(optional_header + 28, (uint32_t)layout.image_base);
+    }
+
+    image.put<uint32_t>(optional_header + 32, 0x1000);
+    image.put<uint32_t>(optional_header + 36, 0x200);
+    image.put<uint32_t>(optional_header + 56, IMAGE_SIZE);
+    image.put<uint32_t>(optional_header + 60, HEADERS_SIZE);
+
+    auto section_headers = optional_header + optional_header_size;
+
+    for (size_t i = 0; i < std::size(sections); ++i) {
+        auto&& s = sections[i];
+        auto header = section_headers + (uint32_t)i * 40;
+
+        image.put_string(header, s.name);
+        image.put<uint32_t>(header + 8, s.size);
+        image.put<uint32_t>(header + 12, s.rva);
+        image.put<uint32_t>(header + 16, s.size);
+        image.put<uint32_t>(header + 20, s.rva);
+        image.put<uint32_t>(header + 36, s.characteristics);
+    }
+}
+
+void write_rtti(Image& image, const Layout& layout) {
+    auto name_offset = (uint32_t)type_name_offset(image.pointer_size());
+
+    image.put_string(TD_BASE + name_offset, ".?AVBase@game@@");
+    image.put_string(TD_DERIVED + name_offset, ".?AVDerived@game@@");
+    image.put_string(TD_OTHER + name_offset, ".?AUOther@@");
+
+    auto bcd = [&](uint32_t rva, uint32_t type_descriptor, uint32_t contained, int32_t mdisp) {
+        image.put(rva, BaseClassDescriptor{image.ref(type_descriptor), contained, mdisp, -1, 0, 0});
+    };
+
+    bcd(BCD_BASE, TD_BASE, 0, 0);
+    bcd(BCD_DERIVED, TD_DERIVED, 2, 0);
+    bcd(BCD_OTHER, TD_OTHER, 0, (int32_t)DERIVED_OTHER_OFFSET);
+
+    // The class itself first.
+    image.put<uint32_t>(BCA_BASE, image.ref(BCD_BASE));
+    image.put<uint32_t>(BCA_DERIVED, image.ref(BCD_DERIVED));
+    image.put<uint32_t>(BCA_DERIVED + 4, image.ref(BCD_BASE));
+    image.put<uint32_t>(BCA_DERIVED + 8, image.ref(BCD_OTHER));
+    image.put<uint32_t>(BCA_OTHER, image.ref(BCD_OTHER));
+
+    auto chd = [&](uint32_t rva, uint32_t attributes, uint32_t count, uint32_t array) {
+        image.put(rva, ClassHierarchyDescriptor{0, attributes, count, image.ref(array)});
+    };
+
+    chd(CHD_BASE, 0, 1, BCA_BASE);
+    chd(CHD_DERIVED, 1, 3, BCA_DERIVED);
+    chd(CHD_OTHER, 0, 1, BCA_OTHER);
+
+    auto col = [&](uint32_t rva, uint32_t signature, uint32_t offset, uint32_t type_descriptor, uint32_t chd,
+                   uint32_t self) {
+        image.put(rva, CompleteObjectLocator{
+                           signature, offset, 0, image.ref(type_descriptor), image.ref(chd), layout.x64 ? self : 0});
+    };
+
+    auto signature = layout.x64 ? COL_SIG_REV1 : COL_SIG_REV0;
+
+    col(COL_BASE, signature, 0, TD_BASE, CHD_BASE, COL_BASE);
+    col(COL_DERIVED, signature, 0, TD_DERIVED, CHD_DERIVED, COL_DERIVED);
+    col(COL_DERIVED_OTHER, signature, DERIVED_OTHER_OFFSET, TD_DERIVED, CHD_DERIVED, COL_DERIVED_OTHER);
+    col(COL_OTHER, signature, 0, TD_OTHER, CHD_OTHER, COL_OTHER);
+    col(COL_BAD_SIGNATURE, 7, 0, TD_BASE, CHD_BASE, COL_BAD_SIGNATURE);
+    // An x64 locator that doesn't know where it is, so there's no image base to resolve against.
+    col(COL_BAD_SELF, COL_SIG_REV1, 0, TD_BASE, CHD_BASE, 0);
+
+    auto vtable = [&](uint32_t rva, uintptr_t locator) {
+        if (layout.x64) {
+            image.put<uint64_t>(rva, locator);
+            image.put<uint64_t>(rva + 8, image.address(TEXT));
+        } else {
+            image.put<uint32_t>(rva, (uint32_t)locator);
+            image.put<uint32_t>(rva + 4, (uint32_t)image.address(TEXT));
+        }
+    };
+
+    vtable(VT_BASE, image.address(COL_BASE));
+    vtable(VT_DERIVED, image.address(COL_DERIVED));
+    vtable(VT_DERIVED_OTHER, image.address(COL_DERIVED_OTHER));
+    vtable(VT_OTHER, image.address(COL_OTHER));
+    vtable(VT_BAD_SIGNATURE, image.address(COL_BAD_SIGNATURE));
+    vtable(VT_BAD_SELF, image.address(COL_BAD_SELF));
+    vtable(VT_ZEROS, image.address(ZEROS));
+    vtable(VT_NULL, 0);
+}
+
+void test_layout(const Layout& layout, const std::filesystem::path& dir) {
+    Image image{layout};
+
+    write_headers(image, layout);
+    write_rtti(image, layout);
+
+    auto path = dir / fmt::format("msvc-rtti-{}.exe", layout.name);
+
+    CHECK(image.write(path));
+
+    PeImageProcess process{path};
+    Provider provider{};
+
+    CHECK(process.ok());
+    CHECK(process.image_base() == layout.image_base);
+
+    auto vtable = [&](uint32_t rva) { return image.address(rva) + image.pointer_size(); };
+    using Names = std::vector<std::string>;
+
+    CHECK(provider.type_name(process, vtable(VT_BASE)) == "class game::Base");
+    CHECK(provider.type_name(process, vtable(VT_DERIVED)) == "class game::Derived");
+    CHECK(provider.type_name(process, vtable(VT_OTHER)) == "struct Other");
+    // Secondary vtables name the complete object's class.
+    CHECK(provider.type_name(process, vtable(VT_DERIVED_OTHER)) == "class game::Derived");
+
+    CHECK(*provider.bases(process, vtable(VT_BASE)) == Names{"class game::Base"});
+    CHECK(*provider.bases(process, vtable(VT_OTHER)) == Names{"struct Other"});
+    CHECK((*provider.bases(process, vtable(VT_DERIVED)) ==
+           Names{"class game::Derived", "class game::Base", "struct Other"}));
+    CHECK(*provider.bases(process, vtable(VT_DERIVED_OTHER)) == *provider.bases(process, vtable(VT_DERIVED)));
+
+    CHECK(provider.object_offset(process, vtable(VT_DERIVED)) == 0u);
+    CHECK(provider.object_offset(process, vtable(VT_DERIVED_OTHER)) == DERIVED_OTHER_OFFSET);
+
+    for (auto rva : {VT_BAD_SIGNATURE, VT_BAD_SELF, VT_ZEROS, VT_NULL}) {
+        CHECK(!provider.type_name(process, vtable(rva)));
+        CHECK(provider.bases(process, vtable(rva))->empty());
+        CHECK(!provider.object_offset(process, vtable(rva)));
+    }
+
+    // Outside the image, and too close to 0 to have a vtable[-1].
+    CHECK(!provider.type_name(process, image.address(IMAGE_SIZE + 0x1000)));
+    CHECK(!provider.type_name(process, 4));
+
+    // Dropping what was cached for the image just means reading it again.
+    provider.invalidate(image.address(0), image.address(IMAGE_SIZE));
+    CHECK(provider.type_name(process, vtable(VT_OTHER)) == "struct Other");
+}
+
+void test_undecorate() {
+    struct {
+        const char* decorated;
+        const char* undecorated;
+    } names[]{
+        {".?AUBar@@", "struct Bar"},
+        {".?AW4Color@@", "enum Color"},
+        {".?AVFoo@a@b@@", "class b::a::Foo"},
+        {".?AVImpl@?A0x1b2c3d4e@game@@", "class game::`anonymous namespace'::Impl"},
+        {".?AV?$vec@H@std@@", "class std::vec<int>"},
+        {".?AV?$vector@HV?$allocator@H@std@@@std@@", "class std::vector<int,class std::allocator<int> >"},
+        {".?AV?$basic_string@DU?$char_traits@D@std@@V?$allocator@D@2@@std@@",
+            "class std::basic_string<char,struct std::char_traits<char>,class std::allocator<char> >"},
+        {".?AV?$Outer@V?$Inner@H@@@ns@@", "class ns::Outer<class Inner<int> >"},
+        {".?AV?$map@VKey@@VKey@@@@", "class map<class Key,class Key>"},
+        {".?AV?$Array@PEAVActor@@$0BA@@@", "class Array<class Actor * __ptr64,16>"},
+        {".?AV?$Pair@PEBUNode@@PEBU1@@@", "class Pair<struct Node const * __ptr64,struct Node const * __ptr64>"},
+        {".?AV?$Holder@$0?0@@", "class Holder<-1>"},
+        {".?AV?$Tuple@$$V@@", "class Tuple<>"},
+        {".?AV?$Opt@_N@@", "class Opt<bool>"},
+        // Not covered, kept as is.
+        {".?AV?$Fn@P6AXXZ@@", ".?AV?$Fn@P6AXXZ@@"},
+        {".?AUcolor@?1??main@@YAHXZ@", ".?AUcolor@?1??main@@YAHXZ@"},
+        {".H", ".H"},
+        {"", ""},
+    };
+
+    for (auto&& [decorated, undecorated] : names) {
+        auto result = undecorate(decorated);
+
+        if (result != undecorated) {
+            fmt::print(stderr, "undecorate(\"{}\") = \"{}\", expected \"{}\"\n", decorated, result, undecorated);
+        }
+
+        CHECK(result == undecorated);
+    }
+}
+} // namespace
+
+int main() {
+    auto dir = std::filesystem::temp_directory_path() / "regenny-msvc-rtti-test";
+
+    std::filesystem::create_directories(dir);
+
+    test_layout(X86, dir);
+    test_layout(X64, dir);
+    test_undecorate();
+
+    std::filesystem::remove_all(dir);
+
+    if (test::g_failures != 0) {
+        fmt::print(stderr, "{} checks failed\n", test::g_failures);
+        return 1;
+    }
+
+    fmt::print("ok\n");
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Runs a RemoteServer on loopback and looks at this very process through RemoteProcess: single reads, a batch with a
+// hole in it, writes, and the server turning away a wrong token, requests before HELLO and oversized requests.
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "backend/RemoteProcess.hpp"
+#include "backend/RemoteProtocol.hpp"
+#include "backend/RemoteServer.hpp"
+
+#include "Check.hpp"
+
+namespace {
+using namespace remote;
+
+constexpr auto HOST = "127.0.0.1";
+constexpr auto TOKEN = "correct horse";
+constexpr size_t COUNT = 64 * 1024;
+
+constexpr uint64_t value_at(size_t i) {
+    return i * 0x9E3779B97F4A7C15ull;
+}
+
+std::unique_ptr<Socket> connect(uint16_t port) {
+    return Socket::connect(HOST, port, std::chrono::milliseconds{3000});
+}
+
+// Sends one frame and waits for the answer. False if the server closed the connection instead.
+bool exchange(Socket& socket, Type type, Writer& w, FrameHeader& header, std::vector<std::byte>& payload) {
+    FrameHeader request{(uint32_t)w.data().size(), 1, type, 0};
+    return send_frame(socket, request, w.data()) && recv_frame(socket, header, payload);
+}
+
+bool hello(Socket& socket, const char* token) {
+    Writer w{};
+    FrameHeader header{};
+    std::vector<std::byte> payload{};
+
+    w.put(MAGIC).put(VERSION).put(0u).put_string(token);
+    return exchange(socket, Type::HELLO, w, header, payload) && header.type == Type::HELLO;
+}
+
+void test_process(uint16_t port, const std::vector<uint64_t>& data, uintptr_t hole, uintptr_t gone) {
+    RemoteProcess process{HOST, port, TOKEN, (uint32_t)getpid()};
+
+    CHECK(process.ok());
+    CHECK(process.process_id() == (uint32_t)getpid());
+
+    // Every read should make it to the server.
+    process.epoch_cache().enabled(false);
+    process.unreadable_cache().ttl(std::chrono::milliseconds{0});
+
+    uint64_t value{};
+
+    CHECK(process.read((uintptr_t)&data[1234], &value, sizeof(value)));
+    CHECK(value == value_at(1234));
+    CHECK(!process.read(hole, &value, sizeof(value)));
+
+    // Big enough to be split into several pipelined READ frames, with an unreadable request in the middle.
+    std::vector<uint64_t> values(COUNT);
+    std::vector<Process::ReadRequest> requests{};
+
+    for (size_t i = 0; i < COUNT; i += 1024) {
+        requests.emplace_back((uintptr_t)&data[i], &values[i], 1024 * sizeof(uint64_t));
+
+        if (i == COUNT / 2) {
+            requests.emplace_back(hole, &value, sizeof(value));
+        }
+    }
+
+    CHECK(process.read_batch(requests) == requests.size() - 1);
+
+    size_t bad{};
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        bad += values[i] != value_at(i);
+    }
+
+    CHECK(bad == 0);
+
+    uint64_t target{};
+    uint64_t written{0x1122334455667788};
+
+    CHECK(process.write((uintptr_t)&target, &written, sizeof(written)));
+    CHECK(target == written);
+    // Writes may force their way past PROT_NONE (like WriteProcessMemory), but not into memory that isn't mapped.
+    CHECK(!process.write(gone, &written, sizeof(written)));
+    CHECK(process.stats().frames > 2);
+}
+
+void test_refusals(uint16_t port) {
+    // A wrong token gets nothing.
+    RemoteProcess wrong{HOST, port, "wrong", (uint32_t)getpid()};
+
+    CHECK(!wrong.ok());
+    RemoteHelpers wrong_helpers{HOST, port, "wrong"};
+    RemoteHelpers helpers{HOST, port, TOKEN};
+
+    CHECK(wrong_helpers.processes().empty());
+    CHECK(!helpers.processes().empty());
+
+    // Nothing is answered before HELLO, and the connection is dropped.
+    if (auto socket = connect(port); socket != nullptr) {
+        Writer w{};
+        FrameHeader header{};
+        std::vector<std::byte> payload{};
+
+        CHECK(exchange(*socket, Type::PROCESSES, w, header, payload));
+        CHECK(header.type == Type::ERROR);
+        CHECK(!recv_frame(*socket, header, payload));
+    } else {
+        CHECK(false);
+    }
+
+    // A read asking for more than a frame can carry is refused, the connection stays usable.
+    if (auto socket = connect(port); socket != nullptr && hello(*socket, TOKEN)) {
+        Writer open{};
+        FrameHeader header{};
+        std::vector<std::byte> payload{};
+
+        open.put((uint32_t)getpid());
+        CHECK(exchange(*socket, Type::OPEN, open, header, payload));
+        CHECK(header.type == Type::OPEN && Reader{payload}.get<uint32_t>() == (uint32_t)getpid());
+
+        Writer read{};
+
+        read.put(2u).put((uint64_t)0x10000).put(MAX_PAYLOAD).put((uint64_t)0x10000).put(MAX_PAYLOAD);
+        CHECK(exchange(*socket, Type::READ, read, header, payload));
+        CHECK(header.type == Type::ERROR);
+
+        Writer status{};
+
+        CHECK(exchange(*socket, Type::STATUS, status, header, payload));
+        CHECK(header.type == Type::STATUS);
+    } else {
+        CHECK(false);
+    }
+
+    // A frame bigger than MAX_PAYLOAD is a corrupt stream, the server hangs up.
+    if (auto socket = connect(port); socket != nullptr && hello(*socket, TOKEN)) {
+        FrameHeader request{MAX_PAYLOAD + 1, 2, Type::READ, 0};
+        FrameHeader header{};
+        std::vector<std::byte> payload{};
+
+        CHECK(socket->send_all(&request, sizeof(request)));
+        CHECK(!recv_frame(*socket, header, payload));
+    } else {
+        CHECK(false);
+    }
+}
+} // namespace
+
+int main() {
+    std::vector<uint64_t> data(COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        data[i] = value_at(i);
+    }
+
+    // A page nothing can read.
+    auto page_size = (size_t)sysconf(_SC_PAGESIZE);
+    auto hole = mmap(nullptr, page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    // And one that isn't mapped at all anymore.
+    auto gone = mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    CHECK(hole != MAP_FAILED);
+    CHECK(gone != MAP_FAILED);
+    munmap(gone, page_size);
+
+    RemoteServer server{HOST, 0, TOKEN};
+
+    CHECK(server.ok());
+
+    if (server.ok()) {
+        std::thread thread{[&server] { server.run(); }};
+
+        test_process(server.port(), data, (uintptr_t)hole, (uintptr_t)gone);
+        test_refusals(server.port());
+
+        server.stop();
+        thread.join();
+    }
+
+    munmap(hole, page_size);
+
+    if (test::g_failures != 0) {
+        fmt::print(stderr, "{} checks failed\n", test::g_failures);
+        return 1;
+    }
+
+    fmt::print("ok\n");
+    return 0;
+}